@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2016, Freescale Semiconductor, Inc.
- * Copyright 2016-2021 NXP
+ * Copyright 2016-2021, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -13,6 +13,7 @@
 #include "fsl_shell.h"
 #include "lfs.h"
 #include "lfs_mflash.h"
+#include "mflash_partition.h"
 
 /*******************************************************************************
  * Definitions
@@ -20,6 +21,9 @@
 
 #define SHELL_Printf PRINTF
 
+/* Time the idle loop lets filesystem maintenance take, covers compaction of one 4KB metadata pair */
+#define LFS_GC_IDLE_BUDGET_US (100000U)
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
@@ -34,6 +38,8 @@ static shell_status_t lfs_rm_handler(shell_handle_t shellHandle, int32_t argc, c
 static shell_status_t lfs_mkdir_handler(shell_handle_t shellHandle, int32_t argc, char **argv);
 static shell_status_t lfs_write_handler(shell_handle_t shellHandle, int32_t argc, char **argv);
 static shell_status_t lfs_cat_handler(shell_handle_t shellHandle, int32_t argc, char **argv);
+static shell_status_t lfs_gc_handler(shell_handle_t shellHandle, int32_t argc, char **argv);
+static shell_status_t part_handler(shell_handle_t shellHandle, int32_t argc, char **argv);
 
 /*******************************************************************************
  * Variables
@@ -60,6 +66,11 @@ SHELL_COMMAND_DEFINE(rm, "\r\n\"rm <path>\": Removes file or directory\r\n", lfs
 SHELL_COMMAND_DEFINE(mkdir, "\r\n\"mkdir <path>\": Creates a new directory\r\n", lfs_mkdir_handler, 1);
 SHELL_COMMAND_DEFINE(write, "\r\n\"write <path> <text>\": Writes/appends text to a file\r\n", lfs_write_handler, 2);
 SHELL_COMMAND_DEFINE(cat, "\r\n\"cat <path>\": Prints file content\r\n", lfs_cat_handler, 1);
+SHELL_COMMAND_DEFINE(gc, "\r\n\"gc\": Runs filesystem maintenance and prints its statistics\r\n", lfs_gc_handler, 0);
+SHELL_COMMAND_DEFINE(part,
+                     "\r\n\"part [a|b]\": Lists partitions, selects application slot for the next boot\r\n",
+                     part_handler,
+                     SHELL_IGNORE_PARAMETER_COUNT);
 
 SDK_ALIGN(static uint8_t s_shellHandleBuffer[SHELL_HANDLE_SIZE], 4);
 static shell_handle_t s_shellHandle;
@@ -105,7 +116,7 @@ static shell_status_t lfs_mount_handler(shell_handle_t shellHandle, int32_t argc
         return kStatus_SHELL_Success;
     }
 
-    res = lfs_mount(&lfs, &cfg);
+    res = lfs_mflash_mount(&lfs, &cfg);
     if (res)
     {
         PRINTF("\rError mounting LFS\r\n");
@@ -276,7 +287,7 @@ static shell_status_t lfs_write_handler(shell_handle_t shellHandle, int32_t argc
         return kStatus_SHELL_Success;
     }
 
-    res = lfs_file_open(&lfs, &file, argv[1], LFS_O_WRONLY | LFS_O_APPEND | LFS_O_CREAT);
+    res = lfs_mflash_file_open(&lfs, &file, argv[1], LFS_O_WRONLY | LFS_O_APPEND | LFS_O_CREAT);
     if (res)
     {
         PRINTF("\rError opening file: %i\r\n", res);
@@ -292,7 +303,7 @@ static shell_status_t lfs_write_handler(shell_handle_t shellHandle, int32_t argc
         PRINTF("\rError writing file: %i\r\n", res);
     }
 
-    res = lfs_file_close(&lfs, &file);
+    res = lfs_mflash_file_close(&lfs, &file);
     if (res)
     {
         PRINTF("\rError closing file: %i\r\n", res);
@@ -313,7 +324,7 @@ static shell_status_t lfs_cat_handler(shell_handle_t shellHandle, int32_t argc,
         return kStatus_SHELL_Success;
     }
 
-    res = lfs_file_open(&lfs, &file, argv[1], LFS_O_RDONLY);
+    res = lfs_mflash_file_open(&lfs, &file, argv[1], LFS_O_RDONLY);
     if (res)
     {
         PRINTF("\rError opening file: %i\r\n", res);
@@ -331,7 +342,7 @@ static shell_status_t lfs_cat_handler(shell_handle_t shellHandle, int32_t argc,
         SHELL_Write(s_shellHandle, (char *)buf, res);
     } while (res);
 
-    res = lfs_file_close(&lfs, &file);
+    res = lfs_mflash_file_close(&lfs, &file);
     if (res)
     {
         PRINTF("\rError closing file: %i\r\n", res);
@@ -340,13 +351,97 @@ static shell_status_t lfs_cat_handler(shell_handle_t shellHandle, int32_t argc,
     return kStatus_SHELL_Success;
 }
 
+static shell_status_t lfs_gc_handler(shell_handle_t shellHandle, int32_t argc, char **argv)
+{
+    struct lfs_mflash_ctx *ctx = (struct lfs_mflash_ctx *)cfg.context;
+    int res;
+
+    if (!lfs_mounted)
+    {
+        SHELL_Printf("LFS not mounted\r\n");
+        return kStatus_SHELL_Success;
+    }
+
+    res = lfs_mflash_gc_idle(&lfs, UINT32_MAX);
+    if (res)
+    {
+        PRINTF("\rError running maintenance: %i\r\n", res);
+    }
+
+    SHELL_Printf("runs %u, postponed %u, longest %u us\r\n", ctx->gc.runs, ctx->gc.skipped, ctx->gc.max_us);
+    SHELL_Printf("erases by maintenance %u, other %u\r\n", ctx->gc.gc_erases, ctx->gc.other_erases);
+
+    return kStatus_SHELL_Success;
+}
+
+static shell_status_t part_handler(shell_handle_t shellHandle, int32_t argc, char **argv)
+{
+    const mflash_partition_t *part;
+    mflash_part_slot_t slot;
+    status_t status;
+    uint32_t start;
+    uint32_t us;
+
+    if (argc == 1)
+    {
+        for (uint32_t i = 0U; (part = mflash_part_get(i)) != NULL; i++)
+        {
+            SHELL_Printf("%-16s type %u 0x%06x-0x%06x\r\n", part->name, part->type, part->offset,
+                         part->offset + part->size);
+        }
+        SHELL_Printf("active application slot %c\r\n", (mflash_part_get_active_app() == kMflashPart_SlotA) ? 'A' : 'B');
+        return kStatus_SHELL_Success;
+    }
+
+    if ((argc != 2) || ((strcmp(argv[1], "a") != 0) && (strcmp(argv[1], "b") != 0)))
+    {
+        SHELL_Printf("Usage: part [a|b]\r\n");
+        return kStatus_SHELL_Success;
+    }
+
+    slot = (strcmp(argv[1], "a") == 0) ? kMflashPart_SlotA : kMflashPart_SlotB;
+
+    /* Switch-over is a table update, the image itself is not copied */
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    start  = DWT->CYCCNT;
+    status = mflash_part_set_active_app(slot);
+    us     = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000U);
+
+    if (status != kStatus_Success)
+    {
+        PRINTF("\rError updating partition table: %i\r\n", status);
+    }
+    else
+    {
+        SHELL_Printf("slot %s selected for the next boot in %u us\r\n", argv[1], us);
+    }
+
+    return kStatus_SHELL_Success;
+}
+
 int main(void)
 {
     status_t status;
 
     BOARD_InitHardware();
 
-    lfs_get_default_config(&cfg);
+    /* Partition table, the default layout is written on first start */
+    status = mflash_part_init(NULL, 0U, true);
+    if (status != kStatus_Success)
+    {
+        PRINTF("Partition table init failed: %i\r\n", status);
+        return status;
+    }
+
+    if (lfs_get_default_config(&cfg) != 0)
+    {
+        PRINTF("LFS partition does not fit the FLASH\r\n");
+        return -1;
+    }
 
     status = lfs_storage_init(&cfg);
     if (status != kStatus_Success)
@@ -370,11 +465,18 @@ int main(void)
     SHELL_RegisterCommand(s_shellHandle, SHELL_COMMAND(mkdir));
     SHELL_RegisterCommand(s_shellHandle, SHELL_COMMAND(write));
     SHELL_RegisterCommand(s_shellHandle, SHELL_COMMAND(cat));
+    SHELL_RegisterCommand(s_shellHandle, SHELL_COMMAND(gc));
+    SHELL_RegisterCommand(s_shellHandle, SHELL_COMMAND(part));
 
     while (1)
     {
 #if !(defined(SHELL_NON_BLOCKING_MODE) && (SHELL_NON_BLOCKING_MODE > 0U))
         SHELL_Task(s_shellHandle);
+#else
+        if (lfs_mounted)
+        {
+            (void)lfs_mflash_gc_idle(&lfs, LFS_GC_IDLE_BUDGET_US);
+        }
 #endif
     }
 }
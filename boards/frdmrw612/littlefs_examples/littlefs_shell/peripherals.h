@@ -1,5 +1,5 @@
 /*
- * Copyright 2021-2022 NXP
+ * Copyright 2021-2022, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -28,6 +28,10 @@ extern "C" {
  * User definitions
  **********************************************************************************************************************/
 #define LITTLEFS_START_ADDR 0xC00000
+/* Size of the LittleFS partition in bytes, 0 extends it up to the end of the detected FLASH device */
+#define LITTLEFS_PARTITION_SIZE 0
+/* Filesystem buffers and file caches in static memory, no heap is used by mount and file open/close */
+#define LFS_MFLASH_STATIC_BUFFERS 1
 
 
 /***********************************************************************************************************************
@@ -44,6 +48,11 @@ extern "C" {
 #define LITTLEFS_CACHE_SIZE 256
 /* Minimum lookahead buffer size definition */
 #define LITTLEFS_LOOKAHEAD_SIZE 16
+/* Metadata compaction threshold of lfs_fs_gc, half of the sector leaves room for 7 commits before a write has to
+ * compact inline */
+#define LITTLEFS_COMPACT_THRESH 2048
+/* Metadata pair size limit, whole sector as compaction time is given by the sector erase rather than the size */
+#define LITTLEFS_METADATA_MAX 4096
 
 /***********************************************************************************************************************
  * Global variables
@@ -1,5 +1,5 @@
 /*
- * Copyright 2021 NXP
+ * Copyright 2021, 2026 NXP
  * All rights reserved.
  *
  *
@@ -44,7 +44,8 @@
 #define FLASH_QUAD_ENABLE        0xC740
 #define FLASH_BUSY_STATUS_POL    1
 #define FLASH_BUSY_STATUS_OFFSET 0
-#define CACHE_MAINTAIN           1
+/* CACHE64 stays enabled during FLASH operations, the example invalidates just the modified lines afterwards */
+#define CACHE_MAINTAIN           0
 
 #define EXAMPLE_INVALIDATE_FLEXSPI_CACHE()                                                                          \
     do                                                                                                              \
@@ -1,5 +1,5 @@
 /*
- * Copyright 2021-2022 NXP
+ * Copyright 2021-2022, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -25,10 +25,12 @@ const struct lfs_config LittleFS_config = {
   .read_size = LITTLEFS_READ_SIZE,
   .prog_size = LITTLEFS_PROG_SIZE,
   .block_size = LITTLEFS_BLOCK_SIZE,
-  .block_count = 1024,
+  .block_count = 0,
   .block_cycles = 100,
   .cache_size = LITTLEFS_CACHE_SIZE,
-  .lookahead_size = LITTLEFS_LOOKAHEAD_SIZE
+  .lookahead_size = LITTLEFS_LOOKAHEAD_SIZE,
+  .compact_thresh = LITTLEFS_COMPACT_THRESH,
+  .metadata_max = LITTLEFS_METADATA_MAX
 };
 
 /* Empty initialization function (commented out)
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2016, Freescale Semiconductor, Inc.
- * Copyright 2016-2021 NXP
+ * Copyright 2016-2021, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -8,14 +8,82 @@
 
 #include "fsl_common.h"
 #include "app.h"
+#include "board.h"
 #include "fsl_debug_console.h"
 #include "lfs.h"
-#include "lfs_mflash.h"
+#include "fsl_cache.h"
+#include "fsl_gdma.h"
+#include "peripherals.h"
+#if !defined(LFS_NAND_PORT)
+#include "mflash_file.h"
+#include "mflash_kv.h"
+#include "mflash_ts.h"
+#endif
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+#include "mflash_stage.h"
+#endif
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 
+/* Directory layout written by version 1 of mflash_file, built by the self test to check it is still read */
+#define MFLASH_FILE_TEST_DIR_MAGIC  (0xF17E07ABU)
+#define MFLASH_FILE_TEST_META_MAGIC (0xABECEDA8U)
+#define MFLASH_FILE_TEST_V1_VERSION (0x00010000U)
+#define MFLASH_FILE_TEST_V1_RECORD  (2U * sizeof(uint32_t) + MFLASH_MAX_PATH_LEN)
+#define MFLASH_FILE_TEST_V1_FILES   (2U)
+
+/* Number of pages programmed by the mflash_drv benchmark */
+#define MFLASH_BENCH_PAGES (16U)
+
+/* Area erased by the mflash_drv benchmark, the filesystem is formatted afterwards */
+#define MFLASH_BENCH_ERASE_ADDR (LITTLEFS_START_ADDR)
+#define MFLASH_BENCH_ERASE_SIZE (0x10000U)
+
+/* XIP benchmark, code fetch from FLASH mixed with DMA reads of FLASH data */
+#define XIP_BENCH_ROUNDS      (64U)
+#define XIP_BENCH_DMA_CHANNEL (0U)
+#define XIP_BENCH_DMA_SIZE    (4096U)
+#define XIP_BENCH_ASSET_ADDR  (LITTLEFS_START_ADDR)
+
+/* FLASH programs and erases interleaved with PSRAM copies by CPU and GDMA, pages follow from MFLASH_BENCH_ERASE_ADDR */
+#define PSRAM_STRESS_ROUNDS (64U)
+#define PSRAM_STRESS_ADDR   (0x48000000U) /* Non-cacheable alias of the PSRAM, CPU and GDMA see the same data */
+#define PSRAM_STRESS_SIZE   (XIP_BENCH_DMA_SIZE)
+
+/* Plain and encrypted areas of equal size compared by the inline encryption benchmark, follow from
+ * MFLASH_BENCH_ERASE_ADDR */
+#define IPED_BENCH_SIZE   (MFLASH_BENCH_ERASE_SIZE / 2U)
+#define IPED_BENCH_ROUNDS (16U)
+
+/* Number of pages programmed by the lfs_nand benchmark, first block of the filesystem is used */
+#define LFS_NAND_BENCH_PAGES (8U)
+
+/* File streamed by the read benchmark and size of the reads */
+#define LFS_READ_BENCH_FILE  "stream.bin"
+#define LFS_READ_BENCH_SIZE  (64U * 1024U)
+#define LFS_READ_BENCH_CHUNK (4096U)
+
+/* Path resolution cache test, commits to the directory of the file until its metadata pair relocates */
+#define DCACHE_TEST_RELOCATE_COMMITS (2000U)
+
+/* Updates of small settings, mflash_file erases a sector by each save so it does fewer of them */
+#define KV_BENCH_UPDATES      (10000U)
+#define KV_BENCH_FILE_UPDATES (100U)
+#define KV_BENCH_KEYS         (8U)
+#define KV_BENCH_VALUE_SIZE   (16U)
+#define KV_BENCH_FILE         "kv_bench.bin"
+
+/* Sensor samples appended to the time-series store, the range read starts in the middle of them */
+#define TS_BENCH_RECORDS   (20000U)
+#define TS_BENCH_DATA_SIZE (16U)
+#define TS_BENCH_RANGE     (1000U)
+
+/* Burst written to a file with and without the PSRAM staging, fits the staging queue */
+#define STAGING_BENCH_FILE "burst.bin"
+#define STAGING_BENCH_SIZE (32U * 1024U)
+
 
 /*******************************************************************************
  * Prototypes
@@ -32,10 +100,19 @@ struct lfs_config cfg;
 uint32_t s_wr_buf[64];
 uint32_t s_rb_buf[64];
 
+static uint32_t s_stream_buf[LFS_READ_BENCH_CHUNK / sizeof(uint32_t)];
+
+#if defined(LFS_NAND_PORT)
+static uint32_t s_page_buf[LFS_NAND_BENCH_PAGES * LITTLEFS_PROG_SIZE / sizeof(uint32_t)];
+#else
+static uint32_t s_dma_buf[XIP_BENCH_DMA_SIZE / sizeof(uint32_t)];
+#endif
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
+#if !defined(LFS_NAND_PORT)
 void mflash_drv_self_test(void)
 {
     PRINTF("mflash_drv self test \r\n");
@@ -58,6 +135,1129 @@ void mflash_drv_self_test(void)
         while (1);
     }
 }
+#endif
+
+#if !defined(LFS_NAND_PORT) && defined(MFLASH_FILE_BASEADDR)
+#if !(defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST)
+/* Programs version 1 directory of two files page by page and reads the files through mflash_file */
+static bool mflash_file_test_v1(void)
+{
+    static const char *const paths[MFLASH_FILE_TEST_V1_FILES] = {"v1_first", "v1_second"};
+    static const mflash_file_t dir_template[]                 = {{"v1_first", 1024U}, {"v1_second", 1024U}, {NULL, 0U}};
+    const uint8_t *data;
+    uint32_t size;
+
+    for (uint32_t i = 0U; i <= MFLASH_FILE_TEST_V1_FILES; i++)
+    {
+        if (mflash_drv_sector_erase(MFLASH_FILE_BASEADDR + i * MFLASH_SECTOR_SIZE) != kStatus_Success)
+        {
+            return false;
+        }
+    }
+
+    /* Files in the sectors following the directory, size and magic followed by the content */
+    for (uint32_t f = 0U; f < MFLASH_FILE_TEST_V1_FILES; f++)
+    {
+        (void)memset(s_wr_buf, 0xFF, sizeof(s_wr_buf));
+        s_wr_buf[0] = 16U;
+        s_wr_buf[1] = MFLASH_FILE_TEST_META_MAGIC;
+        (void)memset(&s_wr_buf[2], (int)('a' + f), 16U);
+        if (mflash_drv_page_program(MFLASH_FILE_BASEADDR + (f + 1U) * MFLASH_SECTOR_SIZE, s_wr_buf) != kStatus_Success)
+        {
+            return false;
+        }
+    }
+
+    /* Header padded to the size of the fixed size records following it */
+    (void)memset(s_wr_buf, 0, sizeof(s_wr_buf));
+    s_wr_buf[0] = MFLASH_FILE_TEST_DIR_MAGIC;
+    s_wr_buf[1] = MFLASH_FILE_TEST_V1_VERSION;
+    s_wr_buf[2] = MFLASH_PAGE_SIZE;
+    s_wr_buf[3] = MFLASH_SECTOR_SIZE;
+    s_wr_buf[4] = MFLASH_FILE_TEST_V1_FILES;
+    s_wr_buf[5] = (MFLASH_FILE_TEST_V1_FILES + 1U) * MFLASH_SECTOR_SIZE;
+    for (uint32_t f = 0U; f < MFLASH_FILE_TEST_V1_FILES; f++)
+    {
+        uint32_t *record = &s_wr_buf[(f + 1U) * MFLASH_FILE_TEST_V1_RECORD / sizeof(uint32_t)];
+
+        record[0] = (f + 1U) * MFLASH_SECTOR_SIZE;
+        record[1] = MFLASH_SECTOR_SIZE;
+        (void)strcpy((char *)&record[2], paths[f]);
+    }
+    if (mflash_drv_page_program(MFLASH_FILE_BASEADDR, s_wr_buf) != kStatus_Success)
+    {
+        return false;
+    }
+
+    if (mflash_init(dir_template, false) != kStatus_Success)
+    {
+        return false;
+    }
+
+    for (uint32_t f = 0U; f < MFLASH_FILE_TEST_V1_FILES; f++)
+    {
+        if ((mflash_file_mmap(paths[f], &data, &size) != kStatus_Success) || (size != 16U) ||
+            (data[0] != (uint8_t)('a' + f)) || (data[15] != (uint8_t)('a' + f)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+/* Formats version 2 directory whose first page ends with a gap of given size, the last record then goes to the next
+ * page behind a padding record of the gap size. The files have to keep their content over initialization as on boot.
+ * The header takes 24 bytes, a record 12 bytes plus the path rounded up to 4 bytes: three records of 60 bytes and one
+ * of 52 - gap bytes fill the first page up to the gap. */
+static bool mflash_file_test_page_end(uint32_t gap)
+{
+    static char paths[5][48];
+    const uint32_t path_lens[5] = {45U, 45U, 45U, 40U - gap, 8U};
+    mflash_file_t dir_template[6];
+    const uint8_t *data;
+    uint32_t size;
+
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        (void)memset(paths[i], (int)('a' + i), path_lens[i]);
+        paths[i][path_lens[i]] = '\0';
+        dir_template[i].path     = paths[i];
+        dir_template[i].max_size = 256U;
+    }
+    dir_template[5].path     = NULL;
+    dir_template[5].max_size = 0U;
+
+    /* No filesystem in place, it is formatted */
+    if ((mflash_drv_sector_erase(MFLASH_FILE_BASEADDR) != kStatus_Success) ||
+        (mflash_init(dir_template, false) != kStatus_Success))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        s_wr_buf[0] = gap * 16U + i;
+        if (mflash_file_save(paths[i], (const uint8_t *)s_wr_buf, sizeof(uint32_t)) != kStatus_Success)
+        {
+            return false;
+        }
+    }
+
+    /* Each record has to be found again, otherwise the directory would be grown or formatted losing the files */
+    if (mflash_init(dir_template, false) != kStatus_Success)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        if ((mflash_file_mmap(paths[i], &data, &size) != kStatus_Success) || (size != sizeof(uint32_t)) ||
+            (((const uint32_t *)(const void *)data)[0] != gap * 16U + i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Checks mflash_file reads version 1 directories and directory records adjacent to page boundaries */
+void mflash_file_self_test(void)
+{
+    bool pass = true;
+
+    PRINTF("mflash_file self test ");
+#if !(defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST)
+    pass = mflash_file_test_v1();
+#endif
+    for (uint32_t gap = 0U; (gap <= 8U) && pass; gap += 4U)
+    {
+        pass = mflash_file_test_page_end(gap);
+    }
+
+    if (pass)
+    {
+        PRINTF("pass\r\n");
+    }
+    else
+    {
+        PRINTF("fail\r\n");
+        while (1);
+    }
+}
+#endif
+
+/* Cycle counter based time measurement */
+static void bench_timer_start(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t bench_timer_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+#if defined(LFS_NAND_PORT)
+/* Measures the littlefs block device callbacks of the SPI-NAND port, single pages as littlefs programs them when
+ * committing metadata and multiple pages at once as for file data, which streams the pages by cache program and
+ * cache read. The init time includes the bad block scan of the whole area. */
+void lfs_nand_benchmark(void)
+{
+    uint32_t cycles    = 0U;
+    uint32_t us        = SystemCoreClock / 1000000U;
+    uint32_t page_size = LITTLEFS_PROG_SIZE;
+
+    PRINTF("lfs_nand benchmark\r\n");
+
+    lfs_get_default_config(&cfg);
+
+    bench_timer_start();
+    (void)lfs_storage_init(&cfg);
+    PRINTF("init: %u us, %u factory bad, %u grown bad, %u spare blocks\r\n", bench_timer_cycles() / us,
+           LittleFS_ctx.nand_blocks - LittleFS_ctx.good_blocks, LittleFS_ctx.grown_bad_count,
+           LittleFS_ctx.spare_blocks);
+
+    bench_timer_start();
+    (void)cfg.erase(&cfg, 0);
+    PRINTF("block erase: %u us\r\n", bench_timer_cycles() / us);
+
+    for (uint32_t page = 0U; page < LFS_NAND_BENCH_PAGES; page++)
+    {
+        bench_timer_start();
+        (void)cfg.prog(&cfg, 0, page * page_size, s_page_buf, page_size);
+        cycles += bench_timer_cycles();
+    }
+
+    PRINTF("page program: %u cycles, %u us average\r\n", cycles / LFS_NAND_BENCH_PAGES,
+           cycles / LFS_NAND_BENCH_PAGES / us);
+
+    /* One call per page */
+    bench_timer_start();
+    for (uint32_t page = 0U; page < LFS_NAND_BENCH_PAGES; page++)
+    {
+        (void)cfg.read(&cfg, 0, page * page_size, s_page_buf, page_size);
+    }
+    cycles = bench_timer_cycles();
+    PRINTF("page read: %u cycles, %u us average\r\n", cycles / LFS_NAND_BENCH_PAGES,
+           cycles / LFS_NAND_BENCH_PAGES / us);
+
+    /* All pages by single call */
+    bench_timer_start();
+    (void)cfg.read(&cfg, 0, 0, s_page_buf, LFS_NAND_BENCH_PAGES * page_size);
+    PRINTF("%u pages read: %u us\r\n", LFS_NAND_BENCH_PAGES, bench_timer_cycles() / us);
+
+    (void)cfg.erase(&cfg, 0);
+
+    bench_timer_start();
+    (void)cfg.prog(&cfg, 0, 0, s_page_buf, LFS_NAND_BENCH_PAGES * page_size);
+    PRINTF("%u pages program: %u us\r\n", LFS_NAND_BENCH_PAGES, bench_timer_cycles() / us);
+
+    PRINTF("ECC corrected page reads: %u\r\n", LittleFS_ctx.ecc_corrected);
+}
+#else
+
+/* Measures the average time of page program, the command overhead is the difference between builds with
+ * MFLASH_DRV_FUSED_SEQUENCES enabled and disabled as the time of the program itself is given by the FLASH device.
+ * Built with components/flash/mflash/nor instead of the board driver it compares the NOR component backend (SFDP
+ * probe, fast read mode and block erase taken from the device) with the hand-tuned driver. */
+void mflash_drv_benchmark(void)
+{
+    uint32_t cycles = 0U;
+    uint32_t us     = SystemCoreClock / 1000000U;
+
+#if defined(MFLASH_DRV_NOR_COMPONENT)
+    PRINTF("mflash_drv benchmark (NOR component backend)\r\n");
+#elif defined(MFLASH_DRV_FUSED_SEQUENCES)
+    PRINTF("mflash_drv benchmark (fused sequences %s)\r\n", (MFLASH_DRV_FUSED_SEQUENCES != 0) ? "on" : "off");
+#else
+    PRINTF("mflash_drv benchmark\r\n");
+#endif
+
+    bench_timer_start();
+    (void)mflash_drv_init();
+    PRINTF("init: %u us\r\n", bench_timer_cycles() / us);
+
+    bench_timer_start();
+    (void)mflash_drv_sector_erase(0x0);
+    PRINTF("sector erase: %u us\r\n", bench_timer_cycles() / us);
+
+    for (uint32_t page = 0U; page < MFLASH_BENCH_PAGES; page++)
+    {
+        bench_timer_start();
+        (void)mflash_drv_page_program(page * MFLASH_PAGE_SIZE, s_wr_buf);
+        cycles += bench_timer_cycles();
+    }
+
+    PRINTF("page program: %u cycles, %u us average\r\n", cycles / MFLASH_BENCH_PAGES,
+           cycles / MFLASH_BENCH_PAGES / us);
+
+    /* IP read, one call per page */
+    bench_timer_start();
+    for (uint32_t page = 0U; page < MFLASH_BENCH_PAGES; page++)
+    {
+        (void)mflash_drv_read(page * MFLASH_PAGE_SIZE, s_rb_buf, MFLASH_PAGE_SIZE);
+    }
+    cycles = bench_timer_cycles();
+    PRINTF("page read: %u cycles average\r\n", cycles / MFLASH_BENCH_PAGES);
+
+    /* Erase of 64KB area, by sectors and by block erase where the backend provides it */
+    bench_timer_start();
+    for (uint32_t offset = 0U; offset < MFLASH_BENCH_ERASE_SIZE; offset += MFLASH_SECTOR_SIZE)
+    {
+        (void)mflash_drv_sector_erase(MFLASH_BENCH_ERASE_ADDR + offset);
+    }
+    PRINTF("64KB erase by sectors: %u us\r\n", bench_timer_cycles() / us);
+
+#if defined(MFLASH_DRV_NOR_COMPONENT)
+    bench_timer_start();
+    (void)mflash_drv_erase(MFLASH_BENCH_ERASE_ADDR, MFLASH_BENCH_ERASE_SIZE);
+    PRINTF("64KB erase by block: %u us\r\n", bench_timer_cycles() / us);
+#endif
+}
+
+/* Streams the asset from FLASH to RAM by GDMA */
+static void xip_bench_dma_start(void)
+{
+    gdma_channel_xfer_config_t xferConfig = {
+        .srcAddr       = (uint32_t)mflash_drv_phys2log(XIP_BENCH_ASSET_ADDR, XIP_BENCH_DMA_SIZE),
+        .destAddr      = (uint32_t)s_dma_buf,
+        .ahbProt       = kGDMA_ProtPrevilegedMode,
+        .srcBurstSize  = kGDMA_BurstSize16,
+        .destBurstSize = kGDMA_BurstSize16,
+        .srcWidth      = kGDMA_TransferWidth4Byte,
+        .destWidth     = kGDMA_TransferWidth4Byte,
+        .srcAddrInc    = true,
+        .destAddrInc   = true,
+        .transferLen   = XIP_BENCH_DMA_SIZE,
+    };
+
+    (void)GDMA_SetChannelTransferConfig(GDMA, XIP_BENCH_DMA_CHANNEL, &xferConfig);
+    GDMA_StartChannel(GDMA, XIP_BENCH_DMA_CHANNEL);
+}
+
+/* Code fetch workload, the cache is invalidated so that the code is fetched from FLASH on each round */
+static uint32_t xip_bench_run(bool with_dma)
+{
+    uint32_t crc = 0U;
+    uint32_t cycles;
+
+    bench_timer_start();
+    for (uint32_t i = 0U; i < XIP_BENCH_ROUNDS; i++)
+    {
+        if (with_dma && !GDMA_IsChannelBusy(GDMA, XIP_BENCH_DMA_CHANNEL))
+        {
+            xip_bench_dma_start();
+        }
+        CACHE64_InvalidateCache(CACHE64_CTRL0);
+        crc = lfs_crc(crc, s_rb_buf, sizeof(s_rb_buf));
+    }
+    cycles = bench_timer_cycles();
+
+    while (GDMA_IsChannelBusy(GDMA, XIP_BENCH_DMA_CHANNEL))
+    {
+    }
+
+    (void)crc;
+    return cycles / XIP_BENCH_ROUNDS;
+}
+
+/* Compares code fetch latency with and without concurrent DMA for shared and partitioned AHB RX buffers */
+void xip_benchmark(void)
+{
+#if defined(MFLASH_AHB_DMA_MASTER_ID)
+    /* All masters sharing single buffer */
+    static const mflash_ahb_config_t sharedConfig = {
+        .masters              = NULL,
+        .master_count         = 0,
+        .shared_buffer_size   = MFLASH_AHB_DMA_BUFFER_SIZE + MFLASH_AHB_SHARED_BUFFER_SIZE,
+        .shared_prefetch      = true,
+        .read_address_opt     = false,
+        .clear_ahb_buffer_opt = false,
+    };
+    const mflash_ahb_config_t *configs[] = {&sharedConfig, NULL};
+    const char *names[]                  = {"shared", "board profile"};
+
+    GDMA_Init(GDMA);
+
+    for (uint32_t i = 0U; i < ARRAY_SIZE(configs); i++)
+    {
+        (void)mflash_drv_set_ahb_config(configs[i]);
+        (void)mflash_drv_init();
+
+        PRINTF("XIP benchmark (%s AHB buffers): %u cycles idle, ", names[i], xip_bench_run(false));
+        PRINTF("%u cycles with DMA\r\n", xip_bench_run(true));
+    }
+
+    GDMA_Deinit(GDMA);
+#endif
+}
+#endif
+
+#if !defined(LFS_NAND_PORT)
+/* Fills buffer with pattern unique to the round */
+static void psram_stress_fill(uint32_t *buf, uint32_t words, uint32_t round)
+{
+    for (uint32_t i = 0U; i < words; i++)
+    {
+        buf[i] = (round << 24) ^ (i * 0x9E3779B1U);
+    }
+}
+
+/* Copies the first PSRAM block to the second one by GDMA. Single byte accesses keep the FLEXSPI busy with PSRAM reads
+ * and masked writes while the FLASH operation is issued. */
+static void psram_stress_dma_start(void)
+{
+    gdma_channel_xfer_config_t xferConfig = {
+        .srcAddr       = PSRAM_STRESS_ADDR,
+        .destAddr      = PSRAM_STRESS_ADDR + PSRAM_STRESS_SIZE,
+        .ahbProt       = kGDMA_ProtPrevilegedMode,
+        .srcBurstSize  = kGDMA_BurstSize1,
+        .destBurstSize = kGDMA_BurstSize1,
+        .srcWidth      = kGDMA_TransferWidth1Byte,
+        .destWidth     = kGDMA_TransferWidth1Byte,
+        .srcAddrInc    = true,
+        .destAddrInc   = true,
+        .transferLen   = PSRAM_STRESS_SIZE,
+    };
+
+    /* Stale copy of the previous round is not taken for a good one */
+    (void)memset((void *)(PSRAM_STRESS_ADDR + PSRAM_STRESS_SIZE), 0, PSRAM_STRESS_SIZE);
+
+    (void)GDMA_SetChannelTransferConfig(GDMA, XIP_BENCH_DMA_CHANNEL, &xferConfig);
+    GDMA_StartChannel(GDMA, XIP_BENCH_DMA_CHANNEL);
+}
+
+/* Waits for the GDMA copy, returns number of PSRAM blocks not matching the pattern in s_dma_buf */
+static uint32_t psram_stress_check(void)
+{
+    uint32_t errors = 0U;
+
+    while (GDMA_IsChannelBusy(GDMA, XIP_BENCH_DMA_CHANNEL))
+    {
+    }
+
+    for (uint32_t block = 0U; block < 2U; block++)
+    {
+        if (memcmp((const void *)(PSRAM_STRESS_ADDR + block * PSRAM_STRESS_SIZE), s_dma_buf, PSRAM_STRESS_SIZE) != 0)
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+/* Checks the driver shares the FLEXSPI with the PSRAM on port B1: PSRAM data written by CPU and copied by GDMA
+ * survives the FLASH erases and programs issued meanwhile, which read back right through IP and AHB (XIP) */
+void psram_stress_test(void)
+{
+    uint32_t us           = SystemCoreClock / 1000000U;
+    uint32_t psram_errors = 0U;
+    uint32_t flash_errors = 0U;
+    uint32_t cycles;
+
+    PRINTF("PSRAM/FLASH stress test ");
+    if (BOARD_InitPsRam() != kStatus_Success)
+    {
+        PRINTF("skipped, PSRAM not available\r\n");
+        return;
+    }
+
+    /* The PSRAM is configured now, the driver has to keep it that way */
+    (void)mflash_drv_init();
+    GDMA_Init(GDMA);
+
+    bench_timer_start();
+    for (uint32_t round = 0U; round < PSRAM_STRESS_ROUNDS; round++)
+    {
+        uint32_t page_addr = MFLASH_BENCH_ERASE_ADDR + round * MFLASH_PAGE_SIZE;
+
+        psram_stress_fill(s_dma_buf, ARRAY_SIZE(s_dma_buf), round);
+        (void)memcpy((void *)PSRAM_STRESS_ADDR, s_dma_buf, PSRAM_STRESS_SIZE);
+
+        if ((page_addr % MFLASH_SECTOR_SIZE) == 0U)
+        {
+            psram_stress_dma_start();
+            if (mflash_drv_sector_erase(page_addr) != kStatus_Success)
+            {
+                flash_errors++;
+            }
+            psram_errors += psram_stress_check();
+        }
+
+        psram_stress_fill(s_wr_buf, ARRAY_SIZE(s_wr_buf), ~round);
+        psram_stress_dma_start();
+        if (mflash_drv_page_program(page_addr, s_wr_buf) != kStatus_Success)
+        {
+            flash_errors++;
+        }
+        psram_errors += psram_stress_check();
+
+        if ((mflash_drv_read(page_addr, s_rb_buf, MFLASH_PAGE_SIZE) != kStatus_Success) ||
+            (memcmp(s_rb_buf, s_wr_buf, MFLASH_PAGE_SIZE) != 0) ||
+            (memcmp(mflash_drv_phys2log(page_addr, MFLASH_PAGE_SIZE), s_wr_buf, MFLASH_PAGE_SIZE) != 0))
+        {
+            flash_errors++;
+        }
+    }
+    cycles = bench_timer_cycles();
+
+    GDMA_Deinit(GDMA);
+
+    PRINTF("%s: %u rounds in %u us, %u PSRAM errors, %u FLASH errors\r\n",
+           ((psram_errors == 0U) && (flash_errors == 0U)) ? "pass" : "fail", PSRAM_STRESS_ROUNDS, cycles / us,
+           psram_errors, flash_errors);
+}
+#endif
+
+#if !defined(LFS_NAND_PORT) && defined(MFLASH_ENCRYPT_AREAS)
+/* Programs the area with the pattern, returns the average page program time in cycles */
+static uint32_t iped_bench_program(uint32_t addr, uint32_t *errors)
+{
+    uint32_t cycles = 0U;
+
+    for (uint32_t offset = 0U; offset < IPED_BENCH_SIZE; offset += MFLASH_PAGE_SIZE)
+    {
+        psram_stress_fill(s_wr_buf, ARRAY_SIZE(s_wr_buf), offset / MFLASH_PAGE_SIZE);
+        bench_timer_start();
+        if (mflash_drv_page_program(addr + offset, s_wr_buf) != kStatus_Success)
+        {
+            (*errors)++;
+        }
+        cycles += bench_timer_cycles();
+    }
+
+    return cycles / (IPED_BENCH_SIZE / MFLASH_PAGE_SIZE);
+}
+
+/* Returns number of pages of the area not matching the pattern when read through AHB (XIP) or by the driver */
+static uint32_t iped_bench_verify(uint32_t addr)
+{
+    uint32_t errors = 0U;
+
+    for (uint32_t offset = 0U; offset < IPED_BENCH_SIZE; offset += MFLASH_PAGE_SIZE)
+    {
+        psram_stress_fill(s_wr_buf, ARRAY_SIZE(s_wr_buf), offset / MFLASH_PAGE_SIZE);
+        if ((memcmp(mflash_drv_phys2log(addr + offset, MFLASH_PAGE_SIZE), s_wr_buf, MFLASH_PAGE_SIZE) != 0) ||
+            (mflash_drv_read(addr + offset, s_rb_buf, MFLASH_PAGE_SIZE) != kStatus_Success) ||
+            (memcmp(s_rb_buf, s_wr_buf, MFLASH_PAGE_SIZE) != 0))
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+/* Copies the area from its memory mapped address, the cache is invalidated so that each round reads the FLASH */
+static uint32_t iped_bench_read(uint32_t addr)
+{
+    const uint8_t *src = (const uint8_t *)mflash_drv_phys2log(addr, IPED_BENCH_SIZE);
+
+    bench_timer_start();
+    for (uint32_t round = 0U; round < IPED_BENCH_ROUNDS; round++)
+    {
+        CACHE64_InvalidateCache(CACHE64_CTRL0);
+        for (uint32_t offset = 0U; offset < IPED_BENCH_SIZE; offset += sizeof(s_stream_buf))
+        {
+            (void)memcpy(s_stream_buf, &src[offset], sizeof(s_stream_buf));
+        }
+    }
+
+    return bench_timer_cycles() / IPED_BENCH_ROUNDS;
+}
+
+/* Compares plain and encrypted FLASH areas. The FLEXSPI encrypts page program data and decrypts AHB reads on the fly,
+ * read time of both is expected to be the same. Once the encryption is stopped, the encrypted area reads as
+ * ciphertext. */
+void iped_benchmark(void)
+{
+    static const uint8_t iv[8] = {0x49U, 0x50U, 0x45U, 0x44U, 0x62U, 0x65U, 0x6EU, 0x63U};
+    uint32_t us                = SystemCoreClock / 1000000U;
+    uint32_t plain_addr        = MFLASH_BENCH_ERASE_ADDR;
+    uint32_t enc_addr          = MFLASH_BENCH_ERASE_ADDR + IPED_BENCH_SIZE;
+    uint32_t errors            = 0U;
+    uint32_t plain_prog;
+    uint32_t enc_prog;
+    uint32_t plain_read;
+    uint32_t enc_read;
+
+    PRINTF("IPED benchmark ");
+    (void)mflash_drv_init();
+    mflash_drv_encrypt_clear();
+    if (mflash_drv_encrypt_area(enc_addr, IPED_BENCH_SIZE, iv) != kStatus_Success)
+    {
+        PRINTF("skipped, encryption not available\r\n");
+        return;
+    }
+
+    for (uint32_t offset = 0U; offset < 2U * IPED_BENCH_SIZE; offset += MFLASH_SECTOR_SIZE)
+    {
+        if (mflash_drv_sector_erase(plain_addr + offset) != kStatus_Success)
+        {
+            errors++;
+        }
+    }
+
+    plain_prog = iped_bench_program(plain_addr, &errors);
+    enc_prog   = iped_bench_program(enc_addr, &errors);
+    errors += iped_bench_verify(plain_addr) + iped_bench_verify(enc_addr);
+    plain_read = iped_bench_read(plain_addr);
+    enc_read   = iped_bench_read(enc_addr);
+
+    /* IP read of the stored data without the encryption */
+    mflash_drv_encrypt_clear();
+    psram_stress_fill(s_wr_buf, ARRAY_SIZE(s_wr_buf), 0U);
+    if ((mflash_drv_read(enc_addr, s_rb_buf, MFLASH_PAGE_SIZE) != kStatus_Success) ||
+        (memcmp(s_rb_buf, s_wr_buf, MFLASH_PAGE_SIZE) == 0))
+    {
+        errors++;
+    }
+
+    PRINTF("%s: page program %u us plain, %u us encrypted, %u errors\r\n", (errors == 0U) ? "pass" : "fail",
+           plain_prog / us, enc_prog / us, errors);
+    PRINTF("%uKB read from FLASH: %u us plain, %u us encrypted\r\n", IPED_BENCH_SIZE / 1024U, plain_read / us,
+           enc_read / us);
+}
+#endif
+
+/* Streams a file by large reads, which littlefs passes to the port as spans of CTZ blocks straight to the buffer of
+ * the caller. With LFS_MFLASH_DMA the spans are copied by GDMA, the raw read of the same amount of data through the
+ * mflash_drv is the upper bound. */
+void lfs_read_benchmark(void)
+{
+    lfs_file_t file;
+    uint32_t cycles;
+    uint32_t us = SystemCoreClock / 1000000U;
+    int res;
+
+#if defined(LFS_MFLASH_DMA) && LFS_MFLASH_DMA
+    PRINTF("LFS read benchmark (DMA)\r\n");
+#else
+    PRINTF("LFS read benchmark\r\n");
+#endif
+
+    res = lfs_file_open(&lfs, &file, LFS_READ_BENCH_FILE, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (res)
+    {
+        PRINTF("Error: %i\r\n", res);
+        return;
+    }
+
+    for (uint32_t offset = 0U; offset < LFS_READ_BENCH_SIZE; offset += LFS_READ_BENCH_CHUNK)
+    {
+        (void)lfs_file_write(&lfs, &file, s_stream_buf, LFS_READ_BENCH_CHUNK);
+    }
+    (void)lfs_file_close(&lfs, &file);
+
+    res = lfs_file_open(&lfs, &file, LFS_READ_BENCH_FILE, LFS_O_RDONLY);
+    if (res)
+    {
+        PRINTF("Error: %i\r\n", res);
+        return;
+    }
+
+    bench_timer_start();
+    for (uint32_t offset = 0U; offset < LFS_READ_BENCH_SIZE; offset += LFS_READ_BENCH_CHUNK)
+    {
+        (void)lfs_file_read(&lfs, &file, s_stream_buf, LFS_READ_BENCH_CHUNK);
+    }
+    cycles = bench_timer_cycles();
+    (void)lfs_file_close(&lfs, &file);
+
+    PRINTF("file read: %u us, %u KB/s\r\n", cycles / us,
+           (uint32_t)((uint64_t)LFS_READ_BENCH_SIZE * SystemCoreClock / 1024U / cycles));
+
+#if !defined(LFS_NAND_PORT)
+    bench_timer_start();
+    for (uint32_t offset = 0U; offset < LFS_READ_BENCH_SIZE; offset += LFS_READ_BENCH_CHUNK)
+    {
+        (void)mflash_drv_read(LITTLEFS_START_ADDR + offset, s_stream_buf, LFS_READ_BENCH_CHUNK);
+    }
+    cycles = bench_timer_cycles();
+
+    PRINTF("raw read: %u us, %u KB/s\r\n", cycles / us,
+           (uint32_t)((uint64_t)LFS_READ_BENCH_SIZE * SystemCoreClock / 1024U / cycles));
+#endif
+}
+
+#if defined(LFS_DENTRY_CACHE)
+static bool lfs_dcache_test_write(const char *path, uint32_t value)
+{
+    lfs_file_t file;
+
+    if (lfs_file_open(&lfs, &file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != 0)
+    {
+        return false;
+    }
+    if (lfs_file_write(&lfs, &file, &value, sizeof(value)) != (lfs_ssize_t)sizeof(value))
+    {
+        (void)lfs_file_close(&lfs, &file);
+        return false;
+    }
+
+    return (lfs_file_close(&lfs, &file) == 0);
+}
+
+static bool lfs_dcache_test_read(const char *path, uint32_t expected)
+{
+    lfs_file_t file;
+    uint32_t value = ~expected;
+
+    if (lfs_file_open(&lfs, &file, path, LFS_O_RDONLY) != 0)
+    {
+        return false;
+    }
+    if (lfs_file_read(&lfs, &file, &value, sizeof(value)) != (lfs_ssize_t)sizeof(value))
+    {
+        value = ~expected;
+    }
+    (void)lfs_file_close(&lfs, &file);
+
+    return (value == expected);
+}
+
+static bool lfs_dcache_test_missing(const char *path)
+{
+    struct lfs_info info;
+
+    return (lfs_stat(&lfs, path, &info) == LFS_ERR_NOENT);
+}
+
+static bool lfs_dcache_test_pair(const char *path, lfs_block_t pair[2])
+{
+    lfs_dir_t dir;
+
+    if (lfs_dir_open(&lfs, &dir, path) != 0)
+    {
+        return false;
+    }
+    pair[0] = dir.m.pair[0];
+    pair[1] = dir.m.pair[1];
+
+    return (lfs_dir_close(&lfs, &dir) == 0);
+}
+
+/* Remove and rename of directories held by the warm path resolution cache, then relocation of the metadata pair of
+ * a cached directory forced by lowering block_cycles. Files below are read by path after each of these. */
+static bool lfs_dcache_test_run(void)
+{
+    struct lfs_fsinfo fsinfo;
+    lfs_block_t pair[2];
+    lfs_block_t relocated[2];
+    int32_t block_cycles;
+    bool pass;
+    uint32_t i;
+
+    if ((lfs_mkdir(&lfs, "dc") != 0) || (lfs_mkdir(&lfs, "dc/a") != 0) || (lfs_mkdir(&lfs, "dc/a/b") != 0) ||
+        !lfs_dcache_test_write("dc/a/b/f", 1U) || !lfs_dcache_test_read("dc/a/b/f", 1U) ||
+        !lfs_dcache_test_read("dc/a/b/f", 1U))
+    {
+        return false;
+    }
+
+    /* The second read has to start at the cached directory */
+    if ((lfs_fs_stat(&lfs, &fsinfo) != 0) || (fsinfo.dcache_hits == 0U))
+    {
+        return false;
+    }
+
+    /* Remove, the directory created again at the same path gets another pair */
+    if ((lfs_remove(&lfs, "dc/a/b/f") != 0) || (lfs_remove(&lfs, "dc/a/b") != 0) ||
+        !lfs_dcache_test_missing("dc/a/b/f") || !lfs_dcache_test_missing("dc/a/b") ||
+        (lfs_mkdir(&lfs, "dc/a/b") != 0) || !lfs_dcache_test_missing("dc/a/b/f") ||
+        !lfs_dcache_test_write("dc/a/b/f", 2U) || !lfs_dcache_test_read("dc/a/b/f", 2U))
+    {
+        return false;
+    }
+
+    /* Rename, old paths must not resolve to the moved directories */
+    if ((lfs_rename(&lfs, "dc/a", "dc/c") != 0) || !lfs_dcache_test_missing("dc/a/b/f") ||
+        !lfs_dcache_test_missing("dc/a/b") || !lfs_dcache_test_read("dc/c/b/f", 2U) ||
+        (lfs_mkdir(&lfs, "dc/a") != 0) || !lfs_dcache_test_missing("dc/a/b"))
+    {
+        return false;
+    }
+
+    /* Relocation, the file is rewritten through the cached directory until its pair moves */
+    if (!lfs_dcache_test_pair("dc/c/b", pair))
+    {
+        return false;
+    }
+
+    block_cycles     = cfg.block_cycles;
+    cfg.block_cycles = 1;
+    pass             = false;
+    for (i = 0U; i < DCACHE_TEST_RELOCATE_COMMITS; i++)
+    {
+        if (!lfs_dcache_test_write("dc/c/b/f", i) || !lfs_dcache_test_read("dc/c/b/f", i) ||
+            !lfs_dcache_test_pair("dc/c/b", relocated))
+        {
+            break;
+        }
+        if ((relocated[0] != pair[0]) || (relocated[1] != pair[1]))
+        {
+            pass = true;
+            break;
+        }
+    }
+    cfg.block_cycles = block_cycles;
+
+    /* Another commit through the relocated directory, then the content read by path again */
+    if (!pass || !lfs_dcache_test_write("dc/c/b/f", i + 1U) || !lfs_dcache_test_read("dc/c/b/f", i + 1U))
+    {
+        return false;
+    }
+
+    return ((lfs_remove(&lfs, "dc/c/b/f") == 0) && (lfs_remove(&lfs, "dc/c/b") == 0) &&
+            (lfs_remove(&lfs, "dc/c") == 0) && (lfs_remove(&lfs, "dc/a") == 0) && (lfs_remove(&lfs, "dc") == 0));
+}
+
+/* Checks the path resolution cache does not resolve paths to removed, moved or relocated directories */
+void lfs_dcache_self_test(void)
+{
+    PRINTF("LFS path cache self test ");
+    if (lfs_dcache_test_run())
+    {
+        PRINTF("pass\r\n");
+    }
+    else
+    {
+        PRINTF("fail\r\n");
+        while (1);
+    }
+}
+#endif
+
+#if !defined(LFS_NAND_PORT)
+/* Prints total and per update time of the updates, the mflash_file one is extrapolated to KV_BENCH_UPDATES */
+static void kv_bench_report(const char *name, uint64_t cycles, uint32_t updates)
+{
+    uint32_t us = SystemCoreClock / 1000000U;
+
+    PRINTF("%s: %u updates in %u ms, %u us per update\r\n", name, updates, (uint32_t)(cycles / us / 1000U),
+           (uint32_t)(cycles / us / updates));
+}
+
+/* Repeated updates of few small settings: key-value store appending a record per update, mflash_file rewriting the
+ * whole file and littlefs committing the file on close. Each value is checked after the updates. */
+void kv_benchmark(void)
+{
+    static const mflash_file_t dir_template[] = {{KV_BENCH_FILE, 256U}, {NULL, 0U}};
+    uint32_t value[KV_BENCH_VALUE_SIZE / sizeof(uint32_t)] = {0U};
+    char path[16];
+    const uint8_t *data;
+    uint32_t size;
+    uint64_t cycles;
+    mflash_kv_stats_t stats;
+    lfs_file_t file;
+    status_t status;
+    int res;
+
+    PRINTF("Small update benchmark, %u keys of %u bytes\r\n", KV_BENCH_KEYS, KV_BENCH_VALUE_SIZE);
+
+    status = mflash_kv_init(false);
+    if (status != kStatus_Success)
+    {
+        PRINTF("mflash_kv init failed: %i\r\n", status);
+        return;
+    }
+
+    cycles = 0U;
+    for (uint32_t i = 0U; i < KV_BENCH_UPDATES; i++)
+    {
+        (void)snprintf(path, sizeof(path), "key%u", i % KV_BENCH_KEYS);
+        value[0] = i;
+        bench_timer_start();
+        status = mflash_kv_set(path, value, sizeof(value));
+        cycles += bench_timer_cycles();
+        if (status != kStatus_Success)
+        {
+            PRINTF("mflash_kv set failed: %i\r\n", status);
+            return;
+        }
+    }
+    kv_bench_report("mflash_kv", cycles, KV_BENCH_UPDATES);
+
+    /* Index rebuilt from FLASH as on boot */
+    bench_timer_start();
+    status = mflash_kv_init(false);
+    cycles = bench_timer_cycles();
+    mflash_kv_get_stats(&stats);
+    PRINTF("mflash_kv scan: %u us, %u of %u sectors in use, %u sectors collected by the updates\r\n",
+           (uint32_t)(cycles / (SystemCoreClock / 1000000U)), stats.used, stats.sectors, stats.collections);
+    for (uint32_t k = 0U; (k < KV_BENCH_KEYS) && (status == kStatus_Success); k++)
+    {
+        (void)snprintf(path, sizeof(path), "key%u", k);
+        status = mflash_kv_get(path, &data, &size);
+        if ((status == kStatus_Success) &&
+            ((size != sizeof(value)) || (((const uint32_t *)(const void *)data)[0] % KV_BENCH_KEYS != k)))
+        {
+            status = kStatus_Fail;
+        }
+    }
+    if (status != kStatus_Success)
+    {
+        PRINTF("mflash_kv check failed\r\n");
+    }
+
+    status = mflash_init(dir_template, false);
+    if (status != kStatus_Success)
+    {
+        PRINTF("mflash_file init failed: %i\r\n", status);
+        return;
+    }
+
+    cycles = 0U;
+    for (uint32_t i = 0U; i < KV_BENCH_FILE_UPDATES; i++)
+    {
+        value[0] = i;
+        bench_timer_start();
+        status = mflash_file_save(KV_BENCH_FILE, (const uint8_t *)value, sizeof(value));
+        cycles += bench_timer_cycles();
+        if (status != kStatus_Success)
+        {
+            PRINTF("mflash_file save failed: %i\r\n", status);
+            return;
+        }
+    }
+    kv_bench_report("mflash_file", cycles, KV_BENCH_FILE_UPDATES);
+    PRINTF("mflash_file: %u ms projected for %u updates\r\n",
+           (uint32_t)(cycles * (KV_BENCH_UPDATES / KV_BENCH_FILE_UPDATES) / (SystemCoreClock / 1000U)),
+           KV_BENCH_UPDATES);
+
+    cycles = 0U;
+    for (uint32_t i = 0U; i < KV_BENCH_UPDATES; i++)
+    {
+        (void)snprintf(path, sizeof(path), "key%u", i % KV_BENCH_KEYS);
+        value[0] = i;
+        bench_timer_start();
+        res = lfs_file_open(&lfs, &file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+        if (res == 0)
+        {
+            (void)lfs_file_write(&lfs, &file, value, sizeof(value));
+            res = lfs_file_close(&lfs, &file);
+        }
+        cycles += bench_timer_cycles();
+        if (res)
+        {
+            PRINTF("littlefs update failed: %i\r\n", res);
+            return;
+        }
+    }
+    kv_bench_report("littlefs", cycles, KV_BENCH_UPDATES);
+}
+
+/* Prints append time of the run and bandwidth of the pages programmed by it */
+static void ts_bench_report(const char *name, uint64_t cycles, uint32_t pages)
+{
+    uint32_t us = SystemCoreClock / 1000000U;
+
+    PRINTF("%s: %u records in %u ms, %u cycles per record, %u pages at %u KB/s\r\n", name, TS_BENCH_RECORDS,
+           (uint32_t)(cycles / us / 1000U), (uint32_t)(cycles / TS_BENCH_RECORDS), pages,
+           (uint32_t)((uint64_t)pages * MFLASH_PAGE_SIZE * SystemCoreClock / 1024U / cycles));
+}
+
+/* Appends sensor samples to the time-series store, first with the sector ahead erased between appends as from idle
+ * time, so that appends only program pages, then with the erase left to the append crossing the sector. The page
+ * program bandwidth is given by the mflash_drv benchmark. Afterwards the index is rebuilt and a range of samples is
+ * read back from the middle by seek. */
+void ts_benchmark(void)
+{
+    uint32_t sample[TS_BENCH_DATA_SIZE / sizeof(uint32_t)] = {0U};
+    uint32_t us                                            = SystemCoreClock / 1000000U;
+    uint32_t timestamp;
+    uint32_t pages;
+    uint32_t count;
+    uint32_t size;
+    uint64_t cycles;
+    uint64_t idle_cycles;
+    const uint8_t *data;
+    mflash_ts_cursor_t cursor;
+    mflash_ts_stats_t stats;
+    status_t status;
+
+    PRINTF("Time-series benchmark, %u byte samples\r\n", TS_BENCH_DATA_SIZE);
+
+    status = mflash_ts_init(false);
+    if (status != kStatus_Success)
+    {
+        PRINTF("mflash_ts init failed: %i\r\n", status);
+        return;
+    }
+    mflash_ts_get_stats(&stats);
+    timestamp = stats.last_ts + 1U;
+    pages     = stats.pages;
+
+    cycles      = 0U;
+    idle_cycles = 0U;
+    for (uint32_t i = 0U; i < TS_BENCH_RECORDS; i++, timestamp++)
+    {
+        sample[0] = timestamp;
+        bench_timer_start();
+        status = mflash_ts_append(timestamp, sample, sizeof(sample));
+        cycles += bench_timer_cycles();
+        if (status == kStatus_Success)
+        {
+            bench_timer_start();
+            status = mflash_ts_erase_ahead();
+            idle_cycles += bench_timer_cycles();
+        }
+        if (status != kStatus_Success)
+        {
+            PRINTF("mflash_ts append failed: %i\r\n", status);
+            return;
+        }
+    }
+    mflash_ts_get_stats(&stats);
+    ts_bench_report("mflash_ts erased ahead", cycles, stats.pages - pages);
+    PRINTF("mflash_ts erase ahead: %u ms idle time\r\n", (uint32_t)(idle_cycles / us / 1000U));
+    pages = stats.pages;
+
+    cycles = 0U;
+    for (uint32_t i = 0U; i < TS_BENCH_RECORDS; i++, timestamp++)
+    {
+        sample[0] = timestamp;
+        bench_timer_start();
+        status = mflash_ts_append(timestamp, sample, sizeof(sample));
+        cycles += bench_timer_cycles();
+        if (status != kStatus_Success)
+        {
+            PRINTF("mflash_ts append failed: %i\r\n", status);
+            return;
+        }
+    }
+    mflash_ts_get_stats(&stats);
+    ts_bench_report("mflash_ts erase on demand", cycles, stats.pages - pages);
+    (void)mflash_ts_flush();
+
+    /* Index rebuilt from FLASH as on boot */
+    bench_timer_start();
+    status = mflash_ts_init(false);
+    cycles = bench_timer_cycles();
+    mflash_ts_get_stats(&stats);
+    PRINTF("mflash_ts scan: %u us, %u of %u sectors in use, timestamps %u to %u\r\n", (uint32_t)(cycles / us),
+           stats.used, stats.sectors, stats.first_ts, stats.last_ts);
+    if (status != kStatus_Success)
+    {
+        PRINTF("mflash_ts init failed: %i\r\n", status);
+        return;
+    }
+
+    timestamp = stats.first_ts + (stats.last_ts - stats.first_ts) / 2U;
+    bench_timer_start();
+    status = mflash_ts_seek(timestamp, &cursor);
+    cycles = bench_timer_cycles();
+    for (count = 0U; (count < TS_BENCH_RANGE) && (status == kStatus_Success); count++, timestamp++)
+    {
+        uint32_t ts;
+
+        status = mflash_ts_next(&cursor, &ts, &data, &size);
+        if ((status == kStatus_Success) &&
+            ((ts != timestamp) || (size != sizeof(sample)) || (((const uint32_t *)(const void *)data)[0] != ts)))
+        {
+            status = kStatus_Fail;
+        }
+    }
+    PRINTF("mflash_ts seek: %u us, range read of %u samples %s\r\n", (uint32_t)(cycles / us), TS_BENCH_RANGE,
+           (status == kStatus_Success) ? "pass" : "fail");
+}
+#endif
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+/* Writes and closes a file of STAGING_BENCH_SIZE, returns cycles taken or 0 on failure */
+static uint32_t staging_bench_burst(void)
+{
+    lfs_file_t file;
+    uint32_t cycles;
+    int res;
+
+    bench_timer_start();
+    res = lfs_file_open(&lfs, &file, STAGING_BENCH_FILE, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    for (uint32_t offset = 0U; (offset < STAGING_BENCH_SIZE) && (res >= 0); offset += LFS_READ_BENCH_CHUNK)
+    {
+        s_stream_buf[0] = offset;
+        res             = lfs_file_write(&lfs, &file, s_stream_buf, LFS_READ_BENCH_CHUNK);
+    }
+    if (res >= 0)
+    {
+        res = lfs_file_close(&lfs, &file);
+    }
+    cycles = bench_timer_cycles();
+
+    return (res < 0) ? 0U : cycles;
+}
+
+/* Burst of file writes going to FLASH directly and queued in PSRAM, the queue is then drained as from idle time and
+ * the file is read back from FLASH */
+void staging_benchmark(void)
+{
+    uint32_t us = SystemCoreClock / 1000000U;
+    uint32_t cycles;
+    mflash_stage_stats_t stats;
+    lfs_file_t file;
+    int res;
+
+    PRINTF("Write staging benchmark, %u KB burst\r\n", STAGING_BENCH_SIZE / 1024U);
+
+    if (!LittleFS_ctx.staging)
+    {
+        PRINTF("staging memory not available\r\n");
+        return;
+    }
+
+    /* Writes queued so far have to reach the FLASH before writing around the queue */
+    if (lfs_mflash_flush(&lfs) != 0)
+    {
+        PRINTF("flush failed\r\n");
+        return;
+    }
+
+    LittleFS_ctx.staging = false;
+    cycles               = staging_bench_burst();
+    LittleFS_ctx.staging = true;
+    PRINTF("direct: %u us\r\n", cycles / us);
+
+    cycles = staging_bench_burst();
+    PRINTF("staged, flushed by close: %u us\r\n", cycles / us);
+
+    /* Close as barrier only, the burst stays queued */
+    LittleFS_ctx.sync_barrier = true;
+    cycles                    = staging_bench_burst();
+    LittleFS_ctx.sync_barrier = false;
+    mflash_stage_get_stats(&stats);
+    PRINTF("staged: %u us, %u pages and sectors queued\r\n", cycles / us, stats.queued);
+
+    bench_timer_start();
+    res    = lfs_mflash_drain_idle(&lfs, UINT32_MAX);
+    cycles = bench_timer_cycles();
+    mflash_stage_get_stats(&stats);
+    PRINTF("drain: %u us, %u stalls of full queue\r\n", cycles / us, stats.stalls);
+
+    if (res == 0)
+    {
+        res = lfs_file_open(&lfs, &file, STAGING_BENCH_FILE, LFS_O_RDONLY);
+    }
+    for (uint32_t offset = 0U; (offset < STAGING_BENCH_SIZE) && (res >= 0); offset += LFS_READ_BENCH_CHUNK)
+    {
+        res = lfs_file_read(&lfs, &file, s_stream_buf, LFS_READ_BENCH_CHUNK);
+        if ((res >= 0) && (s_stream_buf[0] != offset))
+        {
+            res = LFS_ERR_CORRUPT;
+        }
+    }
+    if (res >= 0)
+    {
+        res = lfs_file_close(&lfs, &file);
+    }
+    PRINTF("read back %s\r\n", (res >= 0) ? "pass" : "fail");
+}
+#endif
 
 int main(void)
 {
@@ -65,11 +1265,32 @@ int main(void)
 
     BOARD_InitHardware();
     
+#if defined(LFS_NAND_PORT)
+    lfs_nand_benchmark();
+#else
     mflash_drv_self_test();
+#if defined(MFLASH_FILE_BASEADDR)
+    mflash_file_self_test();
+#endif
+    mflash_drv_benchmark();
+    xip_benchmark();
+    psram_stress_test();
+#if defined(MFLASH_ENCRYPT_AREAS)
+    iped_benchmark();
+#endif
+#endif
     
     PRINTF("LFS basic test \r\n");
 
-    lfs_get_default_config(&cfg);
+    if (lfs_get_default_config(&cfg) != 0)
+    {
+        PRINTF("LFS partition does not fit the FLASH\r\n");
+        return -1;
+    }
+#if !defined(LFS_NAND_PORT)
+    PRINTF("LFS partition 0x%x, %u blocks of %u bytes, FLASH size %u bytes\r\n", LittleFS_ctx.start_addr,
+           cfg.block_count, cfg.block_size, mflash_drv_get_size());
+#endif
 
     status = lfs_storage_init(&cfg);
     PRINTF("LFS storage init ");
@@ -138,6 +1359,30 @@ int main(void)
         }
     }
 
+#if defined(LFS_DENTRY_CACHE)
+    lfs_dcache_self_test();
+#endif
+    lfs_read_benchmark();
+
+#if !defined(LFS_NAND_PORT)
+    kv_benchmark();
+    ts_benchmark();
+#endif
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    staging_benchmark();
+#endif
+
+#if !defined(LFS_NAND_PORT)
+    PRINTF("idle maintenance ");
+    res = lfs_mflash_gc_idle(&lfs, UINT32_MAX);
+    if (res)
+    {
+        PRINTF("Error: %i\r\n", res);
+    }
+    PRINTF("done: %u us, %u erases in gc, %u other erases\r\n", LittleFS_ctx.gc.max_us, LittleFS_ctx.gc.gc_erases,
+           LittleFS_ctx.gc.other_erases);
+#endif
+
     while (1)
     {
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2021-2022 NXP
+ * Copyright 2021-2022, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -16,6 +16,61 @@
 /***********************************************************************************************************************
  * LittleFS initialization code
  **********************************************************************************************************************/
+#if defined(LITTLEFS_NAND) && LITTLEFS_NAND
+static flexspi_mem_config_t LittleFS_nand_mem_config = {
+  .deviceConfig = {
+    .flexspiRootClk = 32000000, /* T3 256MHz / 8 set by BOARD_InitHardware */
+    .isSck2Enabled = false,
+    .flashSize = LITTLEFS_NAND_FLASH_SIZE,
+    .CSIntervalUnit = kFLEXSPI_CsIntervalUnit1SckCycle,
+    .CSInterval = 2,
+    .CSHoldTime = 3,
+    .CSSetupTime = 3,
+    .dataValidTime = 0,
+    .columnspace = 12,
+    .enableWordAddress = false,
+    .AWRSeqIndex = 0,
+    .AWRSeqNumber = 0,
+    .ARDSeqIndex = NAND_CMD_LUT_SEQ_IDX_READCACHE,
+    .ARDSeqNumber = 1,
+    .AHBWriteWaitUnit = kFLEXSPI_AhbWriteWaitUnit2AhbCycle,
+    .AHBWriteWaitInterval = 0,
+  },
+  .devicePort = kFLEXSPI_PortB1,
+  .dataBytesPerPage = 2048,
+  .bytesInPageSpareArea = 128,
+  .pagesPerBlock = 64,
+  .busyOffset = 0,
+  .busyBitPolarity = 0,
+  .eccStatusMask = 0x70,  /* ECC status bits 6:4 of the status register C0h */
+  .eccFailureMask = 0x20, /* Uncorrectable errors */
+  .planesPerDevice = 2,
+  .cacheRead = true, /* 31h/3Fh */
+  .cacheProgram = false
+};
+
+nand_config_t LittleFS_nand_config = {
+  .memControlConfig = (void*)&LittleFS_nand_mem_config,
+  .driverBaseAddr = (void*)FLEXSPI
+};
+
+const struct lfs_config LittleFS_config = {
+  .context = (void*)&LittleFS_ctx,
+  .read = lfs_nand_read,
+  .prog = lfs_nand_prog,
+  .erase = lfs_nand_erase,
+  .sync = lfs_nand_sync,
+  .read_size = LITTLEFS_READ_SIZE,
+  .prog_size = LITTLEFS_PROG_SIZE,
+  .block_size = LITTLEFS_BLOCK_SIZE,
+  .block_count = LITTLEFS_BLOCK_COUNT,
+  .block_cycles = 500,
+  .cache_size = LITTLEFS_CACHE_SIZE,
+  .lookahead_size = LITTLEFS_LOOKAHEAD_SIZE,
+  .compact_thresh = LITTLEFS_COMPACT_THRESH,
+  .metadata_max = LITTLEFS_METADATA_MAX
+};
+#else
 const struct lfs_config LittleFS_config = {
   .context = (void*)&LittleFS_ctx,
   .read = lfs_mflash_read,
@@ -25,11 +80,14 @@ const struct lfs_config LittleFS_config = {
   .read_size = LITTLEFS_READ_SIZE,
   .prog_size = LITTLEFS_PROG_SIZE,
   .block_size = LITTLEFS_BLOCK_SIZE,
-  .block_count = 1024,
+  .block_count = 0,
   .block_cycles = 100,
   .cache_size = LITTLEFS_CACHE_SIZE,
-  .lookahead_size = LITTLEFS_LOOKAHEAD_SIZE
+  .lookahead_size = LITTLEFS_LOOKAHEAD_SIZE,
+  .compact_thresh = LITTLEFS_COMPACT_THRESH,
+  .metadata_max = LITTLEFS_METADATA_MAX
 };
+#endif
 
 /* Empty initialization function (commented out)
 static void LittleFS_init(void) {
@@ -1,5 +1,5 @@
 /*
- * Copyright 2021-2022 NXP
+ * Copyright 2021-2022, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -11,7 +11,12 @@
 /***********************************************************************************************************************
  * User includes
  **********************************************************************************************************************/
+#if defined(LITTLEFS_NAND) && LITTLEFS_NAND
+#include "lfs_nand.h"
+#include "fsl_flexspi_nand_flash.h"
+#else
 #include "lfs_mflash.h"
+#endif
 
 
 /***********************************************************************************************************************
@@ -27,13 +32,49 @@ extern "C" {
 /***********************************************************************************************************************
  * User definitions
  **********************************************************************************************************************/
+#if defined(LITTLEFS_NAND) && LITTLEFS_NAND
+/* SPI-NAND (MT29F2G01ABAGD: 2048 blocks of 64 pages of 2048 bytes, 2 planes) on the FLEXSPI port B1 in place of the
+ * PSRAM. The NAND component takes the whole LUT, so the code runs from RAM. */
+#define LITTLEFS_START_BLOCK 0
+#define LITTLEFS_NAND_BLOCKS 2048
+/* Address space of the device in KByte, column address takes 12 bits including the plane select */
+#define LITTLEFS_NAND_FLASH_SIZE (2048 * 64 * 4)
+/* littlefs blocks, the remaining 64 blocks of the area cover up to 40 factory bad blocks of the device and the spares
+ * replacing blocks gone bad during use */
+#define LITTLEFS_BLOCK_COUNT 1984
+#else
 #define LITTLEFS_START_ADDR 0xC00000
+/* Size of the LittleFS partition in bytes, 0 extends it up to the end of the detected FLASH device */
+#define LITTLEFS_PARTITION_SIZE 0
+/* Large file reads by GDMA straight to the buffer of the caller */
+#define LFS_MFLASH_DMA 1
+/* Programs and erases queued in PSRAM on the FLEXSPI port B1, drained to FLASH in idle time */
+#define LFS_MFLASH_STAGING 1
+/* Filesystem encrypted by the FLEXSPI (IPED) with the key provided by the boot ROM */
+#define LFS_MFLASH_ENCRYPTED 1
+#endif
 
 
 /***********************************************************************************************************************
  * Definitions
  **********************************************************************************************************************/
 /* Definitions for BOARD_InitPeripherals functional group */
+#if defined(LITTLEFS_NAND) && LITTLEFS_NAND
+/* Maximum block read size definition, the NAND reads whole pages anyway */
+#define LITTLEFS_READ_SIZE 2048
+/* Maximum block program size definition, one page */
+#define LITTLEFS_PROG_SIZE 2048
+/* Erasable block size definition */
+#define LITTLEFS_BLOCK_SIZE (64 * 2048)
+/* Minimum block cache size definition */
+#define LITTLEFS_CACHE_SIZE 2048
+/* Minimum lookahead buffer size definition */
+#define LITTLEFS_LOOKAHEAD_SIZE 32
+/* Metadata compaction threshold of lfs_fs_gc, littlefs default */
+#define LITTLEFS_COMPACT_THRESH 0
+/* Metadata pair size limit, 8 pages bound the compaction time instead of the whole 128KB block */
+#define LITTLEFS_METADATA_MAX (8 * 2048)
+#else
 /* Maximum block read size definition */
 #define LITTLEFS_READ_SIZE 16
 /* Maximum block program size definition */
@@ -44,18 +85,41 @@ extern "C" {
 #define LITTLEFS_CACHE_SIZE 256
 /* Minimum lookahead buffer size definition */
 #define LITTLEFS_LOOKAHEAD_SIZE 16
+/* Metadata compaction threshold of lfs_fs_gc, half of the sector leaves room for 7 commits before a write has to
+ * compact inline */
+#define LITTLEFS_COMPACT_THRESH 2048
+/* Metadata pair size limit, whole sector as compaction time is given by the sector erase rather than the size */
+#define LITTLEFS_METADATA_MAX 4096
+#endif
 
 /***********************************************************************************************************************
  * Global variables
  **********************************************************************************************************************/
+#if defined(LITTLEFS_NAND) && LITTLEFS_NAND
+/* LittleFS context */
+extern struct lfs_nand_ctx LittleFS_ctx;
+/* NAND FLASH controller configuration */
+extern nand_config_t LittleFS_nand_config;
+#else
 /* LittleFS context */
 extern struct lfs_mflash_ctx LittleFS_ctx;
+#endif
 /* LittleFS configuration */
 extern const struct lfs_config LittleFS_config;
 
 /***********************************************************************************************************************
  * Callback functions
  **********************************************************************************************************************/
+#if defined(LITTLEFS_NAND) && LITTLEFS_NAND
+/* LittleFS read a block region callback*/
+extern int lfs_nand_read(const struct lfs_config*, lfs_block_t, lfs_off_t, void*, lfs_size_t);
+/* LittleFS program a block region callback*/
+extern int lfs_nand_prog(const struct lfs_config*, lfs_block_t, lfs_off_t, const void*, lfs_size_t);
+/* LittleFS erase a block callback*/
+extern int lfs_nand_erase(const struct lfs_config*, lfs_block_t);
+/* LittleFS state sync callback*/
+extern int lfs_nand_sync(const struct lfs_config*);
+#else
 /* LittleFS read a block region callback*/
 extern int lfs_mflash_read(const struct lfs_config*, lfs_block_t, lfs_off_t, void*, lfs_size_t);
 /* LittleFS program a block region callback*/
@@ -64,6 +128,7 @@ extern int lfs_mflash_prog(const struct lfs_config*, lfs_block_t, lfs_off_t, con
 extern int lfs_mflash_erase(const struct lfs_config*, lfs_block_t);
 /* LittleFS state sync callback*/
 extern int lfs_mflash_sync(const struct lfs_config*);
+#endif
 
 /***********************************************************************************************************************
  * Initialization functions
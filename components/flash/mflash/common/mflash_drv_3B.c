@@ -1,5 +1,5 @@
 /*
- * Copyright 2017-2022, 2024 NXP
+ * Copyright 2017-2022, 2024, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -42,7 +42,7 @@ static flexspi_device_config_t deviceconfig = {
     .AHBWriteWaitInterval = 0,
 };
 
-const uint32_t customLUT[CUSTOM_LUT_LENGTH] = {
+AT_QUICKACCESS_SECTION_DATA(const uint32_t customLUT[CUSTOM_LUT_LENGTH]) = {
     /* Normal read mode -SDR */
     [4 * NOR_CMD_LUT_SEQ_IDX_READ_NORMAL] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x03, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x18),
@@ -76,26 +76,18 @@ const uint32_t customLUT[CUSTOM_LUT_LENGTH] = {
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0xC7, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 };
 
-static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base)
+MFLASH_RAMFUNC(static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base))
 {
     /* Wait status ready. */
     bool isBusy;
     uint32_t readValue;
     status_t status;
-    flexspi_transfer_t flashXfer;
     bool busyStatus = (bool)FLASH_BUSY_STATUS_POL;
-
-    flashXfer.deviceAddress = 0;
-    flashXfer.port          = FLASH_PORT;
-    flashXfer.cmdType       = kFLEXSPI_Read;
-    flashXfer.SeqNumber     = 1;
-    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READSTATUSREG;
-    flashXfer.data          = &readValue;
-    flashXfer.dataSize      = 1;
+    uint32_t ipcr1  = mflash_flexspi_ipcr1(base, NOR_CMD_LUT_SEQ_IDX_READSTATUSREG, 1U);
 
     do
     {
-        status = FLEXSPI_TransferBlocking(base, &flashXfer);
+        status = FLEXSPI_ReadRegisterFast(base, 0, ipcr1, &readValue);
 
         if (status != kStatus_Success)
         {
@@ -129,7 +121,7 @@ static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base)
     return status;
 }
 
-static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr)
+MFLASH_RAMFUNC(static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr))
 {
     flexspi_transfer_t flashXfer;
     status_t status;
@@ -147,7 +139,7 @@ static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr)
 }
 
 /* Internal - erase single sector */
-static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t address)
+MFLASH_RAMFUNC(static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t address))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -186,7 +178,9 @@ static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t addr
     return status;
 }
 
-static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstAddr, const uint32_t *src)
+MFLASH_RAMFUNC(static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base,
+                                                              uint32_t dstAddr,
+                                                              const uint32_t *src))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -237,7 +231,10 @@ static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstA
     return status;
 }
 
-static status_t flexspi_nor_read_data(FLEXSPI_Type *base, uint32_t startAddress, uint32_t *buffer, uint32_t length)
+MFLASH_RAMFUNC(static status_t flexspi_nor_read_data(FLEXSPI_Type *base,
+                                                     uint32_t startAddress,
+                                                     uint32_t *buffer,
+                                                     uint32_t length))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -262,7 +259,7 @@ static status_t flexspi_nor_read_data(FLEXSPI_Type *base, uint32_t startAddress,
     return status;
 }
 
-static int32_t mflash_drv_init_internal(void)
+MFLASH_RAMFUNC(static int32_t mflash_drv_init_internal(void))
 {
     uint32_t primask = __get_PRIMASK();
     flexspi_config_t config;
@@ -285,11 +282,8 @@ static int32_t mflash_drv_init_internal(void)
     /* Configure flash settings according to serial flash feature. */
     FLEXSPI_SetFlashConfig(MFLASH_FLEXSPI, &deviceconfig, FLASH_PORT);
 
-    uint32_t tmpLUT[CUSTOM_LUT_LENGTH] = {0x00U};
-
-    memcpy(tmpLUT, customLUT, sizeof(tmpLUT));
-    /* Update LUT table. */
-    FLEXSPI_UpdateLUT(MFLASH_FLEXSPI, 0, tmpLUT, CUSTOM_LUT_LENGTH);
+    /* Update LUT table, taken directly from RAM as the FLASH can not be read meanwhile. */
+    FLEXSPI_UpdateLUT(MFLASH_FLEXSPI, 0, customLUT, CUSTOM_LUT_LENGTH);
 
     //(void)flexspi_nor_enable_quad_mode(MFLASH_FLEXSPI);
 
@@ -319,7 +313,7 @@ int32_t mflash_drv_init(void)
 }
 
 /* Internal - erase single sector */
-static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr)
+MFLASH_RAMFUNC(static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr))
 {
     status_t status;
     uint32_t primask = __get_PRIMASK();
@@ -328,7 +322,7 @@ static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr)
 
     status = flexspi_nor_flash_sector_erase(MFLASH_FLEXSPI, sector_addr);
 
-    DCACHE_InvalidateByRange(MFLASH_BASE_ADDRESS + sector_addr, MFLASH_SECTOR_SIZE);
+    CACHE64_InvalidateCacheByRange(MFLASH_BASE_ADDRESS + sector_addr, MFLASH_SECTOR_SIZE);
 
     if (primask == 0U)
     {
@@ -356,7 +350,7 @@ int32_t mflash_drv_sector_erase(uint32_t sector_addr)
 }
 
 /* Internal - write single page */
-static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data)
+MFLASH_RAMFUNC(static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data))
 {
     uint32_t primask = __get_PRIMASK();
 
@@ -368,7 +362,7 @@ static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *da
     /* Do software reset. */
     // FLEXSPI_SoftwareReset(MFLASH_FLEXSPI);
 
-    DCACHE_InvalidateByRange(MFLASH_BASE_ADDRESS + page_addr, MFLASH_PAGE_SIZE);
+    CACHE64_InvalidateCacheByRange(MFLASH_BASE_ADDRESS + page_addr, MFLASH_PAGE_SIZE);
 
     if (primask == 0U)
     {
@@ -383,7 +377,7 @@ static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *da
 }
 
 /* Internal - read data */
-static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len)
+MFLASH_RAMFUNC(static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len))
 {
     uint32_t primask = __get_PRIMASK();
 
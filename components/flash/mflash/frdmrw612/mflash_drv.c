@@ -1,5 +1,5 @@
 /*
- * Copyright 2017-2022, 2024 NXP
+ * Copyright 2017-2022, 2024, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -50,7 +50,7 @@ static flexspi_device_config_t deviceconfig = {
     .AHBWriteWaitInterval = 0,
 };
 
-const uint32_t customLUT[CUSTOM_LUT_LENGTH] = {
+AT_QUICKACCESS_SECTION_DATA(const uint32_t customLUT[CUSTOM_LUT_LENGTH]) = {
     /* Normal read mode -SDR */
     [4 * NOR_CMD_LUT_SEQ_IDX_READ_NORMAL] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x13, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x20),
@@ -112,26 +112,18 @@ const uint32_t customLUT[CUSTOM_LUT_LENGTH] = {
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0xC7, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 };
 
-static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base)
+MFLASH_RAMFUNC(static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base))
 {
     /* Wait status ready. */
     bool isBusy;
     uint32_t readValue;
     status_t status;
-    flexspi_transfer_t flashXfer;
     bool busyStatus = (bool)FLASH_BUSY_STATUS_POL;
-
-    flashXfer.deviceAddress = 0;
-    flashXfer.port          = FLASH_PORT;
-    flashXfer.cmdType       = kFLEXSPI_Read;
-    flashXfer.SeqNumber     = 1;
-    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READSTATUSREG;
-    flashXfer.data          = &readValue;
-    flashXfer.dataSize      = 1;
+    uint32_t ipcr1  = mflash_flexspi_ipcr1(base, NOR_CMD_LUT_SEQ_IDX_READSTATUSREG, 1U);
 
     do
     {
-        status = FLEXSPI_TransferBlocking(base, &flashXfer);
+        status = FLEXSPI_ReadRegisterFast(base, 0, ipcr1, &readValue);
 
         if (status != kStatus_Success)
         {
@@ -165,7 +157,7 @@ static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base)
     return status;
 }
 
-static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr)
+MFLASH_RAMFUNC(static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr))
 {
     flexspi_transfer_t flashXfer;
     status_t status;
@@ -182,7 +174,7 @@ static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr)
     return status;
 }
 
-static status_t flexspi_nor_enable_quad_mode(FLEXSPI_Type *base)
+MFLASH_RAMFUNC(static status_t flexspi_nor_enable_quad_mode(FLEXSPI_Type *base))
 {
     flexspi_transfer_t flashXfer;
     status_t status;
@@ -219,8 +211,32 @@ static status_t flexspi_nor_enable_quad_mode(FLEXSPI_Type *base)
     return status;
 }
 
+/* Internal - read JEDEC ID, manufacturer ID followed by memory type and capacity */
+MFLASH_RAMFUNC(static status_t flexspi_nor_read_id(FLEXSPI_Type *base, uint32_t *id))
+{
+    flexspi_transfer_t flashXfer;
+    status_t status;
+
+    *id = 0U;
+
+    flashXfer.deviceAddress = 0;
+    flashXfer.port          = FLASH_PORT;
+    flashXfer.cmdType       = kFLEXSPI_Read;
+    flashXfer.SeqNumber     = 1;
+    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READID;
+    flashXfer.data          = id;
+    flashXfer.dataSize      = 3;
+
+    status = FLEXSPI_TransferBlocking(base, &flashXfer);
+
+    /* Do software reset. */
+    FLEXSPI_SoftwareReset(base);
+
+    return status;
+}
+
 /* Internal - erase single sector */
-static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t address)
+MFLASH_RAMFUNC(static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t address))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -259,7 +275,9 @@ static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t addr
     return status;
 }
 
-static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstAddr, const uint32_t *src)
+MFLASH_RAMFUNC(static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base,
+                                                              uint32_t dstAddr,
+                                                              const uint32_t *src))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -310,7 +328,10 @@ static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstA
     return status;
 }
 
-static status_t flexspi_nor_read_data(FLEXSPI_Type *base, uint32_t startAddress, uint32_t *buffer, uint32_t length)
+MFLASH_RAMFUNC(static status_t flexspi_nor_read_data(FLEXSPI_Type *base,
+                                                     uint32_t startAddress,
+                                                     uint32_t *buffer,
+                                                     uint32_t length))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -335,10 +356,15 @@ static status_t flexspi_nor_read_data(FLEXSPI_Type *base, uint32_t startAddress,
     return status;
 }
 
-static int32_t mflash_drv_init_internal(void)
+/* Size of the device detected by mflash_drv_init, 0 if not recognized */
+static uint32_t s_flashSize;
+
+MFLASH_RAMFUNC(static int32_t mflash_drv_init_internal(void))
 {
     uint32_t primask = __get_PRIMASK();
     flexspi_config_t config;
+    uint32_t id;
+    uint32_t capacity;
 
     __asm("cpsid i");
 
@@ -358,14 +384,27 @@ static int32_t mflash_drv_init_internal(void)
     /* Configure flash settings according to serial flash feature. */
     FLEXSPI_SetFlashConfig(MFLASH_FLEXSPI, &deviceconfig, FLASH_PORT);
 
-    uint32_t tmpLUT[CUSTOM_LUT_LENGTH] = {0x00U};
-
-    memcpy(tmpLUT, customLUT, sizeof(tmpLUT));
-    /* Update LUT table. */
-    FLEXSPI_UpdateLUT(MFLASH_FLEXSPI, 0, tmpLUT, CUSTOM_LUT_LENGTH);
+    /* Update LUT table, taken directly from RAM as the FLASH can not be read meanwhile. */
+    FLEXSPI_UpdateLUT(MFLASH_FLEXSPI, 0, customLUT, CUSTOM_LUT_LENGTH);
 
     (void)flexspi_nor_enable_quad_mode(MFLASH_FLEXSPI);
 
+    /* Capacity byte of JEDEC ID is log2 of the size in bytes up to 256Mb devices, larger ones continue from 0x20
+     * (512Mb). Devices not fitting the FLEXSPI window are not recognized. */
+    s_flashSize = 0U;
+    if (flexspi_nor_read_id(MFLASH_FLEXSPI, &id) == kStatus_Success)
+    {
+        capacity = (id >> 16) & 0xFFU;
+        if ((capacity >= 0x20U) && (capacity <= 0x22U))
+        {
+            capacity -= 6U;
+        }
+        if ((capacity >= 16U) && (capacity <= 28U) && ((1UL << capacity) <= MFLASH_BSIZE))
+        {
+            s_flashSize = 1UL << capacity;
+        }
+    }
+
     /* Invalidate cache. */
     do
     {
@@ -391,8 +430,14 @@ int32_t mflash_drv_init(void)
     return mflash_drv_init_internal();
 }
 
+/* API - size of the FLASH device */
+uint32_t mflash_drv_get_size(void)
+{
+    return s_flashSize;
+}
+
 /* Internal - erase single sector */
-static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr)
+MFLASH_RAMFUNC(static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr))
 {
     status_t status;
     uint32_t primask = __get_PRIMASK();
@@ -401,7 +446,7 @@ static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr)
 
     status = flexspi_nor_flash_sector_erase(MFLASH_FLEXSPI, sector_addr);
 
-    DCACHE_InvalidateByRange(MFLASH_BASE_ADDRESS + sector_addr, MFLASH_SECTOR_SIZE);
+    CACHE64_InvalidateCacheByRange(MFLASH_BASE_ADDRESS + sector_addr, MFLASH_SECTOR_SIZE);
 
     if (primask == 0U)
     {
@@ -429,7 +474,7 @@ int32_t mflash_drv_sector_erase(uint32_t sector_addr)
 }
 
 /* Internal - write single page */
-static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data)
+MFLASH_RAMFUNC(static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data))
 {
     uint32_t primask = __get_PRIMASK();
 
@@ -441,7 +486,7 @@ static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *da
     /* Do software reset. */
     // FLEXSPI_SoftwareReset(MFLASH_FLEXSPI);
 
-    DCACHE_InvalidateByRange(MFLASH_BASE_ADDRESS + page_addr, MFLASH_PAGE_SIZE);
+    CACHE64_InvalidateCacheByRange(MFLASH_BASE_ADDRESS + page_addr, MFLASH_PAGE_SIZE);
 
     if (primask == 0U)
     {
@@ -456,7 +501,7 @@ static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *da
 }
 
 /* Internal - read data */
-static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len)
+MFLASH_RAMFUNC(static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len))
 {
     uint32_t primask = __get_PRIMASK();
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2017-2021,2024 NXP
+ * Copyright 2017-2021,2024, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -28,8 +28,11 @@
 #define MFLASH_BASE_ADDRESS (FlexSPI_AMBA_PC_CACHE_BASE)
 #endif
 
-/* Flash size expressed in bytes: 64MB */
+/* Size of the FLEXSPI window mapped to the FLASH: 64MB, upper bound of supported devices. Size of the device actually
+ * populated is returned by mflash_drv_get_size. */
+#ifndef MFLASH_BSIZE
 #define MFLASH_BSIZE 0x04000000UL
+#endif
 
 #define MFLASH_REMAP_OFFSET() (MFLASH_FLEXSPI->HADDROFFSET & FLEXSPI_HADDROFFSET_ADDROFFSET_MASK)
 #define MFLASH_REMAP_START()  (MFLASH_FLEXSPI->HADDRSTART & FLEXSPI_HADDRSTART_ADDRSTART_MASK)
@@ -37,4 +40,7 @@
 
 #define MFLASH_REMAP_ACTIVE() (MFLASH_REMAP_OFFSET() != 0UL)
 
+/*! @brief Returns size of the FLASH device in bytes detected by mflash_drv_init from JEDEC ID, 0 if not recognized */
+uint32_t mflash_drv_get_size(void);
+
 #endif
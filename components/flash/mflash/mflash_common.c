@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mflash_common.h"
+#include "fsl_common.h"
+
+/* CRC-32 (IEEE 802.3), nibble table keeps the scan fast without the space of the byte table */
+uint32_t mflash_crc32(uint32_t crc, const void *data, uint32_t size)
+{
+    static const uint32_t table[16] = {0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U,
+                                       0x4DB26158U, 0x5005713CU, 0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+                                       0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU};
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (size-- > 0U)
+    {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 0xFU];
+        crc = (crc >> 4) ^ table[crc & 0xFU];
+    }
+
+    return ~crc;
+}
+
+bool mflash_is_blank(const void *data, uint32_t size)
+{
+    const uint32_t *p = (const uint32_t *)data;
+
+    for (uint32_t i = 0U; i < size / sizeof(uint32_t); i++)
+    {
+        if (p[i] != 0xFFFFFFFFU)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void mflash_sector_header_init(mflash_sector_header_t *hdr, uint32_t magic, uint32_t sequence)
+{
+    hdr->magic        = magic;
+    hdr->sequence     = sequence;
+    hdr->sequence_inv = ~sequence;
+}
+
+/* Returns sequence number of the sector, false if it does not hold a valid header */
+static bool mflash_sector_seq(mflash_sector_header_fn_t header, uint32_t sector, uint32_t magic, uint32_t *seq)
+{
+    const mflash_sector_header_t *hdr = header(sector);
+
+    if ((hdr == NULL) || (hdr->magic != magic) || (hdr->sequence_inv != ~hdr->sequence))
+    {
+        return false;
+    }
+
+    *seq = hdr->sequence;
+    return true;
+}
+
+void mflash_sector_ring_find(mflash_sector_ring_t *ring,
+                             uint32_t sectors,
+                             uint32_t max_used,
+                             uint32_t magic,
+                             mflash_sector_header_fn_t header)
+{
+    uint32_t seq;
+
+    (void)memset(ring, 0, sizeof(*ring));
+
+    /* Head is the sector with the highest sequence number */
+    for (uint32_t sector = 0U; sector < sectors; sector++)
+    {
+        if (mflash_sector_seq(header, sector, magic, &seq) &&
+            ((ring->used == 0U) || ((int32_t)(seq - ring->head_seq) > 0)))
+        {
+            ring->head     = sector;
+            ring->head_seq = seq;
+            ring->used     = 1U;
+        }
+    }
+
+    /* Sectors in use precede it with consecutive sequence numbers */
+    ring->tail = ring->head;
+    while ((ring->used != 0U) && (ring->used < max_used))
+    {
+        uint32_t prev = (ring->tail + sectors - 1U) % sectors;
+
+        if (!mflash_sector_seq(header, prev, magic, &seq) || (seq != ring->head_seq - ring->used))
+        {
+            break;
+        }
+        ring->tail = prev;
+        ring->used++;
+    }
+}
+
+#if defined(FSL_FEATURE_SOC_FLEXSPI_COUNT) && FSL_FEATURE_SOC_FLEXSPI_COUNT
+/* Equivalent of FLEXSPI_GetIpCommandConfig for single sequence without the parameter checks */
+MFLASH_RAMFUNC(uint32_t mflash_flexspi_ipcr1(FLEXSPI_Type *base, uint32_t seq_index, uint32_t data_size))
+{
+    return (base->IPCR1 & ~(FLEXSPI_IPCR1_IDATSZ_MASK | FLEXSPI_IPCR1_ISEQID_MASK | FLEXSPI_IPCR1_ISEQNUM_MASK)) |
+           FLEXSPI_IPCR1_IDATSZ(data_size) | FLEXSPI_IPCR1_ISEQID(seq_index);
+}
+
+/* Equivalent of FLEXSPI_ResetFifos(base, false, true) */
+MFLASH_RAMFUNC(void mflash_flexspi_clear_ip_rx(FLEXSPI_Type *base))
+{
+    base->IPRXFCR |= FLEXSPI_IPRXFCR_CLRIPRXF_MASK;
+}
+
+/* Equivalent of polling FLEXSPI_GetBusIdleStatus */
+MFLASH_RAMFUNC(void mflash_flexspi_wait_idle(FLEXSPI_Type *base))
+{
+    const uint32_t idle = FLEXSPI_STS0_ARBIDLE_MASK | FLEXSPI_STS0_SEQIDLE_MASK;
+
+    while ((base->STS0 & idle) != idle)
+    {
+    }
+}
+#endif
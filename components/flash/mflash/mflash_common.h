@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2020 NXP
+ * Copyright 2018-2020, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -21,6 +21,77 @@
 #define mflash_drv_is_page_aligned(x)   (((x) % (MFLASH_PAGE_SIZE)) == 0U)
 #define mflash_drv_is_sector_aligned(x) (((x) % (MFLASH_SECTOR_SIZE)) == 0U)
 
+/*
+ * Code executed while FLASH is being programmed/erased or FLEXSPI is being reconfigured, hence it can not execute in
+ * place. Linker files place "MflashRamFunc" section to RAM together with fsl_flexspi and fsl_cache drivers, the GCC one
+ * also fails the link if any of this code references code or constants left in FLASH. Static inline helpers of the SDK
+ * drivers and assert are not inlined by unoptimized (debug) builds, such code uses the mflash_flexspi helpers below
+ * instead. May be defined empty for builds running entirely from RAM.
+ */
+#ifndef MFLASH_RAMFUNC
+#if defined(__ICCARM__)
+#define MFLASH_RAMFUNC(func) func @"MflashRamFunc"
+#else
+#define MFLASH_RAMFUNC(func) __attribute__((section("MflashRamFunc"), __noinline__)) func
+#endif
+#endif
+
+#if defined(FSL_FEATURE_SOC_FLEXSPI_COUNT) && FSL_FEATURE_SOC_FLEXSPI_COUNT
+/*******************************************************************************
+ * FLEXSPI helpers placed in MflashRamFunc
+ ******************************************************************************/
+
+/*! @brief Returns IPCR1 value of IP command executing single LUT sequence with given data size */
+uint32_t mflash_flexspi_ipcr1(FLEXSPI_Type *base, uint32_t seq_index, uint32_t data_size);
+
+/*! @brief Drops data left in the IP RX FIFO */
+void mflash_flexspi_clear_ip_rx(FLEXSPI_Type *base);
+
+/*! @brief Waits until the arbitrator and the sequence engine are idle */
+void mflash_flexspi_wait_idle(FLEXSPI_Type *base);
+#endif
+
+/*******************************************************************************
+ * Helpers of the stores built on the driver
+ ******************************************************************************/
+
+/* Header at the start of each sector of a store appending to a ring of sectors (mflash_kv, mflash_ts) */
+typedef struct _mflash_sector_header
+{
+    uint32_t magic;
+    uint32_t sequence;     /* Incremented with each sector started, sectors in use carry consecutive numbers */
+    uint32_t sequence_inv; /* Inverted sequence, detects incomplete header */
+} mflash_sector_header_t;
+
+/* Sectors of the ring in use */
+typedef struct _mflash_sector_ring
+{
+    uint32_t tail;     /* Oldest sector in use */
+    uint32_t head;     /* Newest sector in use */
+    uint32_t used;     /* Sectors in use, 0 for empty store */
+    uint32_t head_seq; /* Sequence number of the head sector */
+} mflash_sector_ring_t;
+
+/*! @brief Returns header of the sector of the ring, NULL if it can not hold a valid one */
+typedef const mflash_sector_header_t *(*mflash_sector_header_fn_t)(uint32_t sector);
+
+/*! @brief Returns CRC-32 (IEEE 802.3) of the data, crc of preceding data continues the computation, 0 starts it */
+uint32_t mflash_crc32(uint32_t crc, const void *data, uint32_t size);
+
+/*! @brief Checks word aligned data of size multiple of 4 reads as erased */
+bool mflash_is_blank(const void *data, uint32_t size);
+
+/*! @brief Fills in the header of sector started with given sequence number */
+void mflash_sector_header_init(mflash_sector_header_t *hdr, uint32_t magic, uint32_t sequence);
+
+/*! @brief Finds the sectors in use, the head holds the highest sequence number and up to max_used sectors preceding it
+ * carry consecutive numbers. Sectors with invalid header or other magic are free. */
+void mflash_sector_ring_find(mflash_sector_ring_t *ring,
+                             uint32_t sectors,
+                             uint32_t max_used,
+                             uint32_t magic,
+                             mflash_sector_header_fn_t header);
+
 /*
  * The addresses of FLASH locations used by APIs below may not correspond with the addresses space, especially when
  * FLASH remapping is being used. Use mflash_drv_phys2log/log2phys API to obtain actual pointer or physical address.
@@ -1,5 +1,5 @@
 /*
- * Copyright 2017-2020 NXP
+ * Copyright 2017-2020, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,12 +17,53 @@
 #include "mflash_drv.h"
 #include "fsl_common.h"
 
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+#include "mflash_partition.h"
+#endif
+
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+#include "mcuxClEls.h"
+#include "mcuxCsslFlowProtection.h"
+#include "mcuxClCore_FunctionIdentifiers.h"
+#endif
+
 /* Magic numbers to check for presence of the structures below */
-#define MFLASH_DIR_MAGIC_NO  (0xF17E07ABu)
+#define MFLASH_DIR_MAGIC_NO (0xF17E07ABu)
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+/* Files carrying a digest use distinct magic so that files saved without it are not misinterpreted */
+#define MFLASH_META_MAGIC_NO (0xABECEDA9u)
+#else
 #define MFLASH_META_MAGIC_NO (0xABECEDA8u)
-#define MFLASH_FS_VERSION    (0x00010000u)
+#endif
+#define MFLASH_FS_VERSION_V1 (0x00010000u)
+#define MFLASH_FS_VERSION    (0x00020000u)
+#define MFLASH_FS_MAJOR_MASK (0xFFFF0000u)
 #define MFLASH_BLANK_PATTERN (0xFFu)
 
+/* Marks the end of the v2 directory (erased record header) and v2 padding records */
+#define MFLASH_DIR_V2_END      (0xFFFFu)
+#define MFLASH_DIR_V2_PAD      (0xFFFFu)
+#define MFLASH_DIR_V2_ALIGN    (4u)
+/* Size of the leading rec_size and path_len fields, padding records at the end of a page may be this short */
+#define MFLASH_DIR_V2_HDR_SIZE (2u * sizeof(uint16_t))
+#define MFLASH_DIR_V2_PATH_MAX (MFLASH_PAGE_SIZE - sizeof(mflash_fs_header_v2_t) - sizeof(mflash_dir_record_v2_t))
+
+/* Space reserved in the v2 directory for records appended after formatting */
+#ifndef MFLASH_DIR_RESERVE
+#define MFLASH_DIR_RESERVE (MFLASH_SECTOR_SIZE / 2u)
+#endif
+
+/*
+ * Appending records to the directory re-programs directory pages that already contain data (only erased bytes are
+ * changed). This is not possible on platforms with page integrity checks, on these any directory change falls back to
+ * re-formatting.
+ */
+#if defined(MFLASH_PAGE_INTEGRITY_CHECKS) && MFLASH_PAGE_INTEGRITY_CHECKS
+#define MFLASH_DIR_CAN_GROW (0)
+#else
+#define MFLASH_DIR_CAN_GROW (1)
+#endif
+
 #if defined(__CC_ARM) || defined(__ARMCC_VERSION)
 // linker symbols imported as described in https://www.keil.com/support/man/docs/armlink/armlink_pge1362065952432.htm
 extern char Image$$mflash_fs$$Base[];
@@ -37,6 +78,7 @@ static uint32_t static_pagebuf[MFLASH_PAGE_SIZE / sizeof(uint32_t)];
 #endif
 
 /*
+ * Version 1 layout (read only)
  * The table header and table record structures have to be aligned
  * with pages/sectors that are expected to be of 2**n size, hence there is some padding
  */
@@ -58,57 +100,192 @@ typedef struct
     uint8_t padding[sizeof(mflash_dir_record_t) - 6 * sizeof(uint32_t)];
 } mflash_fs_header_t;
 
+/*
+ * Version 2 layout
+ * The header shares the leading fields with version 1. It is followed by variable length records packed in the
+ * directory area, a record never crosses a page boundary. Records are appended to the first erased location, the last
+ * record matching a path is the valid one, so a file may be relocated by appending a new record for it.
+ */
+typedef struct
+{
+    uint32_t magic_no;
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t sector_size;
+    uint32_t dir_size; /* Size of the area reserved for the directory including this header */
+    uint32_t reserved;
+} mflash_fs_header_v2_t;
+
+typedef struct
+{
+    uint16_t rec_size; /* Size of the whole record, multiple of 4, MFLASH_DIR_V2_END in erased area */
+    uint16_t path_len; /* Length of the path without terminator, MFLASH_DIR_V2_PAD for padding records */
+    uint32_t file_offset;
+    uint32_t alloc_size;
+    uint8_t path[];
+} mflash_dir_record_v2_t;
+
 typedef struct
 {
     mflash_fs_header_t header;
     mflash_dir_record_t records[];
 } mflash_fs_t;
 
+/* Access to the version 2 header, the leading fields are common to both versions */
+#define MFLASH_FS_HEADER_V2(fs) ((mflash_fs_header_v2_t *)(void *)&(fs)->header)
+
+/* Directory entry as seen by the rest of the code regardless of the directory format */
+typedef struct
+{
+    uint32_t file_offset;
+    uint32_t alloc_size;
+} mflash_dir_entry_t;
+
 /* Metadata prepended to the file itself to identify valid (already written) file and keep actual length of the file */
 typedef struct
 {
     uint32_t file_size;
     uint32_t magic_no;
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+    uint8_t digest[MCUXCLELS_HASH_OUTPUT_SIZE_SHA_256]; /* SHA-256 of the file data */
+#endif
 } mflash_file_meta_t;
 
 /* Pointer to the filesystem */
 static mflash_fs_t *g_mflash_fs = NULL;
 
-/* API - True if mflash is already initialized */
-bool mflash_is_initialized(void)
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+/* Number of files whose digest verification result is kept for the session */
+#ifndef MFLASH_FILE_DIGEST_CACHE_SIZE
+#define MFLASH_FILE_DIGEST_CACHE_SIZE (8u)
+#endif
+
+/* Offsets of files already verified since boot, zero marks unused entry as no file starts at offset zero */
+static uint32_t g_mflash_verified[MFLASH_FILE_DIGEST_CACHE_SIZE];
+static uint32_t g_mflash_verified_next = 0;
+
+/* Run single ELS hash operation and wait for its completion */
+static bool mflash_els_hash(mcuxClEls_HashOption_t options, const uint8_t *input, uint32_t size, uint8_t *output)
 {
-    return (g_mflash_fs != NULL);
+    bool retval = true;
+
+    MCUX_CSSL_FP_FUNCTION_CALL_BEGIN(result, token, mcuxClEls_Hash_Async(options, input, size, output));
+    if ((MCUX_CSSL_FP_FUNCTION_CALLED(mcuxClEls_Hash_Async) != token) || (MCUXCLELS_STATUS_OK_WAIT != result))
+    {
+        retval = false;
+    }
+    MCUX_CSSL_FP_FUNCTION_CALL_END();
+
+    if (retval)
+    {
+        MCUX_CSSL_FP_FUNCTION_CALL_BEGIN(result, token, mcuxClEls_WaitForOperation(MCUXCLELS_ERROR_FLAGS_CLEAR));
+        if ((MCUX_CSSL_FP_FUNCTION_CALLED(mcuxClEls_WaitForOperation) != token) || (MCUXCLELS_STATUS_OK != result))
+        {
+            retval = false;
+        }
+        MCUX_CSSL_FP_FUNCTION_CALL_END();
+    }
+
+    return retval;
 }
 
-/* Store path string to directory record structure */
-static bool dir_path_store(mflash_dir_record_t *dr, const char *path)
+/*
+ * Compute SHA-256 of given data using the ELS hash engine. Whole blocks are fed to the engine directly from where the
+ * data resides (memory mapped FLASH or RAM), only the trailing partial block and the padding go through a RAM buffer.
+ * The ELS is expected to be enabled already (done by boot ROM on RW61x).
+ */
+static status_t mflash_file_digest(const uint8_t *data, uint32_t size, uint8_t *digest)
 {
-    assert(dr);
-    assert(path);
-
-    for (int i = 0; i < MFLASH_MAX_PATH_LEN; i++)
+    /* Two blocks at most are needed to hold the tail, the padding byte and the 64-bit length */
+    static uint32_t tail_buf[2u * MCUXCLELS_HASH_BLOCK_SIZE_SHA_256 / sizeof(uint32_t)];
+    /* The engine outputs whole state which happens to be the digest size for SHA-256 */
+    static uint32_t state_buf[MCUXCLELS_HASH_STATE_SIZE_SHA_256 / sizeof(uint32_t)];
+    uint8_t *tail      = (uint8_t *)tail_buf;
+    uint32_t bulk_size = size & ~(MCUXCLELS_HASH_BLOCK_SIZE_SHA_256 - 1u);
+    uint32_t tail_size = size - bulk_size;
+    uint32_t pad_size  = MCUXCLELS_HASH_BLOCK_SIZE_SHA_256;
+    uint64_t bit_len   = (uint64_t)size * 8u;
+    mcuxClEls_HashOption_t options = {0U};
+
+    if (tail_size + 1u + sizeof(bit_len) > MCUXCLELS_HASH_BLOCK_SIZE_SHA_256)
     {
-        dr->path[i] = (uint8_t)(*path);
+        pad_size = 2u * MCUXCLELS_HASH_BLOCK_SIZE_SHA_256;
+    }
 
-        /* End of string, exit the loop */
-        if (*path == '\0')
+    options.bits.hashini = MCUXCLELS_HASH_INIT_ENABLE;
+    options.bits.hashmd  = MCUXCLELS_HASH_MODE_SHA_256;
+
+    /* Stream the whole blocks without copying, the engine keeps the intermediate state */
+    if (bulk_size != 0u)
+    {
+        if (!mflash_els_hash(options, data, bulk_size, NULL))
         {
-            break;
+            return kStatus_Fail;
         }
+        options.bits.hashini = MCUXCLELS_HASH_INIT_DISABLE;
+    }
 
-        path++;
+    /* Final block(s) with standard padding, length is big endian */
+    (void)memset(tail, 0, pad_size);
+    (void)memcpy(tail, data + bulk_size, tail_size);
+    tail[tail_size] = 0x80u;
+    for (uint32_t i = 0; i < sizeof(bit_len); i++)
+    {
+        tail[pad_size - 1u - i] = (uint8_t)(bit_len >> (8u * i));
     }
 
-    /* Check whether the whole given path string was processed */
-    if (*path != '\0')
+    options.bits.hashoe = MCUXCLELS_HASH_OUTPUT_ENABLE;
+    if (!mflash_els_hash(options, tail, pad_size, (uint8_t *)state_buf))
     {
-        return false;
+        return kStatus_Fail;
     }
 
-    return true;
+    (void)memcpy(digest, state_buf, MCUXCLELS_HASH_OUTPUT_SIZE_SHA_256);
+
+    return kStatus_Success;
+}
+
+/* Check whether file at given offset was already verified during this session */
+static bool mflash_file_verified_get(uint32_t file_offset)
+{
+    for (uint32_t i = 0; i < MFLASH_FILE_DIGEST_CACHE_SIZE; i++)
+    {
+        if (g_mflash_verified[i] == file_offset)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-/* Match path string against directory record */
+/* Remember successful verification, the oldest entry is replaced once the cache is full */
+static void mflash_file_verified_set(uint32_t file_offset)
+{
+    g_mflash_verified[g_mflash_verified_next] = file_offset;
+    g_mflash_verified_next = (g_mflash_verified_next + 1u) % MFLASH_FILE_DIGEST_CACHE_SIZE;
+}
+
+/* Forget verification result, the file content is about to change */
+static void mflash_file_verified_clear(uint32_t file_offset)
+{
+    for (uint32_t i = 0; i < MFLASH_FILE_DIGEST_CACHE_SIZE; i++)
+    {
+        if (g_mflash_verified[i] == file_offset)
+        {
+            g_mflash_verified[i] = 0;
+        }
+    }
+}
+#endif
+
+/* API - True if mflash is already initialized */
+bool mflash_is_initialized(void)
+{
+    return (g_mflash_fs != NULL);
+}
+
+/* Match path string against v1 directory record */
 static bool dir_path_match(mflash_dir_record_t *dr, const char *path)
 {
     assert(dr);
@@ -139,6 +316,28 @@ static bool dir_path_match(mflash_dir_record_t *dr, const char *path)
     return true;
 }
 
+/* Match path string against v2 directory record */
+static bool dir_path_match_v2(const mflash_dir_record_v2_t *dr, const char *path, uint32_t path_len)
+{
+    assert(dr);
+    assert(path);
+
+    if (dr->path_len != path_len)
+    {
+        return false;
+    }
+
+    return (memcmp(dr->path, path, path_len) == 0);
+}
+
+/* Size of v2 directory record for given path length */
+static inline uint32_t dir_record_v2_size(uint32_t path_len)
+{
+    uint32_t rec_size = sizeof(mflash_dir_record_v2_t) + path_len;
+
+    return (rec_size + MFLASH_DIR_V2_ALIGN - 1u) & ~(MFLASH_DIR_V2_ALIGN - 1u);
+}
+
 /* Buffer allocation wrapper */
 static void *mflash_page_buf_get(void)
 {
@@ -239,10 +438,28 @@ static status_t mflash_readable_check(void *ptr, uint32_t size)
 #endif
 }
 
+/* Returns true if the filesystem uses the version 2 directory format */
+static inline bool mflash_fs_is_v2(mflash_fs_t *fs)
+{
+    return ((fs->header.version & MFLASH_FS_MAJOR_MASK) == (MFLASH_FS_VERSION & MFLASH_FS_MAJOR_MASK));
+}
+
+/* Size of the directory area including the header */
+static uint32_t mflash_dir_size(mflash_fs_t *fs)
+{
+    if (mflash_fs_is_v2(fs))
+    {
+        return MFLASH_FS_HEADER_V2(fs)->dir_size;
+    }
+
+    return sizeof(mflash_fs_header_t) + fs->header.file_count * sizeof(mflash_dir_record_t);
+}
+
 /* Check for filesystem presence and validity */
 static status_t mflash_fs_check(mflash_fs_t *fs)
 {
     status_t status;
+    uint32_t major;
 
     /* Check params */
     if (fs == NULL)
@@ -263,8 +480,9 @@ static status_t mflash_fs_check(mflash_fs_t *fs)
         return kStatus_Fail;
     }
 
-    /* Check major version */
-    if ((fs->header.version & 0xFFFF0000u) != (MFLASH_FS_VERSION & 0xFFFF0000u))
+    /* Check major version, version 1 directories are still accepted */
+    major = fs->header.version & MFLASH_FS_MAJOR_MASK;
+    if ((major != (MFLASH_FS_VERSION & MFLASH_FS_MAJOR_MASK)) && (major != (MFLASH_FS_VERSION_V1 & MFLASH_FS_MAJOR_MASK)))
     {
         return kStatus_Fail;
     }
@@ -275,15 +493,20 @@ static status_t mflash_fs_check(mflash_fs_t *fs)
         return kStatus_Fail;
     }
 
+    /* The v2 directory area is allocated in whole sectors */
+    if (mflash_fs_is_v2(fs) && ((mflash_dir_size(fs) == 0u) || !mflash_drv_is_sector_aligned(mflash_dir_size(fs))))
+    {
+        return kStatus_Fail;
+    }
+
     /* Check readability of the whole directory */
-    status =
-        mflash_readable_check(fs, sizeof(mflash_fs_header_t) + fs->header.file_count * sizeof(mflash_dir_record_t));
+    status = mflash_readable_check(fs, mflash_dir_size(fs));
 
     return status;
 }
 
 /* Check for presence of a file data */
-static status_t mflash_file_check(mflash_fs_t *fs, mflash_dir_record_t *dr)
+static status_t mflash_file_check(mflash_fs_t *fs, mflash_dir_entry_t *dr)
 {
     status_t status;
     mflash_file_meta_t *meta;
@@ -327,9 +550,72 @@ static status_t mflash_file_check(mflash_fs_t *fs, mflash_dir_record_t *dr)
     return kStatus_Success;
 }
 
+/*
+ * Walks v2 directory records. Starting at *offset, returns pointer to the next record carrying a path and advances
+ * *offset past it. Returns NULL at the end of the directory, *offset then points to the first erased location.
+ */
+static mflash_dir_record_v2_t *mflash_dir_v2_next(mflash_fs_t *fs, uint32_t *offset)
+{
+    uint32_t dir_size = MFLASH_FS_HEADER_V2(fs)->dir_size;
+
+    while (*offset + MFLASH_DIR_V2_HDR_SIZE <= dir_size)
+    {
+        mflash_dir_record_v2_t *dr = mflash_fs_get_ptr(fs, *offset);
+
+        /* Erased location, end of the directory */
+        if (dr->rec_size == MFLASH_DIR_V2_END)
+        {
+            break;
+        }
+
+        /* Corrupted record, stop here rather than walking out of the directory. Padding records fill the gap up to
+         * the page end, which may be shorter than a record carrying a path. */
+        if ((dr->rec_size < MFLASH_DIR_V2_HDR_SIZE) || ((dr->rec_size % MFLASH_DIR_V2_ALIGN) != 0u) ||
+            (*offset + dr->rec_size > dir_size) ||
+            ((dr->path_len != MFLASH_DIR_V2_PAD) && (dr->rec_size < dir_record_v2_size(dr->path_len))))
+        {
+            break;
+        }
+
+        *offset += dr->rec_size;
+
+        if (dr->path_len != MFLASH_DIR_V2_PAD)
+        {
+            return dr;
+        }
+    }
+
+    return NULL;
+}
+
 /* Searches for directory record with given path and retrieves a copy of it */
-static status_t mflash_dir_lookup(mflash_fs_t *fs, const char *path, mflash_dir_record_t *dr_ptr)
+static status_t mflash_dir_lookup(mflash_fs_t *fs, const char *path, mflash_dir_entry_t *dr_ptr)
 {
+    status_t status = kStatus_Fail;
+
+    if (mflash_fs_is_v2(fs))
+    {
+        uint32_t path_len = strlen(path);
+        uint32_t offset   = sizeof(mflash_fs_header_v2_t);
+        mflash_dir_record_v2_t *dr;
+
+        /* Walk the whole directory, the last matching record is the valid one */
+        while ((dr = mflash_dir_v2_next(fs, &offset)) != NULL)
+        {
+            if (dir_path_match_v2(dr, path, path_len))
+            {
+                if (NULL != dr_ptr)
+                {
+                    dr_ptr->file_offset = dr->file_offset;
+                    dr_ptr->alloc_size  = dr->alloc_size;
+                }
+                status = kStatus_Success;
+            }
+        }
+
+        return status;
+    }
+
     uint32_t file_count     = fs->header.file_count;
     mflash_dir_record_t *dr = fs->records;
 
@@ -339,14 +625,100 @@ static status_t mflash_dir_lookup(mflash_fs_t *fs, const char *path, mflash_dir_
         {
             if (NULL != dr_ptr)
             {
-                *dr_ptr = *dr;
+                dr_ptr->file_offset = dr->file_offset;
+                dr_ptr->alloc_size  = dr->alloc_size;
             }
             return kStatus_Success;
         }
         dr++;
     }
 
-    return kStatus_Fail;
+    return status;
+}
+
+/* Returns offset of the first byte past all file extents referenced by the v2 directory */
+static uint32_t mflash_dir_v2_extent_end(mflash_fs_t *fs)
+{
+    uint32_t offset = sizeof(mflash_fs_header_v2_t);
+    uint32_t end    = MFLASH_FS_HEADER_V2(fs)->dir_size;
+    mflash_dir_record_v2_t *dr;
+
+    while ((dr = mflash_dir_v2_next(fs, &offset)) != NULL)
+    {
+        if (dr->file_offset + dr->alloc_size > end)
+        {
+            end = dr->file_offset + dr->alloc_size;
+        }
+    }
+
+    return end;
+}
+
+/*
+ * Appends a record to the v2 directory. Only the erased bytes of the affected page are programmed, the rest of the page
+ * buffer is left blank so the already present records are not altered.
+ */
+static status_t mflash_dir_v2_append(mflash_fs_t *fs, void *page_buf, const char *path, const mflash_dir_entry_t *de)
+{
+    status_t status;
+    uint32_t path_len = strlen(path);
+    uint32_t rec_size = dir_record_v2_size(path_len);
+    uint32_t dir_size = MFLASH_FS_HEADER_V2(fs)->dir_size;
+    uint32_t offset   = sizeof(mflash_fs_header_v2_t);
+    uint32_t page_offset;
+
+    if (path_len > MFLASH_DIR_V2_PATH_MAX)
+    {
+        return kStatus_OutOfRange;
+    }
+
+    /* Find the first erased location */
+    while (mflash_dir_v2_next(fs, &offset) != NULL)
+    {
+    }
+
+    /* The walk may also stop at a corrupted record, never program over it */
+    if ((offset + sizeof(uint16_t) <= dir_size) &&
+        (((mflash_dir_record_v2_t *)mflash_fs_get_ptr(fs, offset))->rec_size != MFLASH_DIR_V2_END))
+    {
+        return kStatus_Fail;
+    }
+
+    (void)memset(page_buf, (int)MFLASH_BLANK_PATTERN, MFLASH_PAGE_SIZE);
+    page_offset = offset - offset % MFLASH_PAGE_SIZE;
+
+    /* Records never cross page boundary, fill the rest of the page with padding record if necessary */
+    if ((offset % MFLASH_PAGE_SIZE) + rec_size > MFLASH_PAGE_SIZE)
+    {
+        mflash_dir_record_v2_t *pad = (mflash_dir_record_v2_t *)((uint8_t *)page_buf + offset % MFLASH_PAGE_SIZE);
+        pad->rec_size               = (uint16_t)(MFLASH_PAGE_SIZE - offset % MFLASH_PAGE_SIZE);
+        pad->path_len               = MFLASH_DIR_V2_PAD;
+
+        status = mflash_fs_page_program(fs, page_offset, page_buf);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        (void)memset(page_buf, (int)MFLASH_BLANK_PATTERN, MFLASH_PAGE_SIZE);
+        offset      = page_offset + MFLASH_PAGE_SIZE;
+        page_offset = offset;
+    }
+
+    /* Check for enough space in the directory area */
+    if (offset + rec_size > dir_size)
+    {
+        return kStatus_OutOfRange;
+    }
+
+    mflash_dir_record_v2_t *dr = (mflash_dir_record_v2_t *)((uint8_t *)page_buf + offset % MFLASH_PAGE_SIZE);
+    dr->rec_size               = (uint16_t)rec_size;
+    dr->path_len               = (uint16_t)path_len;
+    dr->file_offset            = de->file_offset;
+    dr->alloc_size             = de->alloc_size;
+    (void)memcpy(dr->path, path, path_len);
+
+    return mflash_fs_page_program(fs, page_offset, page_buf);
 }
 
 /* Create filesystem structure in FLASH according to given directory template */
@@ -357,35 +729,36 @@ static status_t mflash_format_internal(mflash_fs_t *fs,
 {
     status_t status;
 
-    uint32_t file_count;
     uint32_t total_sectors;
 
     uint32_t dir_size;
     uint32_t dir_sectors;
 
     uint32_t file_offset;
-    uint32_t dir_offset;
-
-    mflash_fs_header_t *fsh;
 
-    /* The directory records shall be aligned to page size */
-    assert((MFLASH_PAGE_SIZE % sizeof(mflash_dir_record_t)) == 0u);
+    mflash_fs_header_v2_t *fsh;
 
-    /* Count the files and calculate number of FLASH sectors to be occupied by the filesystem */
-    file_count    = 0;
-    total_sectors = 0;
+    /* Calculate size of the directory, the reserve leaves room for records appended later and for padding at page
+     * boundaries */
+    dir_size = sizeof(mflash_fs_header_v2_t) + MFLASH_DIR_RESERVE;
     for (const mflash_file_t *dt = dir_template; (NULL != dt->path) && ('\0' != dt->path[0]) && (0 != dt->max_size);
          dt++)
     {
-        /* Calculate number of sectors to be occupied by the file */
-        uint32_t file_sectors = (dt->max_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE;
-        total_sectors += file_sectors;
-        file_count++;
+        if (strlen(dt->path) > MFLASH_DIR_V2_PATH_MAX)
+        {
+            return kStatus_OutOfRange;
+        }
+        dir_size += dir_record_v2_size(strlen(dt->path));
     }
+    dir_sectors   = (dir_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE;
+    total_sectors = dir_sectors;
 
-    dir_size    = file_count * sizeof(mflash_dir_record_t) + sizeof(mflash_fs_header_t);
-    dir_sectors = (dir_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE;
-    total_sectors += dir_sectors;
+    /* Calculate number of FLASH sectors to be occupied by the files */
+    for (const mflash_file_t *dt = dir_template; (NULL != dt->path) && ('\0' != dt->path[0]) && (0 != dt->max_size);
+         dt++)
+    {
+        total_sectors += (dt->max_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE;
+    }
 
     /* Check whether the filestytem fits into the given FLASH area */
     if ((0u != fs_size_limit) && (fs_size_limit < total_sectors * MFLASH_SECTOR_SIZE))
@@ -403,60 +776,56 @@ static status_t mflash_format_internal(mflash_fs_t *fs,
         }
     }
 
-    /* Clear the page buffer and set inital values for offsets */
+    /* Create filesystem header at the very beginning of the first page, it is programmed together with the records
+     * fitting into the first page, the rest of the records is appended afterwards */
     (void)memset(page_buf, (int)MFLASH_BLANK_PATTERN, MFLASH_PAGE_SIZE);
-    dir_offset  = file_count * sizeof(mflash_dir_record_t) + sizeof(mflash_fs_header_t);
-    file_offset = total_sectors * MFLASH_SECTOR_SIZE;
-
-    /* Create directory entries in reverse order so that programming of the page containing the dir header is the last
-     * step */
-    for (uint32_t fi = file_count; 0u != fi--;)
-    {
-        /* Check for enough space for the directory record */
-        assert(dir_offset >= sizeof(mflash_dir_record_t));
-
-        dir_offset -= sizeof(mflash_dir_record_t);
-
-        mflash_dir_record_t *dr = (mflash_dir_record_t *)((uint8_t *)page_buf + (dir_offset % MFLASH_PAGE_SIZE));
-        const mflash_file_t *dt = &dir_template[fi];
+    fsh              = (mflash_fs_header_v2_t *)page_buf;
+    fsh->magic_no    = MFLASH_DIR_MAGIC_NO;
+    fsh->version     = MFLASH_FS_VERSION;
+    fsh->page_size   = MFLASH_PAGE_SIZE;
+    fsh->sector_size = MFLASH_SECTOR_SIZE;
+    fsh->dir_size    = dir_sectors * MFLASH_SECTOR_SIZE;
 
-        /* Calculate number of sectors to be occupied by the file */
-        uint32_t file_sectors = (dt->max_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE;
+    uint32_t dir_offset = sizeof(mflash_fs_header_v2_t);
+    file_offset         = dir_sectors * MFLASH_SECTOR_SIZE;
 
-        /* Fill in directory record */
-        dr->alloc_size  = file_sectors * MFLASH_SECTOR_SIZE;
-        dr->file_offset = (file_offset -= dr->alloc_size);
-        dir_path_store(dr, dt->path);
+    const mflash_file_t *dt = dir_template;
+    for (; (NULL != dt->path) && ('\0' != dt->path[0]) && (0 != dt->max_size); dt++)
+    {
+        uint32_t path_len = strlen(dt->path);
+        uint32_t rec_size = dir_record_v2_size(path_len);
 
-        if (dir_offset % MFLASH_PAGE_SIZE == 0u)
+        if (dir_offset + rec_size > MFLASH_PAGE_SIZE)
         {
-            /* We reached the beginning of a page, program it and start over */
-            status = mflash_fs_page_program(fs, dir_offset, page_buf);
-            if (status != kStatus_Success)
-            {
-                return status;
-            }
-
-            /* Clear the page buffer */
-            (void)memset(page_buf, (int)MFLASH_BLANK_PATTERN, MFLASH_PAGE_SIZE);
+            break;
         }
-    }
 
-    /* There should be space left exactly for the filesystem header */
-    assert(dir_offset == sizeof(mflash_fs_header_t));
+        mflash_dir_record_v2_t *dr = (mflash_dir_record_v2_t *)((uint8_t *)page_buf + dir_offset);
+        dr->rec_size               = (uint16_t)rec_size;
+        dr->path_len               = (uint16_t)path_len;
+        dr->alloc_size             = ((dt->max_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE) * MFLASH_SECTOR_SIZE;
+        dr->file_offset            = file_offset;
+        (void)memcpy(dr->path, dt->path, path_len);
 
-    /* Create filesystem header at the very beginning of the first page */
-    fsh              = (mflash_fs_header_t *)page_buf;
-    fsh->magic_no    = MFLASH_DIR_MAGIC_NO;
-    fsh->version     = MFLASH_FS_VERSION;
-    fsh->page_size   = MFLASH_PAGE_SIZE;
-    fsh->sector_size = MFLASH_SECTOR_SIZE;
-    fsh->total_size  = total_sectors * MFLASH_SECTOR_SIZE;
-    fsh->file_count  = file_count;
+        file_offset += dr->alloc_size;
+        dir_offset += rec_size;
+    }
 
     /* Programming of the first page puts header into place marking the filesystem as valid */
     status = mflash_fs_page_program(fs, 0, page_buf);
 
+    /* Remaining records go to the following pages */
+    for (; (status == kStatus_Success) && (NULL != dt->path) && ('\0' != dt->path[0]) && (0 != dt->max_size); dt++)
+    {
+        mflash_dir_entry_t de;
+
+        de.alloc_size  = ((dt->max_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE) * MFLASH_SECTOR_SIZE;
+        de.file_offset = file_offset;
+        file_offset += de.alloc_size;
+
+        status = mflash_dir_v2_append(fs, page_buf, dt->path, &de);
+    }
+
     return status;
 }
 
@@ -497,7 +866,7 @@ static status_t mflash_template_match(mflash_fs_t *fs, const mflash_file_t *dir_
     for (const mflash_file_t *dt = dir_template; (NULL != dt->path) && ('\0' != dt->path[0]) && (0u != dt->max_size);
          dt++)
     {
-        mflash_dir_record_t dr;
+        mflash_dir_entry_t dr;
 
         /* Lookup directory record */
         status = mflash_dir_lookup(fs, dt->path, &dr);
@@ -516,6 +885,139 @@ static status_t mflash_template_match(mflash_fs_t *fs, const mflash_file_t *dir_
     return kStatus_Success;
 }
 
+static status_t mflash_file_save_internal(
+    mflash_fs_t *fs, void *page_buf, mflash_dir_entry_t *dr, const uint8_t *data, uint32_t size);
+
+/*
+ * Grow v2 directory to match given template. Files missing in the directory get a new extent appended past the
+ * existing ones. Files with insufficient pre-allocated size are relocated to a new extent with their current content,
+ * the rest of the filesystem is left untouched. A file owning the last extent is extended in place, other relocated
+ * files leave their old extent unused until the filesystem is re-formatted, which happens once the region is full.
+ * Growth needs the size of the region, without it the area past the extents may belong to someone else.
+ */
+static status_t mflash_dir_grow_internal(mflash_fs_t *fs,
+                                         void *page_buf,
+                                         uint32_t fs_size_limit,
+                                         const mflash_file_t *dir_template)
+{
+    status_t status;
+    uint32_t extent_end = mflash_dir_v2_extent_end(fs);
+
+    if (0u == fs_size_limit)
+    {
+        return kStatus_OutOfRange;
+    }
+
+    for (const mflash_file_t *dt = dir_template; (NULL != dt->path) && ('\0' != dt->path[0]) && (0u != dt->max_size);
+         dt++)
+    {
+        mflash_dir_entry_t old_de;
+        mflash_dir_entry_t new_de;
+        bool relocate = false;
+        bool in_place = false;
+
+        status = mflash_dir_lookup(fs, dt->path, &old_de);
+        if (status == kStatus_Success)
+        {
+            if (old_de.alloc_size >= dt->max_size)
+            {
+                continue;
+            }
+            relocate = (mflash_file_check(fs, &old_de) == kStatus_Success);
+            in_place = (old_de.file_offset + old_de.alloc_size == extent_end);
+        }
+
+        new_de.file_offset = in_place ? old_de.file_offset : extent_end;
+        new_de.alloc_size  = ((dt->max_size + MFLASH_SECTOR_SIZE - 1) / MFLASH_SECTOR_SIZE) * MFLASH_SECTOR_SIZE;
+
+        if (fs_size_limit < new_de.file_offset + new_de.alloc_size)
+        {
+            return kStatus_OutOfRange;
+        }
+
+        status = kStatus_Success;
+        if (in_place)
+        {
+            /* Content stays where it is, only the sectors added past the extents may contain stale data */
+            uint32_t new_end = new_de.file_offset + new_de.alloc_size;
+
+            for (uint32_t offset = extent_end; (status == kStatus_Success) && (offset < new_end);
+                 offset += MFLASH_SECTOR_SIZE)
+            {
+                status = mflash_fs_sector_erase(fs, offset);
+            }
+
+            /* Invalid file starts empty, as if it was new */
+            if ((status == kStatus_Success) && !relocate)
+            {
+                status = mflash_fs_sector_erase(fs, new_de.file_offset);
+            }
+        }
+        else if (relocate)
+        {
+            /* Copy the current content to the new extent before the record pointing to it is appended */
+            mflash_file_meta_t *meta = mflash_fs_get_ptr(fs, old_de.file_offset);
+            status = mflash_file_save_internal(fs, page_buf, &new_de, (const uint8_t *)(meta + 1), meta->file_size);
+        }
+        else
+        {
+            /* The area past the extents may contain stale data, erase the sector holding the file meta */
+            status = mflash_fs_sector_erase(fs, new_de.file_offset);
+        }
+
+        if (status == kStatus_Success)
+        {
+            status = mflash_dir_v2_append(fs, page_buf, dt->path, &new_de);
+        }
+
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        extent_end = new_de.file_offset + new_de.alloc_size;
+    }
+
+    return kStatus_Success;
+}
+
+/* Grow existing filesystem to match the template without re-formatting it */
+static status_t mflash_dir_grow(mflash_fs_t *fs, uint32_t fs_size_limit, const mflash_file_t *dir_template)
+{
+    status_t status;
+    void *page_buf;
+
+#if !MFLASH_DIR_CAN_GROW
+    return kStatus_Fail;
+#else
+    /* Version 1 directories are fixed, these are converted by re-formatting */
+    if (!mflash_fs_is_v2(fs))
+    {
+        return kStatus_Fail;
+    }
+
+    /* Get page buffer for FLASH writes */
+    page_buf = mflash_page_buf_get();
+    if (page_buf == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    status = mflash_dir_grow_internal(fs, page_buf, fs_size_limit, dir_template);
+
+    /* Release page buffer */
+    mflash_page_buf_release(page_buf);
+
+    /* Directory full, fall back to re-formatting */
+    if (status == kStatus_OutOfRange)
+    {
+        status = kStatus_Fail;
+    }
+
+    return status;
+#endif
+}
+
 /* Initialize mflash filesystem */
 static status_t mflash_fs_init(mflash_fs_t *fs, uint32_t fs_size_limit, const mflash_file_t *dir_template)
 {
@@ -528,6 +1030,12 @@ static status_t mflash_fs_init(mflash_fs_t *fs, uint32_t fs_size_limit, const mf
     if (status == kStatus_Success)
     {
         status = mflash_template_match(fs, dir_template);
+
+        /* Try to add the missing files to the existing directory first */
+        if (status == kStatus_Fail)
+        {
+            status = mflash_dir_grow(fs, fs_size_limit, dir_template);
+        }
     }
 
     /* The filesystem not present or does not fit the template, create a new one */
@@ -537,6 +1045,11 @@ static status_t mflash_fs_init(mflash_fs_t *fs, uint32_t fs_size_limit, const mf
         status = mflash_format(fs, fs_size_limit, dir_template); /* Format the filestem */
     }
 
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+    /* Files may have been moved by re-formatting or growing the directory */
+    (void)memset(g_mflash_verified, 0, sizeof(g_mflash_verified));
+#endif
+
     if (status == kStatus_Success)
     {
         g_mflash_fs = fs; /* If all went ok, keep pointer to the filesytem */
@@ -545,11 +1058,16 @@ static status_t mflash_fs_init(mflash_fs_t *fs, uint32_t fs_size_limit, const mf
     return status;
 }
 
-/* API - Initialize mflash driver and filesystem at default address specified by linker symbol */
+/* API - Initialize mflash driver and filesystem in its partition, at MFLASH_FILE_BASEADDR or at default address
+ * specified by linker symbol */
 status_t mflash_init(const mflash_file_t *dir_template, bool init_drv)
 {
     status_t status;
     mflash_fs_t *fs;
+    uint32_t fs_size_limit = 0u;
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    const mflash_partition_t *part;
+#endif
 
     /* Initialize the driver */
     if (init_drv)
@@ -561,9 +1079,23 @@ status_t mflash_init(const mflash_file_t *dir_template, bool init_drv)
         }
     }
 
-#ifdef MFLASH_FILE_BASEADDR
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    /* Region given by the partition table, loaded by mflash_part_init */
+    part = mflash_part_find((uint32_t)kMflashPart_File);
+    if (part == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    fs            = (mflash_fs_t *)mflash_drv_phys2log(part->offset, part->size);
+    fs_size_limit = part->size;
+#elif defined(MFLASH_FILE_BASEADDR)
     /* Convert physical address in FLASH to memory pointer */
     fs = (mflash_fs_t *)mflash_drv_phys2log(MFLASH_FILE_BASEADDR, 0);
+#if defined(MFLASH_FILE_SIZE)
+    /* Size of the region, the directory can grow within it */
+    fs_size_limit = MFLASH_FILE_SIZE;
+#endif
 #else
     /* Otherwise take address from linker file */
     fs = (mflash_fs_t *)MFLASH_FS_START;
@@ -574,12 +1106,12 @@ status_t mflash_init(const mflash_file_t *dir_template, bool init_drv)
         return kStatus_Fail;
     }
 
-    return mflash_fs_init(fs, 0, dir_template);
+    return mflash_fs_init(fs, fs_size_limit, dir_template);
 }
 
 /* Save file */
 static status_t mflash_file_save_internal(
-    mflash_fs_t *fs, void *page_buf, mflash_dir_record_t *dr, const uint8_t *data, uint32_t size)
+    mflash_fs_t *fs, void *page_buf, mflash_dir_entry_t *dr, const uint8_t *data, uint32_t size)
 {
     status_t status;
 
@@ -589,6 +1121,10 @@ static status_t mflash_file_save_internal(
         return kStatus_OutOfRange;
     }
 
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+    mflash_file_verified_clear(dr->file_offset);
+#endif
+
     /* Erase the whole file area sector by sector */
     for (uint32_t sector_offset = 0; sector_offset < dr->alloc_size; sector_offset += MFLASH_SECTOR_SIZE)
     {
@@ -640,6 +1176,15 @@ static status_t mflash_file_save_internal(
     meta->file_size          = size;
     meta->magic_no           = MFLASH_META_MAGIC_NO;
 
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+    /* Digest of the source data, any programming error is caught by the verification on first access */
+    status = mflash_file_digest(data, size, meta->digest);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+#endif
+
     /* Program the first page putting the metadata in place which marks the file as valid */
     status = mflash_fs_page_program(fs, dr->file_offset, page_buf);
 
@@ -650,7 +1195,7 @@ static status_t mflash_file_save_internal(
 status_t mflash_file_save(const char *path, const uint8_t *data, uint32_t size)
 {
     status_t status;
-    mflash_dir_record_t dr;
+    mflash_dir_entry_t dr;
     mflash_fs_t *fs = g_mflash_fs;
     void *page_buf;
 
@@ -678,8 +1223,14 @@ status_t mflash_file_save(const char *path, const uint8_t *data, uint32_t size)
         return kStatus_Fail;
     }
 
-    /* Save the file */
+    /* Save the file, cache lines of the whole file area are invalidated at once when done */
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_begin();
+#endif
     status = mflash_file_save_internal(fs, page_buf, &dr, data, size);
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_end();
+#endif
 
     /* Release page buffer */
     mflash_page_buf_release(page_buf);
@@ -688,7 +1239,7 @@ status_t mflash_file_save(const char *path, const uint8_t *data, uint32_t size)
 }
 
 /* Get direct pointer to file data */
-static status_t mflash_file_mmap_internal(mflash_fs_t *fs, mflash_dir_record_t *dr, const uint8_t **pdata, uint32_t *psize)
+static status_t mflash_file_mmap_internal(mflash_fs_t *fs, mflash_dir_entry_t *dr, const uint8_t **pdata, uint32_t *psize)
 {
     status_t status;
     mflash_file_meta_t *meta;
@@ -701,6 +1252,27 @@ static status_t mflash_file_mmap_internal(mflash_fs_t *fs, mflash_dir_record_t *
 
     meta = mflash_fs_get_ptr(fs, dr->file_offset);
 
+#if defined(MFLASH_FILE_DIGEST) && MFLASH_FILE_DIGEST
+    /* Verify content of the file on its first access, hashing directly from the memory mapped FLASH */
+    if (!mflash_file_verified_get(dr->file_offset))
+    {
+        uint32_t digest[MCUXCLELS_HASH_OUTPUT_SIZE_SHA_256 / sizeof(uint32_t)];
+
+        status = mflash_file_digest((uint8_t *)meta + sizeof(*meta), meta->file_size, (uint8_t *)digest);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        if (memcmp(digest, meta->digest, sizeof(digest)) != 0)
+        {
+            return kStatus_Fail;
+        }
+
+        mflash_file_verified_set(dr->file_offset);
+    }
+#endif
+
     *pdata = (uint8_t *)meta + sizeof(*meta);
     *psize = meta->file_size;
 
@@ -711,7 +1283,7 @@ static status_t mflash_file_mmap_internal(mflash_fs_t *fs, mflash_dir_record_t *
 status_t mflash_file_mmap(const char *path, const uint8_t **pdata, uint32_t *psize)
 {
     status_t status;
-    mflash_dir_record_t dr;
+    mflash_dir_entry_t dr;
     mflash_fs_t *fs = g_mflash_fs;
 
     if (path == NULL)
@@ -1,5 +1,5 @@
 /*
- * Copyright 2017-2020 NXP
+ * Copyright 2017-2020, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,6 +11,7 @@
 
 #include "mflash_drv.h"
 
+/* Maximum path length in version 1 directories, version 2 directories store paths of variable length */
 #define MFLASH_MAX_PATH_LEN 56
 
 /*
@@ -26,13 +27,16 @@ typedef struct
 /*! @brief Initialization status of mflash subsystem */
 bool mflash_is_initialized(void);
 
-/*! @brief Initializes mflash filesystem and driver. Creates new filesystem unless already in place. */
+/*! @brief Initializes mflash filesystem and driver. Creates new filesystem unless already in place. Files of the
+ * template missing in an existing filesystem are appended to its directory without affecting the other files, this
+ * requires the size of the region (partition table or MFLASH_FILE_SIZE), otherwise the filesystem is re-formatted. */
 status_t mflash_init(const mflash_file_t *dir_template, bool init_drv);
 
 /*! @brief Saves data to file with given path. */
 status_t mflash_file_save(const char *path, const uint8_t *data, uint32_t size);
 
-/*! @brief Returns pointer for direct memory mapped access to file data. */
+/*! @brief Returns pointer for direct memory mapped access to file data. With MFLASH_FILE_DIGEST enabled, the file
+ * content is verified against the digest stored at save time on its first access. */
 status_t mflash_file_mmap(const char *path, const uint8_t **pdata, uint32_t *psize);
 
 #endif
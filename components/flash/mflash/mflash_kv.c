@@ -0,0 +1,637 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mflash_kv.h"
+#include "mflash_drv.h"
+#include "fsl_common.h"
+
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+#include "mflash_partition.h"
+#endif
+
+/* Magic number of sector header, version is part of it */
+#define MFLASH_KV_SECTOR_MAGIC (0x4B565331U) /* "KVS1" */
+
+/* Record flags, value records leave the byte erased */
+#define MFLASH_KV_FLAGS_VALUE   (0xFFU)
+#define MFLASH_KV_FLAGS_DELETED (0x00U)
+
+/* Unused index entry */
+#define MFLASH_KV_EMPTY (0xFFFFFFFFU)
+
+#define MFLASH_KV_MAX_KEYS (MFLASH_KV_INDEX_SIZE / 4U * 3U)
+
+#if (MFLASH_KV_INDEX_SIZE & (MFLASH_KV_INDEX_SIZE - 1U)) != 0U
+#error "MFLASH_KV_INDEX_SIZE has to be power of 2"
+#endif
+
+/* Header at the start of each sector in use */
+typedef struct
+{
+    mflash_sector_header_t header;
+    uint32_t reserved;
+} mflash_kv_sector_t;
+
+/* Record header followed by the key (without terminator), the value and padding to multiple of 4 */
+typedef struct
+{
+    uint16_t value_len;
+    uint8_t key_len; /* Never 0 */
+    uint8_t flags;
+    uint32_t crc; /* CRC-32 of the fields above, the key and the value */
+} mflash_kv_record_t;
+
+#define MFLASH_KV_DATA_START (sizeof(mflash_kv_sector_t))
+#define MFLASH_KV_REC_SIZE(key_len, value_len) \
+    ((sizeof(mflash_kv_record_t) + (uint32_t)(key_len) + (uint32_t)(value_len) + 3U) & ~3U)
+
+/* Index entry, hash is kept to avoid comparing keys in FLASH on most probes */
+typedef struct
+{
+    uint32_t hash;
+    uint32_t addr; /* Physical address of the latest record of the key, MFLASH_KV_EMPTY for unused entry */
+} mflash_kv_entry_t;
+
+typedef struct
+{
+    const uint8_t *mapped; /* Memory mapped address of the first sector, NULL until initialized */
+    uint32_t base;         /* Physical address of the first sector */
+    uint32_t sectors;      /* Number of sectors */
+    uint32_t tail;         /* Oldest sector in use */
+    uint32_t head;         /* Sector records are appended to */
+    uint32_t used;         /* Sectors in use, 0 for empty store */
+    uint32_t head_seq;     /* Sequence number of the head sector */
+    uint32_t head_off;     /* Offset of the first free byte in the head sector */
+    uint32_t keys;
+    uint32_t live_bytes;
+    uint32_t collections;
+    bool collecting;
+} mflash_kv_t;
+
+static status_t mflash_kv_reserve(uint32_t size);
+
+static mflash_kv_t s_kv;
+static mflash_kv_entry_t s_index[MFLASH_KV_INDEX_SIZE];
+static uint32_t s_pageBuf[MFLASH_PAGE_SIZE / sizeof(uint32_t)];
+
+/* FNV-1a */
+static uint32_t mflash_kv_hash(const char *key, uint32_t key_len)
+{
+    uint32_t hash = 0x811C9DC5U;
+
+    for (uint32_t i = 0U; i < key_len; i++)
+    {
+        hash = (hash ^ (uint8_t)key[i]) * 0x01000193U;
+    }
+
+    return hash;
+}
+
+static const mflash_kv_record_t *mflash_kv_record(uint32_t addr)
+{
+    return (const mflash_kv_record_t *)(const void *)(s_kv.mapped + (addr - s_kv.base));
+}
+
+static uint32_t mflash_kv_sector_addr(uint32_t sector)
+{
+    return s_kv.base + sector * MFLASH_SECTOR_SIZE;
+}
+
+static const mflash_sector_header_t *mflash_kv_sector_header(uint32_t sector)
+{
+    return &((const mflash_kv_sector_t *)(const void *)(s_kv.mapped + sector * MFLASH_SECTOR_SIZE))->header;
+}
+
+/* Index entry of the key, or the unused entry where it is to be inserted */
+static uint32_t mflash_kv_lookup(const char *key, uint32_t key_len, uint32_t hash)
+{
+    uint32_t i = hash & (MFLASH_KV_INDEX_SIZE - 1U);
+
+    /* Terminates as the index is never full */
+    while (s_index[i].addr != MFLASH_KV_EMPTY)
+    {
+        if (s_index[i].hash == hash)
+        {
+            const mflash_kv_record_t *rec = mflash_kv_record(s_index[i].addr);
+
+            if ((rec->key_len == key_len) && (memcmp(rec + 1, key, key_len) == 0))
+            {
+                break;
+            }
+        }
+        i = (i + 1U) & (MFLASH_KV_INDEX_SIZE - 1U);
+    }
+
+    return i;
+}
+
+/* Removes entry by shifting back the following ones of the same probe sequence */
+static void mflash_kv_index_remove(uint32_t i)
+{
+    uint32_t mask = MFLASH_KV_INDEX_SIZE - 1U;
+    uint32_t j    = i;
+
+    for (;;)
+    {
+        j = (j + 1U) & mask;
+        if (s_index[j].addr == MFLASH_KV_EMPTY)
+        {
+            break;
+        }
+
+        /* Entry may move to the gap unless its home position lies cyclically between the gap and its place */
+        if (((j - s_index[j].hash) & mask) >= ((j - i) & mask))
+        {
+            s_index[i] = s_index[j];
+            i          = j;
+        }
+    }
+
+    s_index[i].addr = MFLASH_KV_EMPTY;
+}
+
+/* Makes the index refer to the record at given address, the newest record of the key */
+static status_t mflash_kv_index_update(uint32_t addr)
+{
+    const mflash_kv_record_t *rec = mflash_kv_record(addr);
+    const char *key               = (const char *)(rec + 1);
+    uint32_t hash                 = mflash_kv_hash(key, rec->key_len);
+    uint32_t i                    = mflash_kv_lookup(key, rec->key_len, hash);
+
+    if (s_index[i].addr != MFLASH_KV_EMPTY)
+    {
+        const mflash_kv_record_t *old = mflash_kv_record(s_index[i].addr);
+
+        s_kv.live_bytes -= MFLASH_KV_REC_SIZE(old->key_len, old->value_len);
+    }
+    else if (rec->flags == MFLASH_KV_FLAGS_DELETED)
+    {
+        return kStatus_Success;
+    }
+    else if (s_kv.keys >= MFLASH_KV_MAX_KEYS)
+    {
+        return kStatus_Fail;
+    }
+    else
+    {
+        s_index[i].hash = hash;
+        s_kv.keys++;
+    }
+
+    if (rec->flags == MFLASH_KV_FLAGS_DELETED)
+    {
+        mflash_kv_index_remove(i);
+        s_kv.keys--;
+    }
+    else
+    {
+        s_index[i].addr = addr;
+        s_kv.live_bytes += MFLASH_KV_REC_SIZE(rec->key_len, rec->value_len);
+    }
+
+    return kStatus_Success;
+}
+
+/* Erases the sector unless it is blank already and writes its header, it becomes the head */
+static status_t mflash_kv_open_sector(void)
+{
+    mflash_kv_sector_t *hdr = (mflash_kv_sector_t *)(void *)s_pageBuf;
+    uint32_t sector         = (s_kv.used == 0U) ? s_kv.head : ((s_kv.head + 1U) % s_kv.sectors);
+    status_t status         = kStatus_Success;
+
+    if (s_kv.used >= s_kv.sectors)
+    {
+        return kStatus_Fail;
+    }
+
+    /* Free sectors are erased by collection, anything else is a leftover of an interrupted operation */
+    if (!mflash_is_blank(s_kv.mapped + sector * MFLASH_SECTOR_SIZE, MFLASH_SECTOR_SIZE))
+    {
+        status = mflash_drv_sector_erase(mflash_kv_sector_addr(sector));
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+    (void)memset(s_pageBuf, 0xFF, sizeof(s_pageBuf));
+    mflash_sector_header_init(&hdr->header, MFLASH_KV_SECTOR_MAGIC, s_kv.head_seq + 1U);
+
+    status = mflash_drv_page_program(mflash_kv_sector_addr(sector), s_pageBuf);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    if (s_kv.used == 0U)
+    {
+        s_kv.tail = sector;
+    }
+    s_kv.head     = sector;
+    s_kv.head_seq = s_kv.head_seq + 1U;
+    s_kv.head_off = MFLASH_KV_DATA_START;
+    s_kv.used++;
+
+    return kStatus_Success;
+}
+
+/* Appends record given by its header, key and value to the head, single page program */
+static status_t mflash_kv_append(const mflash_kv_record_t *hdr, const void *key, const void *value, uint32_t *paddr)
+{
+    uint32_t size = MFLASH_KV_REC_SIZE(hdr->key_len, hdr->value_len);
+    uint32_t page = s_kv.head_off & ~(MFLASH_PAGE_SIZE - 1U);
+    uint8_t *rec  = (uint8_t *)s_pageBuf + (s_kv.head_off - page);
+    status_t status;
+
+    (void)memset(s_pageBuf, 0xFF, sizeof(s_pageBuf));
+    (void)memcpy(rec, hdr, sizeof(*hdr));
+    (void)memcpy(rec + sizeof(*hdr), key, hdr->key_len);
+    if (hdr->value_len != 0U)
+    {
+        (void)memcpy(rec + sizeof(*hdr) + hdr->key_len, value, hdr->value_len);
+    }
+
+    status = mflash_drv_page_program(mflash_kv_sector_addr(s_kv.head) + page, s_pageBuf);
+    if (status != kStatus_Success)
+    {
+        /* The page may hold part of the record, nothing more is appended to it */
+        s_kv.head_off = page + MFLASH_PAGE_SIZE;
+        return status;
+    }
+
+    *paddr = mflash_kv_sector_addr(s_kv.head) + s_kv.head_off;
+    s_kv.head_off += size;
+
+    return kStatus_Success;
+}
+
+/*
+ * Walks valid records of the sector. On scan (collect false) the index is updated by each record and the offset of
+ * the first free byte is returned, on collection the records the index refers to are appended to the head. Each page
+ * is walked from its start, invalid record makes the rest of the page unusable.
+ */
+static status_t mflash_kv_walk(uint32_t sector, bool collect, uint32_t *pend)
+{
+    const uint8_t *data = s_kv.mapped + sector * MFLASH_SECTOR_SIZE;
+    uint32_t end        = MFLASH_KV_DATA_START;
+    status_t status     = kStatus_Success;
+
+    for (uint32_t page = 0U; (page < MFLASH_SECTOR_SIZE) && (status == kStatus_Success); page += MFLASH_PAGE_SIZE)
+    {
+        uint32_t page_end = page + MFLASH_PAGE_SIZE;
+        uint32_t off      = (page == 0U) ? MFLASH_KV_DATA_START : page;
+
+        while ((off + sizeof(mflash_kv_record_t) <= page_end) && (status == kStatus_Success))
+        {
+            const mflash_kv_record_t *rec = (const mflash_kv_record_t *)(const void *)(data + off);
+            uint32_t size                 = MFLASH_KV_REC_SIZE(rec->key_len, rec->value_len);
+
+            if (mflash_is_blank(data + off, sizeof(*rec)))
+            {
+                /* End of the page data, unless something was programmed past the record header */
+                if (!mflash_is_blank(data + off, page_end - off))
+                {
+                    end = page_end;
+                }
+                else if (off != page)
+                {
+                    end = off;
+                }
+                else
+                {
+                    /* Blank page */
+                }
+                break;
+            }
+
+            if ((rec->key_len == 0U) || (rec->key_len > MFLASH_KV_KEY_MAX) || (size > page_end - off) ||
+                (rec->crc != mflash_crc32(mflash_crc32(0U, rec, offsetof(mflash_kv_record_t, crc)), rec + 1,
+                                           (uint32_t)rec->key_len + rec->value_len)))
+            {
+                end = page_end;
+                break;
+            }
+
+            if (!collect)
+            {
+                status = mflash_kv_index_update(mflash_kv_sector_addr(sector) + off);
+            }
+            else if (rec->flags != MFLASH_KV_FLAGS_DELETED)
+            {
+                const char *key = (const char *)(rec + 1);
+                uint32_t i      = mflash_kv_lookup(key, rec->key_len, mflash_kv_hash(key, rec->key_len));
+                uint32_t addr;
+
+                /* Deleted keys and outdated values are dropped, so are deletion records as no older record of
+                 * their keys remains */
+                if (s_index[i].addr == mflash_kv_sector_addr(sector) + off)
+                {
+                    status = mflash_kv_reserve(size);
+                    if (status == kStatus_Success)
+                    {
+                        status = mflash_kv_append(rec, key, key + rec->key_len, &addr);
+                    }
+                    if (status == kStatus_Success)
+                    {
+                        s_index[i].addr = addr;
+                    }
+                }
+            }
+            else
+            {
+                /* Deletion record */
+            }
+
+            off += size;
+            end = off;
+        }
+    }
+
+    if (pend != NULL)
+    {
+        *pend = end;
+    }
+
+    return status;
+}
+
+/* Collects the tail sector, records still in use are appended to the head and the sector is erased */
+static status_t mflash_kv_collect(void)
+{
+    uint32_t tail = s_kv.tail;
+    status_t status;
+
+    s_kv.collecting = true;
+    status          = mflash_kv_walk(tail, true, NULL);
+    s_kv.collecting = false;
+
+    if (status == kStatus_Success)
+    {
+        status = mflash_drv_sector_erase(mflash_kv_sector_addr(tail));
+    }
+
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    s_kv.tail = (tail + 1U) % s_kv.sectors;
+    s_kv.used--;
+    s_kv.collections++;
+
+    return kStatus_Success;
+}
+
+/*
+ * Makes room for record of given size in the head, skipping the rest of the page if the record does not fit it.
+ * New sector is started while another erased one remains, that one is kept for collection which may need it for the
+ * records it moves. The records of the collected sector packed from the start of a sector can not take more space
+ * than they did in the collected sector, so the single sector is enough.
+ */
+static status_t mflash_kv_reserve(uint32_t size)
+{
+    status_t status;
+
+    for (uint32_t i = 0U;; i++)
+    {
+        if (s_kv.used != 0U)
+        {
+            uint32_t page_left = MFLASH_PAGE_SIZE - (s_kv.head_off % MFLASH_PAGE_SIZE);
+
+            if (page_left < size)
+            {
+                s_kv.head_off += page_left;
+            }
+
+            if (s_kv.head_off + size <= MFLASH_SECTOR_SIZE)
+            {
+                return kStatus_Success;
+            }
+        }
+
+        if (s_kv.collecting || ((s_kv.sectors - s_kv.used) > 1U))
+        {
+            status = mflash_kv_open_sector();
+        }
+        else if (i < s_kv.sectors)
+        {
+            status = mflash_kv_collect();
+        }
+        else
+        {
+            /* Each sector was collected without freeing space, all the data is live */
+            status = kStatus_Fail;
+        }
+
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+}
+
+/* Appends value or deletion record of the key */
+static status_t mflash_kv_write(const char *key, const void *value, uint32_t size, uint8_t flags)
+{
+    mflash_kv_record_t hdr;
+    uint32_t key_len;
+    uint32_t i;
+    uint32_t addr;
+    status_t status;
+
+    if (s_kv.mapped == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    if ((key == NULL) || ((value == NULL) && (size != 0U)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    key_len = strlen(key);
+    if ((key_len == 0U) || (key_len > MFLASH_KV_KEY_MAX) || (size > MFLASH_KV_VALUE_MAX(key_len)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    i = mflash_kv_lookup(key, key_len, mflash_kv_hash(key, key_len));
+    if (s_index[i].addr == MFLASH_KV_EMPTY)
+    {
+        if (flags == MFLASH_KV_FLAGS_DELETED)
+        {
+            return kStatus_Success;
+        }
+
+        if (s_kv.keys >= MFLASH_KV_MAX_KEYS)
+        {
+            return kStatus_Fail;
+        }
+    }
+    else if (flags == MFLASH_KV_FLAGS_VALUE)
+    {
+        const mflash_kv_record_t *rec = mflash_kv_record(s_index[i].addr);
+
+        /* Rewriting the same value would only wear the FLASH */
+        if ((rec->value_len == size) && (memcmp((const uint8_t *)(rec + 1) + key_len, value, size) == 0))
+        {
+            return kStatus_Success;
+        }
+    }
+    else
+    {
+        /* Deletion of existing key */
+    }
+
+    hdr.value_len = (uint16_t)size;
+    hdr.key_len   = (uint8_t)key_len;
+    hdr.flags     = flags;
+    hdr.crc       = mflash_crc32(0U, &hdr, offsetof(mflash_kv_record_t, crc));
+    hdr.crc       = mflash_crc32(hdr.crc, key, key_len);
+    hdr.crc       = mflash_crc32(hdr.crc, value, size);
+
+    status = mflash_kv_reserve(MFLASH_KV_REC_SIZE(key_len, size));
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    status = mflash_kv_append(&hdr, key, value, &addr);
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    return mflash_kv_index_update(addr);
+}
+
+/* API - initialize the store and build the index */
+status_t mflash_kv_init(bool init_drv)
+{
+    uint32_t base = MFLASH_KV_BASEADDR;
+    uint32_t size = MFLASH_KV_SIZE;
+    mflash_sector_ring_t ring;
+    status_t status;
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    const mflash_partition_t *part;
+#endif
+
+    if (init_drv)
+    {
+        status = mflash_drv_init();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    /* Table loaded by mflash_part_init */
+    part = mflash_part_find((uint32_t)kMflashPart_Kv);
+    if (part == NULL)
+    {
+        return kStatus_Fail;
+    }
+    base = part->offset;
+    size = part->size;
+#endif
+
+    /* At least one sector for data, one for the head and one kept for collection */
+    if (!mflash_drv_is_sector_aligned(base) || !mflash_drv_is_sector_aligned(size) ||
+        (size < 3U * MFLASH_SECTOR_SIZE))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    (void)memset(&s_kv, 0, sizeof(s_kv));
+    (void)memset(s_index, 0xFF, sizeof(s_index));
+
+    s_kv.mapped = (const uint8_t *)mflash_drv_phys2log(base, size);
+    if (s_kv.mapped == NULL)
+    {
+        return kStatus_Fail;
+    }
+    s_kv.base    = base;
+    s_kv.sectors = size / MFLASH_SECTOR_SIZE;
+
+    /* Sectors not in use are leftovers of collection */
+    mflash_sector_ring_find(&ring, s_kv.sectors, s_kv.sectors, MFLASH_KV_SECTOR_MAGIC, mflash_kv_sector_header);
+    s_kv.tail     = ring.tail;
+    s_kv.head     = ring.head;
+    s_kv.used     = ring.used;
+    s_kv.head_seq = ring.head_seq;
+
+    /* Oldest first so that newer records replace older ones in the index */
+    for (uint32_t i = 0U; i < s_kv.used; i++)
+    {
+        status = mflash_kv_walk((s_kv.tail + i) % s_kv.sectors, false, &s_kv.head_off);
+        if (status != kStatus_Success)
+        {
+            s_kv.mapped = NULL;
+            return status;
+        }
+    }
+
+    return kStatus_Success;
+}
+
+/* API - set value of the key */
+status_t mflash_kv_set(const char *key, const void *value, uint32_t size)
+{
+    return mflash_kv_write(key, value, size, MFLASH_KV_FLAGS_VALUE);
+}
+
+/* API - direct access to the value of the key */
+status_t mflash_kv_get(const char *key, const uint8_t **pvalue, uint32_t *psize)
+{
+    const mflash_kv_record_t *rec;
+    uint32_t key_len;
+    uint32_t i;
+
+    if ((key == NULL) || (pvalue == NULL) || (psize == NULL))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (s_kv.mapped == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    key_len = strlen(key);
+    i       = mflash_kv_lookup(key, key_len, mflash_kv_hash(key, key_len));
+    if (s_index[i].addr == MFLASH_KV_EMPTY)
+    {
+        return kStatus_Fail;
+    }
+
+    rec     = mflash_kv_record(s_index[i].addr);
+    *pvalue = (const uint8_t *)(rec + 1) + rec->key_len;
+    *psize  = rec->value_len;
+
+    return kStatus_Success;
+}
+
+/* API - delete the key */
+status_t mflash_kv_delete(const char *key)
+{
+    return mflash_kv_write(key, NULL, 0U, MFLASH_KV_FLAGS_DELETED);
+}
+
+/* API - usage statistics */
+void mflash_kv_get_stats(mflash_kv_stats_t *stats)
+{
+    stats->keys        = s_kv.keys;
+    stats->live_bytes  = s_kv.live_bytes;
+    stats->sectors     = s_kv.sectors;
+    stats->used        = s_kv.used;
+    stats->collections = s_kv.collections;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __MFLASH_KV_H__
+#define __MFLASH_KV_H__
+
+#include "fsl_common.h"
+
+#include "mflash_drv.h"
+
+/*
+ * Key-value store for small, frequently updated settings
+ *
+ * Records are appended to a ring of sectors. A record never crosses a page boundary, so each write is a single page
+ * program, the last record of a key holds its current value and deletion appends a record without value. A RAM index
+ * maps each key to its latest record, it is rebuilt by scanning the sectors in use on mflash_kv_init. Values are
+ * accessed directly through XIP.
+ *
+ * A new sector is started only while at least one more erased sector remains, otherwise the oldest sector is
+ * collected first: records the index still points to are appended again and the sector is erased. Live data therefore
+ * has to stay below the size of all sectors but two.
+ *
+ * Power loss during a write leaves a record with invalid CRC, the scan ignores it together with the rest of its page.
+ * Power loss during collection leaves duplicates of records, the newer ones win.
+ */
+
+/* Physical address and size of the store unless resolved through the partition table, multiples of sector size */
+#ifndef MFLASH_KV_BASEADDR
+#define MFLASH_KV_BASEADDR (0x640000U)
+#endif
+
+#ifndef MFLASH_KV_SIZE
+#define MFLASH_KV_SIZE (0x20000U)
+#endif
+
+/* Number of index entries, power of 2, three quarters of it is the maximum number of keys */
+#ifndef MFLASH_KV_INDEX_SIZE
+#define MFLASH_KV_INDEX_SIZE (256U)
+#endif
+
+/* Maximum key length without the terminating zero */
+#define MFLASH_KV_KEY_MAX (32U)
+
+/* Maximum value size for key of given length, the record including its 8 byte header has to fit a page */
+#define MFLASH_KV_VALUE_MAX(key_len) ((MFLASH_PAGE_SIZE - 8U - (key_len)) & ~3U)
+
+/* Usage statistics */
+typedef struct _mflash_kv_stats
+{
+    uint32_t keys;        /* Keys stored */
+    uint32_t live_bytes;  /* Size of the records holding current values */
+    uint32_t sectors;     /* Sectors of the store */
+    uint32_t used;        /* Sectors in use */
+    uint32_t collections; /* Sectors collected since mflash_kv_init */
+} mflash_kv_stats_t;
+
+/*! @brief Initializes the store, the index is built by scanning the sectors in use. */
+status_t mflash_kv_init(bool init_drv);
+
+/*! @brief Sets value of the key, nothing is written if the value is unchanged. kStatus_Fail if the store is full. */
+status_t mflash_kv_set(const char *key, const void *value, uint32_t size);
+
+/*! @brief Returns pointer for direct memory mapped access to the value, kStatus_Fail if the key does not exist. The
+ * pointer stays valid until the next mflash_kv_set or mflash_kv_delete. */
+status_t mflash_kv_get(const char *key, const uint8_t **pvalue, uint32_t *psize);
+
+/*! @brief Deletes the key, succeeds if the key does not exist */
+status_t mflash_kv_delete(const char *key);
+
+/*! @brief Returns usage statistics */
+void mflash_kv_get_stats(mflash_kv_stats_t *stats);
+
+#endif
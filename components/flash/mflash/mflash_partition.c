@@ -0,0 +1,463 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mflash_partition.h"
+#include "mflash_drv.h"
+#include "fsl_common.h"
+
+/* Flags supported by the driver */
+#if defined(MFLASH_ENCRYPT_AREAS)
+#define MFLASH_PART_FLAGS (MFLASH_PART_FLAG_ENCRYPTED)
+#else
+#define MFLASH_PART_FLAGS (0U)
+#endif
+
+/* Magic number of the table, version is part of it */
+#define MFLASH_PART_MAGIC (0x50544231U) /* "PTB1" */
+
+/* Table as stored in each of the two sectors, fits two pages */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t sequence;   /* Incremented by each update, the valid copy with higher number is the current table */
+    uint16_t count;      /* Number of partitions */
+    uint16_t active_app; /* mflash_part_slot_t */
+    uint32_t crc;        /* CRC-32 of the fields above and the partitions in use */
+    mflash_partition_t parts[MFLASH_PART_MAX];
+} mflash_part_table_t;
+
+/*
+ * Default layout of 16MB device
+ *
+ * Application slots start past the boot image, mflash_file and littlefs stay at the addresses used by the examples.
+ * Area between the key-value store and the table is left for additional partitions.
+ */
+static const mflash_partition_t s_defaultLayout[] = {
+    {"boot", kMflashPart_Boot, 0x000000U, 0x040000U, 0U},
+    {"app_a", kMflashPart_AppA, 0x040000U, 0x300000U, 0U},
+    {"app_b", kMflashPart_AppB, 0x340000U, 0x300000U, 0U},
+    {"kv", kMflashPart_Kv, 0x640000U, 0x020000U, 0U},
+    {"mflash_file", kMflashPart_File, 0x700000U, 0x100000U, 0U},
+    {"logs", kMflashPart_Log, 0x800000U, 0x400000U, 0U},
+    {"littlefs", kMflashPart_Littlefs, 0xC00000U, 0x400000U, 0U},
+};
+
+/* Current table, valid if s_tableCopy is not negative */
+static mflash_part_table_t s_table;
+static int32_t s_tableCopy = -1;
+
+static uint32_t mflash_part_table_crc(const mflash_part_table_t *table)
+{
+    uint32_t crc;
+
+    crc = mflash_crc32(0U, table, offsetof(mflash_part_table_t, crc));
+    crc = mflash_crc32(crc, table->parts, table->count * sizeof(mflash_partition_t));
+
+    return crc;
+}
+
+/* Checks partitions for alignment, overlaps and consistency of the application slots */
+static bool mflash_part_check(const mflash_partition_t *parts, uint32_t count, uint32_t active_app)
+{
+    uint32_t flash_size = mflash_drv_get_size();
+    const mflash_partition_t *app_a = NULL;
+    const mflash_partition_t *app_b = NULL;
+
+    if (flash_size == 0U)
+    {
+        flash_size = MFLASH_BSIZE;
+    }
+
+    if ((count == 0U) || (count > MFLASH_PART_MAX) || (active_app > (uint32_t)kMflashPart_SlotB))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        const mflash_partition_t *part = &parts[i];
+
+        if ((part->name[MFLASH_PART_NAME_LEN - 1U] != '\0') || (part->size == 0U) ||
+            !mflash_drv_is_sector_aligned(part->offset) || !mflash_drv_is_sector_aligned(part->size) ||
+            (part->offset >= flash_size) || (part->size > flash_size - part->offset))
+        {
+            return false;
+        }
+
+        /* Only littlefs does not depend on erased FLASH reading as 0xFF */
+        if (((part->flags & ~MFLASH_PART_FLAGS) != 0U) ||
+            (((part->flags & MFLASH_PART_FLAG_ENCRYPTED) != 0U) && (part->type != (uint32_t)kMflashPart_Littlefs)))
+        {
+            return false;
+        }
+
+        /* The table sectors belong to no partition */
+        if ((part->offset < MFLASH_PART_TABLE_ADDR + 2U * MFLASH_SECTOR_SIZE) &&
+            (MFLASH_PART_TABLE_ADDR < part->offset + part->size))
+        {
+            return false;
+        }
+
+        for (uint32_t j = 0U; j < i; j++)
+        {
+            if ((part->offset < parts[j].offset + parts[j].size) && (parts[j].offset < part->offset + part->size))
+            {
+                return false;
+            }
+        }
+
+        /* Single partition of each application slot, other types may repeat */
+        if (part->type == (uint32_t)kMflashPart_AppA)
+        {
+            if (app_a != NULL)
+            {
+                return false;
+            }
+            app_a = part;
+        }
+        else if (part->type == (uint32_t)kMflashPart_AppB)
+        {
+            if (app_b != NULL)
+            {
+                return false;
+            }
+            app_b = part;
+        }
+        else
+        {
+            /* Nothing to check */
+        }
+    }
+
+    /* Slot B is remapped over slot A as whole, the remapping offset is positive */
+    if ((app_b != NULL) && ((app_a == NULL) || (app_a->size != app_b->size) || (app_b->offset < app_a->offset)))
+    {
+        return false;
+    }
+
+    return (active_app == (uint32_t)kMflashPart_SlotA) || (app_b != NULL);
+}
+
+/* Reads one copy of the table, kStatus_Fail if it is not valid */
+static status_t mflash_part_read_copy(uint32_t copy, mflash_part_table_t *table)
+{
+    status_t status;
+
+    status = mflash_drv_read(MFLASH_PART_TABLE_ADDR + copy * MFLASH_SECTOR_SIZE, (uint32_t *)(void *)table,
+                             sizeof(*table));
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    if ((table->magic != MFLASH_PART_MAGIC) || (table->count > MFLASH_PART_MAX) ||
+        (table->crc != mflash_part_table_crc(table)) ||
+        !mflash_part_check(table->parts, table->count, table->active_app))
+    {
+        return kStatus_Fail;
+    }
+
+    return kStatus_Success;
+}
+
+/* Loads the current table, the copy with higher sequence number wins if both are valid */
+static status_t mflash_part_load(void)
+{
+    static mflash_part_table_t other;
+    status_t status;
+
+    s_tableCopy = -1;
+
+    status = mflash_part_read_copy(0U, &s_table);
+    if (status == kStatus_Success)
+    {
+        s_tableCopy = 0;
+    }
+    else if (status != kStatus_Fail)
+    {
+        return status;
+    }
+    else
+    {
+        /* Copy 0 not valid */
+    }
+
+    status = mflash_part_read_copy(1U, &other);
+    if ((status == kStatus_Success) && ((s_tableCopy < 0) || ((int32_t)(other.sequence - s_table.sequence) > 0)))
+    {
+        (void)memcpy(&s_table, &other, sizeof(s_table));
+        s_tableCopy = 1;
+    }
+    else if ((status != kStatus_Success) && (status != kStatus_Fail))
+    {
+        return status;
+    }
+    else
+    {
+        /* Keep copy 0 */
+    }
+
+    return (s_tableCopy < 0) ? kStatus_Fail : kStatus_Success;
+}
+
+/* Writes the table to the copy not holding the current one, it becomes current once complete */
+static status_t mflash_part_store(const mflash_part_table_t *table)
+{
+    static uint32_t page_buf[MFLASH_PAGE_SIZE / sizeof(uint32_t)];
+    uint32_t copy = (s_tableCopy == 0) ? 1U : 0U;
+    uint32_t addr = MFLASH_PART_TABLE_ADDR + copy * MFLASH_SECTOR_SIZE;
+    status_t status;
+
+    status = mflash_drv_sector_erase(addr);
+
+    for (uint32_t offset = 0U; (offset < sizeof(*table)) && (status == kStatus_Success); offset += MFLASH_PAGE_SIZE)
+    {
+        uint32_t chunk = ((sizeof(*table) - offset) < MFLASH_PAGE_SIZE) ? (sizeof(*table) - offset) : MFLASH_PAGE_SIZE;
+
+        (void)memset(page_buf, 0xFF, sizeof(page_buf));
+        (void)memcpy(page_buf, (const uint8_t *)table + offset, chunk);
+        status = mflash_drv_page_program(addr + offset, page_buf);
+    }
+
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    (void)memcpy(&s_table, table, sizeof(s_table));
+    s_tableCopy = (int32_t)copy;
+
+    return kStatus_Success;
+}
+
+/* Registers encrypted partitions of the current table with the driver */
+static status_t mflash_part_encrypt(void)
+{
+    status_t status = kStatus_Success;
+
+#if defined(MFLASH_ENCRYPT_AREAS)
+    for (uint32_t i = 0U; (i < s_table.count) && (status == kStatus_Success); i++)
+    {
+        const mflash_partition_t *part = &s_table.parts[i];
+        /* Initialization vector unique to the partition */
+        uint32_t iv[2] = {part->offset, part->type};
+
+        if ((part->flags & MFLASH_PART_FLAG_ENCRYPTED) != 0U)
+        {
+            status = mflash_drv_encrypt_area(part->offset, part->size, (const uint8_t *)(void *)iv);
+        }
+    }
+#endif
+
+    return status;
+}
+
+/* API - load the partition table, create it from the layout if there is none */
+status_t mflash_part_init(const mflash_partition_t *layout, uint32_t count, bool init_drv)
+{
+    static mflash_part_table_t table;
+    status_t status;
+
+    if (init_drv)
+    {
+        status = mflash_drv_init();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+    if (layout == NULL)
+    {
+        layout = s_defaultLayout;
+        count  = ARRAY_SIZE(s_defaultLayout);
+    }
+
+    if (!mflash_part_check(layout, count, (uint32_t)kMflashPart_SlotA))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* Table in place is kept even if it differs from the layout, it may have been updated since */
+    status = mflash_part_load();
+    if (status == kStatus_Fail)
+    {
+        (void)memset(&table, 0, sizeof(table));
+        table.magic      = MFLASH_PART_MAGIC;
+        table.sequence   = 1U;
+        table.count      = (uint16_t)count;
+        table.active_app = (uint16_t)kMflashPart_SlotA;
+        (void)memcpy(table.parts, layout, count * sizeof(mflash_partition_t));
+        table.crc = mflash_part_table_crc(&table);
+
+        status = mflash_part_store(&table);
+    }
+
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    return mflash_part_encrypt();
+}
+
+/* API - first partition of given type */
+const mflash_partition_t *mflash_part_find(uint32_t type)
+{
+    if (s_tableCopy < 0)
+    {
+        return NULL;
+    }
+
+    for (uint32_t i = 0U; i < s_table.count; i++)
+    {
+        if (s_table.parts[i].type == type)
+        {
+            return &s_table.parts[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* API - partition by index */
+const mflash_partition_t *mflash_part_get(uint32_t index)
+{
+    if ((s_tableCopy < 0) || (index >= s_table.count))
+    {
+        return NULL;
+    }
+
+    return &s_table.parts[index];
+}
+
+/* API - application slot selected in the table */
+mflash_part_slot_t mflash_part_get_active_app(void)
+{
+    if ((s_tableCopy < 0) || (s_table.active_app != (uint16_t)kMflashPart_SlotB))
+    {
+        return kMflashPart_SlotA;
+    }
+
+    return kMflashPart_SlotB;
+}
+
+/* API - partition of the active or inactive application slot */
+const mflash_partition_t *mflash_part_get_app(bool active)
+{
+    bool slot_b = (mflash_part_get_active_app() == kMflashPart_SlotB);
+
+    return mflash_part_find((slot_b == active) ? (uint32_t)kMflashPart_AppB : (uint32_t)kMflashPart_AppA);
+}
+
+/* API - select application slot for the next boot */
+status_t mflash_part_set_active_app(mflash_part_slot_t slot)
+{
+    static mflash_part_table_t table;
+
+    if (s_tableCopy < 0)
+    {
+        return kStatus_Fail;
+    }
+
+    if (s_table.active_app == (uint16_t)slot)
+    {
+        return kStatus_Success;
+    }
+
+    if (!mflash_part_check(s_table.parts, s_table.count, (uint32_t)slot))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    (void)memcpy(&table, &s_table, sizeof(table));
+    table.sequence++;
+    table.active_app = (uint16_t)slot;
+    table.crc        = mflash_part_table_crc(&table);
+
+    return mflash_part_store(&table);
+}
+
+#if defined(FLEXSPI_HADDRSTART_REMAPEN_MASK)
+/* Internal - program the remapping window, executed from RAM as the mapping of FLASH changes underneath */
+MFLASH_RAMFUNC(static void mflash_part_remap(uint32_t start, uint32_t end, uint32_t offset))
+{
+    FLEXSPI_Type *base = MFLASH_FLEXSPI;
+    uint32_t primask   = __get_PRIMASK();
+
+    __asm("cpsid i");
+
+    /* Disabled first so that the window is never active with bounds partially updated */
+    base->HADDRSTART  = 0U;
+    base->HADDREND    = end;
+    base->HADDROFFSET = offset;
+    if (offset != 0U)
+    {
+        base->HADDRSTART = start | FLEXSPI_HADDRSTART_REMAPEN_MASK;
+    }
+
+    /* Data prefetched through the previous mapping */
+#if defined(FLEXSPI_AHBCR_CLRAHBRXBUF_MASK) && defined(FLEXSPI_AHBCR_CLRAHBTXBUF_MASK)
+    base->AHBCR |= FLEXSPI_AHBCR_CLRAHBRXBUF_MASK | FLEXSPI_AHBCR_CLRAHBTXBUF_MASK;
+    base->AHBCR &= ~(FLEXSPI_AHBCR_CLRAHBRXBUF_MASK | FLEXSPI_AHBCR_CLRAHBTXBUF_MASK);
+#else
+    base->MCR0 |= FLEXSPI_MCR0_SWRESET_MASK;
+    while ((base->MCR0 & FLEXSPI_MCR0_SWRESET_MASK) != 0U)
+    {
+    }
+#endif
+
+#if defined(CACHE64_CTRL0)
+    /* Lines are tagged by AHB address, these now refer to different content */
+    CACHE64_CTRL0->CCR |= CACHE64_CTRL_CCR_INVW0_MASK | CACHE64_CTRL_CCR_INVW1_MASK | CACHE64_CTRL_CCR_GO_MASK;
+    while ((CACHE64_CTRL0->CCR & CACHE64_CTRL_CCR_GO_MASK) != 0U)
+    {
+    }
+    CACHE64_CTRL0->CCR &= ~(CACHE64_CTRL_CCR_INVW0_MASK | CACHE64_CTRL_CCR_INVW1_MASK);
+#endif
+
+    __DSB();
+    __ISB();
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+}
+#endif
+
+/* API - program the remapping for the active slot */
+status_t mflash_part_apply_remap(void)
+{
+#if defined(FLEXSPI_HADDRSTART_REMAPEN_MASK)
+    const mflash_partition_t *app_a = mflash_part_find((uint32_t)kMflashPart_AppA);
+    const mflash_partition_t *app_b = mflash_part_find((uint32_t)kMflashPart_AppB);
+
+    if (mflash_part_get_active_app() == kMflashPart_SlotA)
+    {
+        mflash_part_remap(0U, 0U, 0U);
+        return kStatus_Success;
+    }
+
+    /* Presence, size and order of the slots are guaranteed by the table check */
+    if ((app_a == NULL) || (app_b == NULL))
+    {
+        return kStatus_Fail;
+    }
+
+    mflash_part_remap(MFLASH_BASE_ADDRESS + app_a->offset, MFLASH_BASE_ADDRESS + app_a->offset + app_a->size,
+                      app_b->offset - app_a->offset);
+
+    return kStatus_Success;
+#else
+    return kStatus_Fail;
+#endif
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __MFLASH_PARTITION_H__
+#define __MFLASH_PARTITION_H__
+
+#include "fsl_common.h"
+
+#include "mflash_drv.h"
+
+/*
+ * Partition table
+ *
+ * The FLASH is split into partitions described by a table kept in FLASH at MFLASH_PART_TABLE_ADDR. The table is stored
+ * twice, in two adjacent sectors. Each update goes to the copy not holding the current table and carries a higher
+ * sequence number, power loss during the update leaves the previous table in place. mflash clients (mflash_file,
+ * mflash_kv, mflash_ts, littlefs port) built with MFLASH_PARTITIONS resolve their regions by mflash_part_find instead
+ * of fixed addresses.
+ *
+ * Two application slots of equal size allow image update without copying. The image is linked for the address of
+ * slot A, slot B is made visible at the same address by FLEXSPI AHB address remapping (HADDRSTART, HADDREND and
+ * HADDROFFSET registers). mflash_part_set_active_app selects the slot for the next boot, the boot stage calls
+ * mflash_part_apply_remap before it starts the application. While slot B is active, slot A can not be accessed through
+ * AHB, it is still written by the mflash driver using physical addresses.
+ *
+ * Partitions flagged MFLASH_PART_FLAG_ENCRYPTED are registered with the driver as encrypted areas by mflash_part_init,
+ * on devices supporting inline encryption (MFLASH_ENCRYPT_AREAS). Encryption is accepted for littlefs partitions only,
+ * the other clients depend on erased FLASH reading as 0xFF. Changing the flag makes the content of the partition
+ * unreadable, littlefs has to be formatted again.
+ */
+
+/* Physical address of the two sectors holding the table, outside of any partition of the default layout */
+#ifndef MFLASH_PART_TABLE_ADDR
+#define MFLASH_PART_TABLE_ADDR (0x6FE000U)
+#endif
+
+/* Maximum number of partitions in the table */
+#ifndef MFLASH_PART_MAX
+#define MFLASH_PART_MAX (15U)
+#endif
+
+/* Partition flags */
+#define MFLASH_PART_FLAG_ENCRYPTED (1U) /* Content encrypted by the FLEXSPI, see mflash_drv_encrypt_area */
+
+/* Length of partition name including the terminating zero */
+#define MFLASH_PART_NAME_LEN (16U)
+
+/* Partition types */
+typedef enum _mflash_part_type
+{
+    kMflashPart_Boot     = 1U, /* Image booted by ROM, performs the slot selection */
+    kMflashPart_AppA     = 2U, /* Application slot the images are linked for */
+    kMflashPart_AppB     = 3U, /* Alternate application slot, remapped over slot A when active */
+    kMflashPart_File     = 4U, /* mflash_file filesystem */
+    kMflashPart_Littlefs = 5U, /* littlefs on the mflash port */
+    kMflashPart_Log      = 6U, /* Logs, mflash_ts time-series store */
+    kMflashPart_Kv       = 7U, /* mflash_kv key-value store */
+} mflash_part_type_t;
+
+/* Application slots */
+typedef enum _mflash_part_slot
+{
+    kMflashPart_SlotA = 0U,
+    kMflashPart_SlotB = 1U,
+} mflash_part_slot_t;
+
+/* Partition descriptor as stored in FLASH */
+typedef struct _mflash_partition
+{
+    char name[MFLASH_PART_NAME_LEN]; /* Zero terminated */
+    uint32_t type;                   /* mflash_part_type_t */
+    uint32_t offset;                 /* Physical address in FLASH, multiple of MFLASH_SECTOR_SIZE */
+    uint32_t size;                   /* Bytes, multiple of MFLASH_SECTOR_SIZE */
+    uint32_t flags;                  /* MFLASH_PART_FLAG_x, other bits reserved, 0 */
+} mflash_partition_t;
+
+/*! @brief Loads the partition table, the layout is written to FLASH if no valid table is present. NULL layout stands
+ * for the default one of 16MB device. */
+status_t mflash_part_init(const mflash_partition_t *layout, uint32_t count, bool init_drv);
+
+/*! @brief Returns the first partition of given type, NULL if there is none or the table is not loaded */
+const mflash_partition_t *mflash_part_find(uint32_t type);
+
+/*! @brief Returns partition by index, NULL past the end of the table */
+const mflash_partition_t *mflash_part_get(uint32_t index);
+
+/*! @brief Returns application slot selected in the table */
+mflash_part_slot_t mflash_part_get_active_app(void);
+
+/*! @brief Returns partition of the active (or inactive, to be updated) application slot */
+const mflash_partition_t *mflash_part_get_app(bool active);
+
+/*! @brief Selects application slot for the next boot, the table is updated in FLASH, the remapping is left as is */
+status_t mflash_part_set_active_app(mflash_part_slot_t slot);
+
+/*! @brief Programs the FLEXSPI remapping for the active slot, disables it for slot A. Must not be called while
+ * executing from, or accessing data in, the application slots. */
+status_t mflash_part_apply_remap(void);
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mflash_stage.h"
+#include "mflash_drv.h"
+#include "fsl_common.h"
+
+/* Queued operation is the physical address of the page or sector, the lowest bit marks sector erase */
+#define MFLASH_STAGE_OP_ERASE (1U)
+
+typedef struct
+{
+    uint8_t *buffer; /* Staging buffer, slot per queued operation, NULL until initialized */
+    uint32_t slots;  /* Number of slots */
+    uint32_t first;  /* Slot of the oldest operation */
+    uint32_t queued; /* Number of queued operations */
+    status_t error;  /* Status of failed operation, it is retried by the next drain */
+    uint32_t max_queued;
+    uint32_t staged;
+    uint32_t drained;
+    uint32_t stalls;
+} mflash_stage_t;
+
+static mflash_stage_t s_stage;
+static uint32_t s_ops[MFLASH_STAGE_MAX_SLOTS];
+static uint32_t s_pageBuf[MFLASH_PAGE_SIZE / sizeof(uint32_t)];
+
+/* Performs the oldest operation */
+static status_t mflash_stage_drain_one(void)
+{
+    uint32_t op = s_ops[s_stage.first];
+    status_t status;
+
+    if ((op & MFLASH_STAGE_OP_ERASE) != 0U)
+    {
+        status = mflash_drv_sector_erase(op & ~MFLASH_STAGE_OP_ERASE);
+    }
+    else
+    {
+        /* Copied to RAM, the FLEXSPI can not fetch the staging buffer while programming */
+        (void)memcpy(s_pageBuf, s_stage.buffer + s_stage.first * MFLASH_PAGE_SIZE, MFLASH_PAGE_SIZE);
+        status = mflash_drv_page_program(op, s_pageBuf);
+    }
+
+    s_stage.error = status;
+    if (status != kStatus_Success)
+    {
+        return status;
+    }
+
+    s_stage.first = (s_stage.first + 1U) % s_stage.slots;
+    s_stage.queued--;
+    s_stage.drained++;
+
+    return kStatus_Success;
+}
+
+/* Appends operation to the queue, the oldest one is drained first if the queue is full */
+static status_t mflash_stage_push(uint32_t op, const uint32_t *data)
+{
+    uint32_t slot;
+    status_t status;
+
+    if (s_stage.buffer == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    if (s_stage.error != kStatus_Success)
+    {
+        return s_stage.error;
+    }
+
+    if (s_stage.queued == s_stage.slots)
+    {
+        s_stage.stalls++;
+        status = mflash_stage_drain_one();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+    slot        = (s_stage.first + s_stage.queued) % s_stage.slots;
+    s_ops[slot] = op;
+    if (data != NULL)
+    {
+        (void)memcpy(s_stage.buffer + slot * MFLASH_PAGE_SIZE, data, MFLASH_PAGE_SIZE);
+    }
+
+    s_stage.queued++;
+    s_stage.staged++;
+    if (s_stage.queued > s_stage.max_queued)
+    {
+        s_stage.max_queued = s_stage.queued;
+    }
+
+    return kStatus_Success;
+}
+
+/* API - initialize the queue */
+status_t mflash_stage_init(void *buffer, uint32_t slots)
+{
+    if ((buffer == NULL) || (slots == 0U) || (slots > MFLASH_STAGE_MAX_SLOTS) || (((uintptr_t)buffer % 4U) != 0U))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    (void)memset(&s_stage, 0, sizeof(s_stage));
+    s_stage.buffer = (uint8_t *)buffer;
+    s_stage.slots  = slots;
+
+    return kStatus_Success;
+}
+
+/* API - queue page program */
+status_t mflash_stage_page_program(uint32_t page_addr, const uint32_t *data)
+{
+    if ((data == NULL) || !mflash_drv_is_page_aligned(page_addr))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return mflash_stage_push(page_addr, data);
+}
+
+/* API - queue sector erase */
+status_t mflash_stage_sector_erase(uint32_t sector_addr)
+{
+    if (!mflash_drv_is_sector_aligned(sector_addr))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+#if defined(MFLASH_ENCRYPT_AREAS)
+    /* Erased sector of encrypted area does not read as 0xFF, the overlay can not tell what it reads after the drain.
+     * The erase is performed right away, after the operations queued before it. */
+    if (mflash_drv_is_encrypted(sector_addr, MFLASH_SECTOR_SIZE))
+    {
+        status_t status = mflash_stage_flush();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        return mflash_drv_sector_erase(sector_addr);
+    }
+#endif
+
+    return mflash_stage_push(sector_addr | MFLASH_STAGE_OP_ERASE, NULL);
+}
+
+/* API - apply queued operations to data read from FLASH, in the order these are performed */
+void mflash_stage_overlay(uint32_t addr, void *buffer, uint32_t size)
+{
+    uint8_t *data = (uint8_t *)buffer;
+
+    if (s_stage.buffer == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0U; i < s_stage.queued; i++)
+    {
+        uint32_t slot  = (s_stage.first + i) % s_stage.slots;
+        uint32_t start = s_ops[slot] & ~MFLASH_STAGE_OP_ERASE;
+        bool erase     = ((s_ops[slot] & MFLASH_STAGE_OP_ERASE) != 0U);
+        uint32_t end   = start + (erase ? MFLASH_SECTOR_SIZE : MFLASH_PAGE_SIZE);
+        uint32_t lo;
+        uint32_t hi;
+
+        if ((start >= addr + size) || (end <= addr))
+        {
+            continue;
+        }
+
+        lo = (start > addr) ? start : addr;
+        hi = (end < addr + size) ? end : addr + size;
+
+        if (erase)
+        {
+            (void)memset(&data[lo - addr], 0xFF, hi - lo);
+        }
+        else
+        {
+            /* Program only clears bits */
+            const uint8_t *page = s_stage.buffer + slot * MFLASH_PAGE_SIZE;
+
+#if defined(MFLASH_ENCRYPT_AREAS)
+            /* Erased pages of encrypted areas do not read as 0xFF, these are programmed once and replaced as whole */
+            if (mflash_drv_is_encrypted(start, MFLASH_PAGE_SIZE))
+            {
+                (void)memcpy(&data[lo - addr], &page[lo - start], hi - lo);
+                continue;
+            }
+#endif
+            for (uint32_t off = lo; off < hi; off++)
+            {
+                data[off - addr] &= page[off - start];
+            }
+        }
+    }
+}
+
+/* API - perform oldest operations */
+status_t mflash_stage_drain(uint32_t max_ops)
+{
+    status_t status = kStatus_Success;
+
+    if (s_stage.buffer == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    /* Invalidate cache lines of all drained areas at once */
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_begin();
+#endif
+    for (uint32_t i = 0U; (i < max_ops) && (s_stage.queued != 0U) && (status == kStatus_Success); i++)
+    {
+        status = mflash_stage_drain_one();
+    }
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_end();
+#endif
+
+    return (status != kStatus_Success) ? status : s_stage.error;
+}
+
+/* API - perform all queued operations */
+status_t mflash_stage_flush(void)
+{
+    return mflash_stage_drain(UINT32_MAX);
+}
+
+/* API - number of queued operations */
+uint32_t mflash_stage_queued(void)
+{
+    return s_stage.queued;
+}
+
+/* API - usage statistics */
+void mflash_stage_get_stats(mflash_stage_stats_t *stats)
+{
+    stats->queued     = s_stage.queued;
+    stats->slots      = s_stage.slots;
+    stats->max_queued = s_stage.max_queued;
+    stats->staged     = s_stage.staged;
+    stats->drained    = s_stage.drained;
+    stats->stalls     = s_stage.stalls;
+}
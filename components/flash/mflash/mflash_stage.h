@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __MFLASH_STAGE_H__
+#define __MFLASH_STAGE_H__
+
+#include "fsl_common.h"
+
+#include "mflash_drv.h"
+
+/*
+ * Write-back staging of page programs and sector erases
+ *
+ * Operations are queued in the order they are issued, the data of each page program is copied to a slot of the
+ * staging buffer, typically in PSRAM, and the call returns without waiting for the FLASH. mflash_stage_drain performs
+ * the queued operations strictly in order, so that power loss leaves the FLASH as if the writer stopped at some earlier
+ * operation. The number of queued operations is bounded by the number of slots given to mflash_stage_init, a program
+ * or erase finding the queue full drains the oldest operation first.
+ *
+ * FLASH content read by the caller has to be passed through mflash_stage_overlay to see the queued operations.
+ * Memory mapped access bypasses the queue, it sees the FLASH as drained so far.
+ *
+ * The staging buffer is accessed by the CPU only, FLASH is programmed from a page buffer in RAM so that the FLEXSPI
+ * never serves the staging buffer while an IP command to the FLASH is in progress.
+ */
+
+/* Maximum number of queue slots, the queue takes 4 bytes of RAM per slot in addition to the staging buffer */
+#ifndef MFLASH_STAGE_MAX_SLOTS
+#define MFLASH_STAGE_MAX_SLOTS (1024U)
+#endif
+
+/* Usage statistics */
+typedef struct _mflash_stage_stats
+{
+    uint32_t queued;     /* Operations queued now */
+    uint32_t slots;      /* Queue size */
+    uint32_t max_queued; /* Highest number of operations queued at once */
+    uint32_t staged;     /* Operations queued since mflash_stage_init */
+    uint32_t drained;    /* Operations performed on the FLASH since mflash_stage_init */
+    uint32_t stalls;     /* Operations drained because the queue was full */
+} mflash_stage_stats_t;
+
+/*! @brief Initializes empty queue using buffer of given number of page sized slots, the driver has to be initialized
+ * already. Operations still queued are dropped. */
+status_t mflash_stage_init(void *buffer, uint32_t slots);
+
+/*! @brief Queues program of single page, data is copied */
+status_t mflash_stage_page_program(uint32_t page_addr, const uint32_t *data);
+
+/*! @brief Queues erase of single sector. Sector of encrypted area is erased right away after the queue is drained. */
+status_t mflash_stage_sector_erase(uint32_t sector_addr);
+
+/*! @brief Applies queued operations to data read from FLASH at given physical address */
+void mflash_stage_overlay(uint32_t addr, void *buffer, uint32_t size);
+
+/*! @brief Performs up to max_ops oldest operations on the FLASH. A failed operation stays queued and is retried by
+ * the next drain, program and erase return its status meanwhile. */
+status_t mflash_stage_drain(uint32_t max_ops);
+
+/*! @brief Performs all queued operations, durability point of the writer */
+status_t mflash_stage_flush(void);
+
+/*! @brief Returns number of queued operations */
+uint32_t mflash_stage_queued(void);
+
+/*! @brief Returns usage statistics */
+void mflash_stage_get_stats(mflash_stage_stats_t *stats);
+
+#endif
@@ -0,0 +1,574 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mflash_ts.h"
+#include "mflash_drv.h"
+#include "fsl_common.h"
+
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+#include "mflash_partition.h"
+#endif
+
+/* Magic number of sector header, version is part of it */
+#define MFLASH_TS_SECTOR_MAGIC (0x54535331U) /* "TSS1" */
+
+/* Length of erased page header */
+#define MFLASH_TS_LEN_ERASED (0xFFFFU)
+
+/* Header at the start of each page */
+typedef struct
+{
+    uint32_t crc;      /* CRC-32 of the rest of the header and the data */
+    uint16_t len;      /* Bytes of data following the header, 0 for page invalidated by mflash_ts_init */
+    uint16_t reserved; /* Erased */
+} mflash_ts_page_t;
+
+/* Data of the first page of each sector start with the sector header */
+typedef struct
+{
+    mflash_sector_header_t header;
+    uint32_t first_ts; /* Timestamp of the first record of the sector */
+} mflash_ts_sector_t;
+
+/* Record header followed by the data and padding to multiple of 4 */
+typedef struct
+{
+    uint32_t timestamp;
+    uint16_t size;     /* Data bytes */
+    uint16_t reserved; /* Erased */
+} mflash_ts_record_t;
+
+#define MFLASH_TS_REC_SIZE(size) ((sizeof(mflash_ts_record_t) + (uint32_t)(size) + 3U) & ~3U)
+
+/* Offset of the first record of the page at given offset in sector */
+#define MFLASH_TS_DATA_START(page) \
+    ((page) + sizeof(mflash_ts_page_t) + (((page) == 0U) ? sizeof(mflash_ts_sector_t) : 0U))
+
+typedef struct
+{
+    const uint8_t *mapped; /* Memory mapped address of the first sector, NULL until initialized */
+    uint32_t base;         /* Physical address of the first sector */
+    uint32_t sectors;      /* Number of sectors */
+    uint32_t tail;         /* Oldest sector in use */
+    uint32_t head;         /* Sector pages are programmed to */
+    uint32_t used;         /* Sectors in use including the head, 0 for empty store */
+    uint32_t head_seq;     /* Sequence number of the head sector */
+    uint32_t head_page;    /* Offset of the page buffered in RAM or to be programmed next */
+    uint32_t last_ts;      /* Timestamp of the newest record */
+    bool buffered;         /* Page buffer holds data */
+    bool erased_ahead;     /* Sector the head moves to next is erased */
+    uint32_t pages;
+    uint32_t erases;
+} mflash_ts_t;
+
+static mflash_ts_t s_ts;
+static uint32_t s_firstTs[MFLASH_TS_MAX_SECTORS];
+static uint32_t s_pageBuf[MFLASH_PAGE_SIZE / sizeof(uint32_t)];
+
+static uint32_t mflash_ts_page_crc(const mflash_ts_page_t *page)
+{
+    return mflash_crc32(0U, &page->len, sizeof(*page) - offsetof(mflash_ts_page_t, len) + page->len);
+}
+
+/* Checks the page was programmed completely */
+static bool mflash_ts_page_valid(const mflash_ts_page_t *page)
+{
+    return (page->len <= (MFLASH_PAGE_SIZE - sizeof(*page))) && (page->crc == mflash_ts_page_crc(page));
+}
+
+static uint32_t mflash_ts_sector_addr(uint32_t sector)
+{
+    return s_ts.base + sector * MFLASH_SECTOR_SIZE;
+}
+
+/* Page content, from the page buffer for the page not programmed yet, NULL past the newest data */
+static const mflash_ts_page_t *mflash_ts_page(uint32_t sector, uint32_t page)
+{
+    if (sector == s_ts.head)
+    {
+        if ((page == s_ts.head_page) && s_ts.buffered)
+        {
+            return (const mflash_ts_page_t *)(const void *)s_pageBuf;
+        }
+
+        if (page >= s_ts.head_page)
+        {
+            return NULL;
+        }
+    }
+
+    return (const mflash_ts_page_t *)(const void *)(s_ts.mapped + sector * MFLASH_SECTOR_SIZE + page);
+}
+
+/* Sector header follows the header of the first page, unless that is erased */
+static const mflash_sector_header_t *mflash_ts_sector_header(uint32_t sector)
+{
+    const mflash_ts_page_t *page =
+        (const mflash_ts_page_t *)(const void *)(s_ts.mapped + sector * MFLASH_SECTOR_SIZE);
+
+    if (page->len == MFLASH_TS_LEN_ERASED)
+    {
+        return NULL;
+    }
+
+    return &((const mflash_ts_sector_t *)(const void *)(page + 1))->header;
+}
+
+/* Erases the sector, the oldest sector in use is dropped first */
+static status_t mflash_ts_erase(uint32_t sector)
+{
+    if ((s_ts.used != 0U) && (sector == s_ts.tail))
+    {
+        s_ts.tail = (s_ts.tail + 1U) % s_ts.sectors;
+        s_ts.used--;
+    }
+    else if (mflash_is_blank(s_ts.mapped + sector * MFLASH_SECTOR_SIZE, MFLASH_SECTOR_SIZE))
+    {
+        return kStatus_Success;
+    }
+    else
+    {
+        /* Leftover of interrupted operation */
+    }
+
+    s_ts.erases++;
+
+    return mflash_drv_sector_erase(mflash_ts_sector_addr(sector));
+}
+
+/* Sector the head moves to next */
+static uint32_t mflash_ts_ahead(void)
+{
+    return (s_ts.used == 0U) ? s_ts.head : ((s_ts.head + 1U) % s_ts.sectors);
+}
+
+/* Programs the page buffer, the page is not used again even if the program fails */
+static status_t mflash_ts_program_page(void)
+{
+    mflash_ts_page_t *page = (mflash_ts_page_t *)(void *)s_pageBuf;
+    status_t status;
+
+    page->crc = mflash_ts_page_crc(page);
+    status    = mflash_drv_page_program(mflash_ts_sector_addr(s_ts.head) + s_ts.head_page, s_pageBuf);
+
+    s_ts.buffered = false;
+    s_ts.head_page += MFLASH_PAGE_SIZE;
+    s_ts.pages++;
+
+    return status;
+}
+
+/* Starts new page in the buffer, in the next sector if the head is full */
+static status_t mflash_ts_start_page(uint32_t timestamp)
+{
+    mflash_ts_page_t *page = (mflash_ts_page_t *)(void *)s_pageBuf;
+    mflash_ts_sector_t *hdr;
+    status_t status;
+
+    if ((s_ts.used == 0U) || (s_ts.head_page >= MFLASH_SECTOR_SIZE))
+    {
+        status = mflash_ts_erase_ahead();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        s_ts.head = mflash_ts_ahead();
+        if (s_ts.used == 0U)
+        {
+            s_ts.tail = s_ts.head;
+        }
+        s_ts.used++;
+        s_ts.head_seq++;
+        s_ts.head_page    = 0U;
+        s_ts.erased_ahead = false;
+
+        s_firstTs[s_ts.head] = timestamp;
+    }
+
+    (void)memset(s_pageBuf, 0xFF, sizeof(s_pageBuf));
+    page->len = 0U;
+
+    if (s_ts.head_page == 0U)
+    {
+        hdr = (mflash_ts_sector_t *)(void *)(page + 1);
+        mflash_sector_header_init(&hdr->header, MFLASH_TS_SECTOR_MAGIC, s_ts.head_seq);
+        hdr->first_ts = timestamp;
+        page->len     = sizeof(*hdr);
+    }
+
+    s_ts.buffered = true;
+
+    return kStatus_Success;
+}
+
+/* Checks pages of the head sector, finds the page following the last programmed one and the newest timestamp. Pages
+ * with invalid CRC are left by power loss during program, their header is programmed to zeros so that readers skip
+ * them. Erased pages before the last programmed one are left by failed program and skipped by readers as well. */
+static status_t mflash_ts_scan_head(void)
+{
+    const uint8_t *sector = s_ts.mapped + s_ts.head * MFLASH_SECTOR_SIZE;
+    status_t status       = kStatus_Success;
+
+    s_ts.last_ts   = s_firstTs[s_ts.head];
+    s_ts.head_page = 0U;
+
+    for (uint32_t page = 0U; (page < MFLASH_SECTOR_SIZE) && (status == kStatus_Success); page += MFLASH_PAGE_SIZE)
+    {
+        const mflash_ts_page_t *hdr = (const mflash_ts_page_t *)(const void *)(sector + page);
+
+        if (mflash_is_blank(sector + page, MFLASH_PAGE_SIZE))
+        {
+            continue;
+        }
+
+        s_ts.head_page = page + MFLASH_PAGE_SIZE;
+
+        if (hdr->len == 0U)
+        {
+            /* Invalidated on earlier init */
+        }
+        else if (!mflash_ts_page_valid(hdr))
+        {
+            (void)memset(s_pageBuf, 0xFF, sizeof(s_pageBuf));
+            (void)memset(s_pageBuf, 0x00, sizeof(*hdr));
+            status = mflash_drv_page_program(mflash_ts_sector_addr(s_ts.head) + page, s_pageBuf);
+        }
+        else
+        {
+            for (uint32_t off = MFLASH_TS_DATA_START(page); off < page + sizeof(*hdr) + hdr->len;)
+            {
+                const mflash_ts_record_t *rec = (const mflash_ts_record_t *)(const void *)(sector + off);
+
+                s_ts.last_ts = rec->timestamp;
+                off += MFLASH_TS_REC_SIZE(rec->size);
+            }
+        }
+    }
+
+    return status;
+}
+
+/*
+ * Record at the cursor, NULL past the newest record. The cursor moves over the ends of pages and sectors, position in
+ * a sector dropped meanwhile moves to the oldest record.
+ */
+static const mflash_ts_record_t *mflash_ts_cursor_record(mflash_ts_cursor_t *cursor)
+{
+    for (;;)
+    {
+        uint32_t age = (s_ts.head + s_ts.sectors - cursor->sector) % s_ts.sectors;
+        uint32_t page_off;
+        const mflash_ts_page_t *page;
+
+        if (s_ts.used == 0U)
+        {
+            return NULL;
+        }
+
+        if ((age >= s_ts.used) || (cursor->sequence != s_ts.head_seq - age))
+        {
+            cursor->sector   = s_ts.tail;
+            cursor->sequence = s_ts.head_seq - (s_ts.used - 1U);
+            cursor->offset   = 0U;
+        }
+
+        if (cursor->offset >= MFLASH_SECTOR_SIZE)
+        {
+            if (cursor->sector == s_ts.head)
+            {
+                return NULL;
+            }
+            cursor->sector = (cursor->sector + 1U) % s_ts.sectors;
+            cursor->sequence++;
+            cursor->offset = 0U;
+        }
+
+        page_off = cursor->offset & ~(MFLASH_PAGE_SIZE - 1U);
+        page     = mflash_ts_page(cursor->sector, page_off);
+        if (page == NULL)
+        {
+            return NULL;
+        }
+
+        if (cursor->offset < MFLASH_TS_DATA_START(page_off))
+        {
+            cursor->offset = MFLASH_TS_DATA_START(page_off);
+        }
+
+        /* Erased page may remain in older sectors if its program failed */
+        if ((page->len != MFLASH_TS_LEN_ERASED) && (cursor->offset < page_off + sizeof(*page) + page->len))
+        {
+            return (const mflash_ts_record_t *)(const void *)((const uint8_t *)page + (cursor->offset - page_off));
+        }
+
+        cursor->offset = page_off + MFLASH_PAGE_SIZE;
+    }
+}
+
+/* API - initialize the store and build the sector index */
+status_t mflash_ts_init(bool init_drv)
+{
+    uint32_t base = MFLASH_TS_BASEADDR;
+    uint32_t size = MFLASH_TS_SIZE;
+    mflash_sector_ring_t ring;
+    status_t status;
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    const mflash_partition_t *part;
+#endif
+
+    if (init_drv)
+    {
+        status = mflash_drv_init();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    /* Table loaded by mflash_part_init */
+    part = mflash_part_find((uint32_t)kMflashPart_Log);
+    if (part == NULL)
+    {
+        return kStatus_Fail;
+    }
+    base = part->offset;
+    size = part->size;
+#endif
+
+    if (!mflash_drv_is_sector_aligned(base) || !mflash_drv_is_sector_aligned(size) ||
+        (size < 3U * MFLASH_SECTOR_SIZE) || (size / MFLASH_SECTOR_SIZE > MFLASH_TS_MAX_SECTORS))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    (void)memset(&s_ts, 0, sizeof(s_ts));
+
+    s_ts.mapped = (const uint8_t *)mflash_drv_phys2log(base, size);
+    if (s_ts.mapped == NULL)
+    {
+        return kStatus_Fail;
+    }
+    s_ts.base    = base;
+    s_ts.sectors = size / MFLASH_SECTOR_SIZE;
+
+    /* The sector following the head may be partially erased by interrupted erase ahead, it is not used even if its
+     * header remains */
+    mflash_sector_ring_find(&ring, s_ts.sectors, s_ts.sectors - 1U, MFLASH_TS_SECTOR_MAGIC, mflash_ts_sector_header);
+    s_ts.tail     = ring.tail;
+    s_ts.head     = ring.head;
+    s_ts.used     = ring.used;
+    s_ts.head_seq = ring.head_seq;
+
+    /* Power loss while programming the first page of the head, the sector header may be incomplete and the sector
+     * holds no records yet */
+    if ((s_ts.used != 0U) &&
+        !mflash_ts_page_valid((const mflash_ts_page_t *)(const void *)(s_ts.mapped + s_ts.head * MFLASH_SECTOR_SIZE)))
+    {
+        s_ts.erases++;
+        status = mflash_drv_sector_erase(mflash_ts_sector_addr(s_ts.head));
+        if (status != kStatus_Success)
+        {
+            s_ts.mapped = NULL;
+            return status;
+        }
+        s_ts.head = (s_ts.head + s_ts.sectors - 1U) % s_ts.sectors;
+        s_ts.head_seq--;
+        s_ts.used--;
+    }
+
+    for (uint32_t i = 0U; i < s_ts.used; i++)
+    {
+        uint32_t sector = (s_ts.tail + i) % s_ts.sectors;
+
+        s_firstTs[sector] = ((const mflash_ts_sector_t *)(const void *)(s_ts.mapped + sector * MFLASH_SECTOR_SIZE +
+                                                                        sizeof(mflash_ts_page_t)))
+                                ->first_ts;
+    }
+
+    if (s_ts.used != 0U)
+    {
+        status = mflash_ts_scan_head();
+        if (status != kStatus_Success)
+        {
+            s_ts.mapped = NULL;
+            return status;
+        }
+    }
+
+    return kStatus_Success;
+}
+
+/* API - append record */
+status_t mflash_ts_append(uint32_t timestamp, const void *data, uint32_t size)
+{
+    mflash_ts_page_t *page = (mflash_ts_page_t *)(void *)s_pageBuf;
+    mflash_ts_record_t *rec;
+    uint32_t rec_size = MFLASH_TS_REC_SIZE(size);
+    status_t status;
+
+    if (s_ts.mapped == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    if (((data == NULL) && (size != 0U)) || (size > MFLASH_TS_DATA_MAX) ||
+        ((s_ts.used != 0U) && (timestamp < s_ts.last_ts)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (s_ts.buffered && (sizeof(*page) + page->len + rec_size > MFLASH_PAGE_SIZE))
+    {
+        status = mflash_ts_program_page();
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+    if (!s_ts.buffered)
+    {
+        status = mflash_ts_start_page(timestamp);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+    }
+
+    rec            = (mflash_ts_record_t *)(void *)((uint8_t *)(page + 1) + page->len);
+    rec->timestamp = timestamp;
+    rec->size      = (uint16_t)size;
+    if (size != 0U)
+    {
+        (void)memcpy(rec + 1, data, size);
+    }
+    page->len += (uint16_t)rec_size;
+
+    s_ts.last_ts = timestamp;
+
+    return kStatus_Success;
+}
+
+/* API - program the partially filled page */
+status_t mflash_ts_flush(void)
+{
+    if (!s_ts.buffered)
+    {
+        return kStatus_Success;
+    }
+
+    return mflash_ts_program_page();
+}
+
+/* API - erase the sector the head moves to next */
+status_t mflash_ts_erase_ahead(void)
+{
+    status_t status;
+
+    if (s_ts.mapped == NULL)
+    {
+        return kStatus_Fail;
+    }
+
+    if (s_ts.erased_ahead)
+    {
+        return kStatus_Success;
+    }
+
+    status = mflash_ts_erase(mflash_ts_ahead());
+    if (status == kStatus_Success)
+    {
+        s_ts.erased_ahead = true;
+    }
+
+    return status;
+}
+
+/* API - position the cursor by timestamp */
+status_t mflash_ts_seek(uint32_t timestamp, mflash_ts_cursor_t *cursor)
+{
+    const mflash_ts_record_t *rec;
+    uint32_t lo = 0U;
+    uint32_t hi = s_ts.used;
+
+    if ((s_ts.mapped == NULL) || (cursor == NULL))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* First sector starting at the timestamp or later, matching records may end the one before */
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2U;
+
+        if (s_firstTs[(s_ts.tail + mid) % s_ts.sectors] < timestamp)
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo > 0U)
+    {
+        lo--;
+    }
+
+    cursor->sector   = (s_ts.tail + lo) % s_ts.sectors;
+    cursor->sequence = s_ts.head_seq - (s_ts.used - 1U - lo);
+    cursor->offset   = 0U;
+
+    for (rec = mflash_ts_cursor_record(cursor); (rec != NULL) && (rec->timestamp < timestamp);
+         rec = mflash_ts_cursor_record(cursor))
+    {
+        cursor->offset += MFLASH_TS_REC_SIZE(rec->size);
+    }
+
+    return kStatus_Success;
+}
+
+/* API - read record and advance the cursor */
+status_t mflash_ts_next(mflash_ts_cursor_t *cursor, uint32_t *ptimestamp, const uint8_t **pdata, uint32_t *psize)
+{
+    const mflash_ts_record_t *rec;
+
+    if ((s_ts.mapped == NULL) || (cursor == NULL) || (ptimestamp == NULL) || (pdata == NULL) || (psize == NULL))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    rec = mflash_ts_cursor_record(cursor);
+    if (rec == NULL)
+    {
+        return kStatus_NoData;
+    }
+
+    *ptimestamp = rec->timestamp;
+    *pdata      = (const uint8_t *)(rec + 1);
+    *psize      = rec->size;
+    cursor->offset += MFLASH_TS_REC_SIZE(rec->size);
+
+    return kStatus_Success;
+}
+
+/* API - usage statistics */
+void mflash_ts_get_stats(mflash_ts_stats_t *stats)
+{
+    stats->sectors  = s_ts.sectors;
+    stats->used     = s_ts.used;
+    stats->first_ts = (s_ts.used != 0U) ? s_firstTs[s_ts.tail] : 0U;
+    stats->last_ts  = s_ts.last_ts;
+    stats->pages    = s_ts.pages;
+    stats->erases   = s_ts.erases;
+}
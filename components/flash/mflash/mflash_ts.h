@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __MFLASH_TS_H__
+#define __MFLASH_TS_H__
+
+#include "fsl_common.h"
+
+#include "mflash_drv.h"
+
+/*
+ * Time-series store for append-only records such as sensor samples
+ *
+ * Records carrying a timestamp are collected in a page sized RAM buffer, the buffer is programmed as whole page once
+ * the next record does not fit it (or on mflash_ts_flush). Pages fill a ring of sectors, the oldest sector is dropped
+ * when the ring is full. The sector ahead of the head is erased by mflash_ts_erase_ahead, to be called from idle time
+ * so that appends are bound by page program only. If it was not called, the append crossing to the next sector erases
+ * it on demand.
+ *
+ * Timestamps have to be non-decreasing. The timestamp of the first record of each sector is kept in RAM, seek is a
+ * binary search of these followed by a walk of single sector. Records are read through XIP, records still in the RAM
+ * buffer are read from there.
+ *
+ * Each page carries a CRC-32, pages programmed incompletely due to power loss are invalidated by mflash_ts_init.
+ */
+
+/* Physical address and size of the store unless resolved through the partition table, multiples of sector size */
+#ifndef MFLASH_TS_BASEADDR
+#define MFLASH_TS_BASEADDR (0x800000U)
+#endif
+
+#ifndef MFLASH_TS_SIZE
+#define MFLASH_TS_SIZE (0x400000U)
+#endif
+
+/* Maximum number of sectors, size of the RAM index is 4 bytes per sector */
+#ifndef MFLASH_TS_MAX_SECTORS
+#define MFLASH_TS_MAX_SECTORS (1024U)
+#endif
+
+/* Maximum record data size, the first page of a sector holds the sector header in addition to the page header */
+#define MFLASH_TS_DATA_MAX (MFLASH_PAGE_SIZE - 8U - 16U - 8U)
+
+/* Read position, valid across appends. Position in a sector dropped meanwhile moves to the oldest record. */
+typedef struct _mflash_ts_cursor
+{
+    uint32_t sector;   /* Sector of the record */
+    uint32_t sequence; /* Sequence number of the sector when the position was taken */
+    uint32_t offset;   /* Offset of the record in the sector */
+} mflash_ts_cursor_t;
+
+/* Usage statistics */
+typedef struct _mflash_ts_stats
+{
+    uint32_t sectors;  /* Sectors of the store */
+    uint32_t used;     /* Sectors holding records */
+    uint32_t first_ts; /* Timestamp of the oldest record */
+    uint32_t last_ts;  /* Timestamp of the newest record */
+    uint32_t pages;    /* Pages programmed since mflash_ts_init */
+    uint32_t erases;   /* Sectors erased since mflash_ts_init */
+} mflash_ts_stats_t;
+
+/*! @brief Initializes the store, the sector index is built from the sector headers. */
+status_t mflash_ts_init(bool init_drv);
+
+/*! @brief Appends record, kStatus_InvalidArgument if the timestamp is lower than the one of the previous record. */
+status_t mflash_ts_append(uint32_t timestamp, const void *data, uint32_t size);
+
+/*! @brief Programs the partially filled page buffer, further records start a new page. */
+status_t mflash_ts_flush(void);
+
+/*! @brief Erases the sector the head moves to next unless done already, drops the oldest sector if the ring is full */
+status_t mflash_ts_erase_ahead(void);
+
+/*! @brief Positions the cursor to the first record with timestamp equal or higher than the given one */
+status_t mflash_ts_seek(uint32_t timestamp, mflash_ts_cursor_t *cursor);
+
+/*! @brief Returns record at the cursor and advances it, kStatus_NoData past the newest record. The data pointer stays
+ * valid until the next append or until the sector is dropped. */
+status_t mflash_ts_next(mflash_ts_cursor_t *cursor, uint32_t *ptimestamp, const uint8_t **pdata, uint32_t *psize);
+
+/*! @brief Returns usage statistics */
+void mflash_ts_get_stats(mflash_ts_stats_t *stats);
+
+#endif
@@ -0,0 +1,420 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+
+#include "mflash_drv.h"
+#include "fsl_flexspi.h"
+#include "fsl_flexspi_nor_flash.h"
+#include "fsl_cache.h"
+
+/* Starting point of the SFDP probe, the device is expected in 1-1-1 mode. Copied to s_memConfig by each
+ * initialization as the probe replaces its content. */
+AT_QUICKACCESS_SECTION_DATA(static const flexspi_mem_config_t s_memConfigInit) = {
+    .deviceConfig =
+        {
+            .flexspiRootClk       = MFLASH_FLEXSPI_PROBE_CLK,
+            .flashSize            = MFLASH_BSIZE / 1024U, /* flash size in KB */
+            .CSIntervalUnit       = kFLEXSPI_CsIntervalUnit1SckCycle,
+            .CSInterval           = 2,
+            .CSHoldTime           = 3,
+            .CSSetupTime          = 3,
+            .dataValidTime        = 0,
+            .columnspace          = 0,
+            .enableWordAddress    = 0,
+            .AWRSeqIndex          = 0,
+            .AWRSeqNumber         = 0,
+            .ARDSeqIndex          = NOR_CMD_LUT_SEQ_IDX_READ,
+            .ARDSeqNumber         = 1,
+            .AHBWriteWaitUnit     = kFLEXSPI_AhbWriteWaitUnit2AhbCycle,
+            .AHBWriteWaitInterval = 0,
+        },
+    .devicePort      = MFLASH_FLEXSPI_PORT,
+    .deviceType      = kSerialNorCfgOption_DeviceType_ReadSFDP_SDR,
+    .quadMode        = kSerialNorQuadMode_NotConfig,
+    .transferMode    = kSerialNorTransferMode_SDR,
+    .enhanceMode     = kSerialNorEnhanceMode_Disabled,
+    .commandPads     = kFLEXSPI_1PAD,
+    .queryPads       = kFLEXSPI_1PAD,
+    .statusOverride  = 0,
+    .busyOffset      = 0,
+    .busyBitPolarity = 0,
+    .forceProbe      = false,
+};
+
+static flexspi_mem_config_t s_memConfig;
+
+static nor_config_t s_norConfig = {
+    .memControlConfig = &s_memConfig,
+    .driverBaseAddr   = MFLASH_FLEXSPI,
+};
+
+static nor_handle_t s_norHandle;
+static bool s_norReady = false;
+
+/* Erase unit of Nor_Flash_Erase_Block, 0 if it is not usable as multiple of MFLASH_SECTOR_SIZE */
+static uint32_t s_blockSize = 0U;
+
+MFLASH_RAMFUNC(static int32_t mflash_drv_init_internal(void))
+{
+    uint32_t primask = __get_PRIMASK();
+    status_t status;
+
+    __asm("cpsid i");
+
+    s_norReady = false;
+
+    /* Word copy, library memcpy may reside in FLASH */
+    for (uint32_t i = 0U; i < (sizeof(s_memConfig) / sizeof(uint32_t)); i++)
+    {
+        ((uint32_t *)(void *)&s_memConfig)[i] = ((const uint32_t *)(const void *)&s_memConfigInit)[i];
+    }
+
+#if defined(MFLASH_FLEXSPI_SET_CLOCK)
+    MFLASH_FLEXSPI_SET_CLOCK(MFLASH_FLEXSPI_PROBE_CLK);
+#endif
+
+    status = Nor_Flash_Init(&s_norConfig, &s_norHandle);
+
+#if defined(MFLASH_FLEXSPI_SET_CLOCK)
+    /* Full speed for the operation, the sampling/DLL settings are recalculated for it */
+    MFLASH_FLEXSPI_SET_CLOCK(MFLASH_FLEXSPI_ROOT_CLK);
+    s_memConfig.deviceConfig.flexspiRootClk = MFLASH_FLEXSPI_ROOT_CLK;
+    FLEXSPI_SetFlashConfig(MFLASH_FLEXSPI, &s_memConfig.deviceConfig, s_memConfig.devicePort);
+#endif
+
+    /* mflash units have to consist of whole device pages/sectors */
+    if ((kStatus_Success == status) &&
+        ((s_norHandle.bytesInSectorSize == 0U) || (s_norHandle.bytesInSectorSize > MFLASH_SECTOR_SIZE) ||
+         ((MFLASH_SECTOR_SIZE % s_norHandle.bytesInSectorSize) != 0U) || (s_norHandle.bytesInPageSize == 0U)))
+    {
+        status = kStatus_Fail;
+    }
+
+    s_norReady  = (kStatus_Success == status);
+    s_blockSize = s_norReady ? s_memConfig.bytesInBlockSize : 0U;
+
+    /* Block erase of other size than whole mflash sectors falls back to sector erases */
+    if ((s_blockSize <= MFLASH_SECTOR_SIZE) || ((s_blockSize % MFLASH_SECTOR_SIZE) != 0U))
+    {
+        s_blockSize = 0U;
+    }
+
+    /* Lines fetched while FLEXSPI was being reconfigured can not be trusted. */
+    CACHE64_InvalidateCache(CACHE64_CTRL0);
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+
+    return status;
+}
+
+/* API - initialize 'mflash' */
+int32_t mflash_drv_init(void)
+{
+    /* Necessary to have double wrapper call in non_xip memory */
+    return mflash_drv_init_internal();
+}
+
+/* Internal - erase single mflash sector or block, aligned by the caller */
+MFLASH_RAMFUNC(static int32_t mflash_drv_erase_internal(uint32_t addr, uint32_t len))
+{
+    status_t status  = kStatus_Success;
+    uint32_t primask = __get_PRIMASK();
+    uint32_t offset  = addr;
+    uint32_t end     = addr + len;
+
+    __asm("cpsid i");
+
+    if ((s_blockSize != 0U) && (len == s_blockSize))
+    {
+        status = Nor_Flash_Erase_Block(&s_norHandle, offset);
+    }
+    else
+    {
+        /* mflash sector may consist of multiple device sectors */
+        while ((kStatus_Success == status) && (offset < end))
+        {
+            status = Nor_Flash_Erase_Sector(&s_norHandle, offset);
+            offset += s_norHandle.bytesInSectorSize;
+        }
+    }
+
+    CACHE64_InvalidateCacheByRange(MFLASH_BASE_ADDRESS + addr, len);
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+
+    /* Flush pipeline to allow pending interrupts take place
+     * before starting next loop */
+    __ISB();
+
+    return status;
+}
+
+/* Calling wrapper for 'mflash_drv_erase_internal'.
+ * Erase one sector starting at 'sector_addr' - must be sector aligned.
+ */
+int32_t mflash_drv_sector_erase(uint32_t sector_addr)
+{
+    if (0 == mflash_drv_is_sector_aligned(sector_addr))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (!s_norReady)
+    {
+        return kStatus_Fail;
+    }
+
+    return mflash_drv_erase_internal(sector_addr, MFLASH_SECTOR_SIZE);
+}
+
+/* Calling wrapper for 'mflash_drv_erase_internal'.
+ * Erase 'len' bytes starting at 'addr' - both must be sector aligned.
+ * The interrupts are re-enabled in between of sectors/blocks when called for large area.
+ */
+int32_t mflash_drv_erase(uint32_t addr, uint32_t len)
+{
+    int32_t status = kStatus_Success;
+    uint32_t chunk;
+
+    if ((0 == mflash_drv_is_sector_aligned(addr)) || (0 == mflash_drv_is_sector_aligned(len)))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (!s_norReady)
+    {
+        return kStatus_Fail;
+    }
+
+    while ((kStatus_Success == status) && (len > 0U))
+    {
+        /* Whole block if aligned, otherwise single sector */
+        chunk = ((s_blockSize != 0U) && ((addr % s_blockSize) == 0U) && (len >= s_blockSize)) ? s_blockSize :
+                                                                                               MFLASH_SECTOR_SIZE;
+        assert((addr % chunk) == 0U);
+        status = mflash_drv_erase_internal(addr, chunk);
+        addr += chunk;
+        len -= chunk;
+    }
+
+    return status;
+}
+
+/* Internal - write single page */
+MFLASH_RAMFUNC(static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data))
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __asm("cpsid i");
+
+    status_t status;
+    /* Split by the NOR component if the device page is smaller */
+    status = Nor_Flash_Program(&s_norHandle, page_addr, (uint8_t *)data, MFLASH_PAGE_SIZE);
+
+    /* Do software reset. */
+    FLEXSPI_SoftwareReset(MFLASH_FLEXSPI);
+
+    CACHE64_InvalidateCacheByRange(MFLASH_BASE_ADDRESS + page_addr, MFLASH_PAGE_SIZE);
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+
+    /* Flush pipeline to allow pending interrupts take place
+     * before starting next loop */
+    __ISB();
+
+    return status;
+}
+
+/* Internal - read data */
+MFLASH_RAMFUNC(static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len))
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __asm("cpsid i");
+
+    status_t status;
+    /* IP read uses the read sequence of the probe, the same as XIP */
+    status = Nor_Flash_Read(&s_norHandle, addr, (uint8_t *)buffer, len);
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+
+    /* Flush pipeline to allow pending interrupts take place
+     * before starting next loop */
+    __ISB();
+
+    return status;
+}
+
+/* Calling wrapper for 'mflash_drv_page_program_internal'.
+ * Write 'data' to 'page_addr' - must be page aligned.
+ * NOTE: Don't try to store constant data that are located in XIP !!
+ */
+int32_t mflash_drv_page_program(uint32_t page_addr, uint32_t *data)
+{
+    if (0 == mflash_drv_is_page_aligned(page_addr))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (!s_norReady)
+    {
+        return kStatus_Fail;
+    }
+
+    return mflash_drv_page_program_internal(page_addr, data);
+}
+
+/* API - Read data */
+int32_t mflash_drv_read(uint32_t addr, uint32_t *buffer, uint32_t len)
+{
+    /* Check alignment */
+    if ((((uint32_t)buffer % 4U) != 0U) || ((len % 4U) != 0U))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (!s_norReady)
+    {
+        return kStatus_Fail;
+    }
+
+    return mflash_drv_read_internal(addr, buffer, len);
+}
+
+/* API - NOR component handle */
+nor_handle_t *mflash_drv_get_nor_handle(void)
+{
+    return s_norReady ? &s_norHandle : NULL;
+}
+
+/* API - size of the FLASH device */
+uint32_t mflash_drv_get_size(void)
+{
+    return s_norReady ? s_norHandle.bytesInMemorySize : 0U;
+}
+
+/* API - erase unit of the block erase */
+uint32_t mflash_drv_get_block_size(void)
+{
+    return s_blockSize;
+}
+
+/* Returns pointer (AHB address) to memory area where the specified region of FLASH is mapped, NULL on failure (could
+ * not map continuous block) */
+void *mflash_drv_phys2log(uint32_t addr, uint32_t len)
+{
+    /* take FLEXSPI remapping into account */
+    uint32_t remap_offset = MFLASH_REMAP_OFFSET();
+    uint32_t remap_start  = MFLASH_REMAP_START();
+    uint32_t remap_end    = MFLASH_REMAP_END();
+    uint32_t bus_addr;
+
+    do
+    {
+        if ((addr >= MFLASH_BSIZE) || (s_norReady && (addr >= s_norHandle.bytesInMemorySize)))
+        {
+            bus_addr = 0UL;
+            break;
+        }
+        /* calculate the bus address where the requested FLASH region is expected to be available */
+        bus_addr = addr + MFLASH_BASE_ADDRESS;
+
+        if ((remap_offset == 0UL) || (remap_end <= remap_start))
+        {
+            /* remapping is not active */
+            break;
+        }
+
+        if ((remap_start >= bus_addr + len) || (remap_end <= bus_addr))
+        {
+            /* remapping window does not collide with bus addresses normally assigned for requested range of FLASH */
+            break;
+        }
+
+        if ((remap_start + remap_offset <= bus_addr) && (remap_end + remap_offset >= bus_addr + len))
+        {
+            /* remapping window covers the whole requested range of FLASH, return address adjusted by negative offset */
+            bus_addr -= remap_offset;
+            break;
+        }
+        bus_addr = 0UL;
+        /* the bus address region normally assigned for requested range of FLASH is partially or completely shadowed by
+         * remapping, fail */
+
+    } while (false);
+
+    return (void *)bus_addr;
+}
+
+/* Returns address of physical memory where the area accessible by given pointer is actually stored, UINT32_MAX on
+ * failure (could not map as continuous block) */
+uint32_t mflash_drv_log2phys(void *ptr, uint32_t len)
+{
+    /* take FLEXSPI remapping into account */
+    uint32_t remap_offset = MFLASH_REMAP_OFFSET();
+    uint32_t remap_start  = MFLASH_REMAP_START();
+    uint32_t remap_end    = MFLASH_REMAP_END();
+    uint32_t ret          = UINT32_MAX;
+
+    /* calculate the bus address where the requested FLASH region is expected to be available */
+    do
+    {
+        uint32_t bus_addr = (uint32_t)ptr;
+
+        if (bus_addr < MFLASH_BASE_ADDRESS)
+        {
+            /* the pointer points outside of the flash memory area */
+            break;
+        }
+
+        ret = (bus_addr - MFLASH_BASE_ADDRESS);
+
+        if ((ret >= MFLASH_BSIZE) || (s_norReady && (ret >= s_norHandle.bytesInMemorySize)))
+        {
+            /* the pointer points beyond the flash memory area */
+            ret = UINT32_MAX;
+            break;
+        }
+
+        if ((remap_offset == 0UL) || (remap_end <= remap_start))
+        {
+            /* remapping is not active */
+            break;
+        }
+
+        if ((remap_start >= bus_addr + len) || (remap_end <= bus_addr))
+        {
+            /* remapping window does not affect the requested memory area */
+            break;
+        }
+
+        if ((remap_start <= bus_addr) && (remap_end >= bus_addr + len))
+        {
+            /* remapping window covers the whole address range, return address adjusted by offset */
+            ret += remap_offset;
+            break;
+        }
+
+        ret = UINT32_MAX;
+        /* the bus address region partially collides with the remapping window, hence the range is not mapped to
+         * continuous block in the FLASH, fail */
+    } while (false);
+
+    return ret;
+}
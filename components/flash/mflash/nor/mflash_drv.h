@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __MFLASH_DRV_H__
+#define __MFLASH_DRV_H__
+
+#include "mflash_common.h"
+#include "fsl_nor_flash.h"
+
+/*
+ * mflash backend built on the generic NOR FLASH component (Nor_Flash_* API, fsl_flexspi_nor_flash)
+ *
+ * Unlike the board specific drivers with hand written LUT, the device is probed through SFDP by mflash_drv_init, so
+ * the geometry, fast read mode (used for both IP reads and XIP) and erase commands are taken from the device itself.
+ * The probe reads SFDP, which devices specify up to 50MHz only. Define MFLASH_FLEXSPI_SET_CLOCK for the driver to
+ * run the probe at MFLASH_FLEXSPI_PROBE_CLK and raise the clock to MFLASH_FLEXSPI_ROOT_CLK afterwards, without it
+ * the board has to clock FLEXSPI at MFLASH_FLEXSPI_PROBE_CLK at most. Define FLEXSPI_NOR_CONFIG_CACHE and
+ * FLEXSPI_NOR_CONFIG_CACHE_OFFSET for the project to skip the probe on subsequent boots.
+ *
+ * The NOR component has to reside in RAM together with this driver, linker files place fsl_flexspi_nor_flash.o there.
+ */
+
+/* Flash constants, the unit of mflash API, the device may use smaller sectors/pages */
+#ifndef MFLASH_SECTOR_SIZE
+#define MFLASH_SECTOR_SIZE (4096U)
+#endif
+
+#ifndef MFLASH_PAGE_SIZE
+#define MFLASH_PAGE_SIZE (256U)
+#endif
+
+/* Device specific settings */
+#ifndef MFLASH_FLEXSPI
+#define MFLASH_FLEXSPI FLEXSPI
+#endif
+
+#ifndef MFLASH_FLEXSPI_PORT
+#define MFLASH_FLEXSPI_PORT kFLEXSPI_PortA1
+#endif
+
+/* FLEXSPI root clock of the SFDP probe */
+#ifndef MFLASH_FLEXSPI_PROBE_CLK
+#define MFLASH_FLEXSPI_PROBE_CLK (50000000UL)
+#endif
+
+/* FLEXSPI root clock after the probe, used only together with MFLASH_FLEXSPI_SET_CLOCK */
+#ifndef MFLASH_FLEXSPI_ROOT_CLK
+#define MFLASH_FLEXSPI_ROOT_CLK (130000000UL)
+#endif
+
+/* Optional board hook setting the FLEXSPI root clock to given frequency in Hz, it has to reside in RAM */
+/* #define MFLASH_FLEXSPI_SET_CLOCK(freq) */
+
+#define MFLASH_BASE_ADDRESS (FlexSPI_AMBA_PC_CACHE_BASE & 0x0fffffffU)
+
+/* Flash size in bytes as configured to FLEXSPI, actual size is reported by the device */
+#ifndef MFLASH_BSIZE
+#define MFLASH_BSIZE 0x04000000U
+#endif
+
+#define MFLASH_REMAP_OFFSET() (MFLASH_FLEXSPI->HADDROFFSET & FLEXSPI_HADDROFFSET_ADDROFFSET_MASK)
+#define MFLASH_REMAP_START()  (MFLASH_FLEXSPI->HADDRSTART & FLEXSPI_HADDRSTART_ADDRSTART_MASK)
+#define MFLASH_REMAP_END()    (MFLASH_FLEXSPI->HADDREND & FLEXSPI_HADDREND_ENDSTART_MASK)
+
+#define MFLASH_REMAP_ACTIVE() (MFLASH_REMAP_OFFSET() != 0UL)
+
+/* Identifies the backend, e.g. for benchmarks comparing it with the board specific drivers */
+#define MFLASH_DRV_NOR_COMPONENT (1)
+
+/*! @brief Erases area of arbitrary sector aligned length, block erase is used where possible */
+int32_t mflash_drv_erase(uint32_t addr, uint32_t len);
+
+/*! @brief Returns erase unit of the block erase command probed from SFDP, 0 if the area is erased by sectors only */
+uint32_t mflash_drv_get_block_size(void);
+
+/*! @brief Returns the NOR component handle for operations not covered by mflash API, NULL before initialization */
+nor_handle_t *mflash_drv_get_nor_handle(void);
+
+/*! @brief Returns size of the FLASH device in bytes as detected by the NOR component, 0 before initialization */
+uint32_t mflash_drv_get_size(void);
+
+#endif
@@ -1,33 +1,45 @@
 /*
- * Copyright 2017-2022, 2024 NXP
+ * Copyright 2017-2022, 2024, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "mflash_drv.h"
 #include "fsl_flexspi.h"
 #include "fsl_cache.h"
+#include "fsl_iped.h"
 
 #define FLASH_PORT kFLEXSPI_PortA1
 
-#define NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD     0
-#define NOR_CMD_LUT_SEQ_IDX_WRITESTATUSREG     1
-#define NOR_CMD_LUT_SEQ_IDX_WRITEENABLE        2
-#define NOR_CMD_LUT_SEQ_IDX_ERASESECTOR        3
-#define NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD   4
-#define NOR_CMD_LUT_SEQ_IDX_ERASECHIP          5
-#define NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_SINGLE 6
-#define NOR_CMD_LUT_SEQ_IDX_READ_NORMAL        7
-#define NOR_CMD_LUT_SEQ_IDX_READID             8
-#define NOR_CMD_LUT_SEQ_IDX_WRITE              9
-#define NOR_CMD_LUT_SEQ_IDX_ENTERQPI           10
-#define NOR_CMD_LUT_SEQ_IDX_EXITQPI            11
-#define NOR_CMD_LUT_SEQ_IDX_READSTATUSREG      12
-#define NOR_CMD_LUT_SEQ_IDX_READ_FAST          13
-
-#define CUSTOM_LUT_LENGTH        60
+/* Sequences of the FLASH LUT slice, see MFLASH_LUT_SEQ_BASE */
+#define NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD   (MFLASH_LUT_SEQ_BASE + 0U)
+#define NOR_CMD_LUT_SEQ_IDX_WRITESTATUSREG   (MFLASH_LUT_SEQ_BASE + 1U)
+#define NOR_CMD_LUT_SEQ_IDX_WRITEENABLE      (MFLASH_LUT_SEQ_BASE + 2U)
+#define NOR_CMD_LUT_SEQ_IDX_ERASESECTOR      (MFLASH_LUT_SEQ_BASE + 3U)
+#define NOR_CMD_LUT_SEQ_IDX_WRITEENABLE_PP   (MFLASH_LUT_SEQ_BASE + 4U)
+#define NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD (MFLASH_LUT_SEQ_BASE + 5U)
+#define NOR_CMD_LUT_SEQ_IDX_READID           (MFLASH_LUT_SEQ_BASE + 6U)
+#define NOR_CMD_LUT_SEQ_IDX_WRITE            (MFLASH_LUT_SEQ_BASE + 7U)
+#define NOR_CMD_LUT_SEQ_IDX_READSTATUSREG    (MFLASH_LUT_SEQ_BASE + 8U)
+
+#if (MFLASH_LUT_SEQ_BASE + MFLASH_LUT_SEQ_COUNT) > 16U
+#error "LUT slice of the FLASH does not fit the LUT"
+#endif
+
+/* Index of the first LUT entry of sequence within the slice */
+#define NOR_CMD_LUT_ENTRY(seq) (4U * ((seq) - MFLASH_LUT_SEQ_BASE))
+
+/*
+ * Write enable sequences directly precede the erase and program sequences in the LUT, so that both are issued by single
+ * IP command executing two consecutive sequences.
+ */
+#define NOR_CMD_LUT_SEQ_IDX_WREN_ERASESECTOR NOR_CMD_LUT_SEQ_IDX_WRITEENABLE
+#define NOR_CMD_LUT_SEQ_IDX_WREN_PAGEPROGRAM NOR_CMD_LUT_SEQ_IDX_WRITEENABLE_PP
+
+#define CUSTOM_LUT_LENGTH        (4U * MFLASH_LUT_SEQ_COUNT)
 #define FLASH_QUAD_ENABLE        0xC740
 #define FLASH_BUSY_STATUS_POL    1
 #define FLASH_BUSY_STATUS_OFFSET 0
@@ -50,94 +62,83 @@ static flexspi_device_config_t deviceconfig = {
     .AHBWriteWaitInterval = 0,
 };
 
-const uint32_t customLUT[CUSTOM_LUT_LENGTH] = {
-    /* Normal read mode -SDR */
-    [4 * NOR_CMD_LUT_SEQ_IDX_READ_NORMAL] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x13, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x20),
-    [4 * NOR_CMD_LUT_SEQ_IDX_READ_NORMAL + 1] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
-
-    /* Fast read mode - SDR */
-    [4 * NOR_CMD_LUT_SEQ_IDX_READ_FAST] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x0C, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x20),
-    [4 * NOR_CMD_LUT_SEQ_IDX_READ_FAST + 1] = FLEXSPI_LUT_SEQ(
-        kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_1PAD, 0x0A, kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04),
-
+AT_QUICKACCESS_SECTION_DATA(const uint32_t customLUT[CUSTOM_LUT_LENGTH]) = {
     /* Fast read quad mode - SDR */
-    [4 * NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0xEC, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_4PAD, 0x20),
-    [4 * NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD + 1] = FLEXSPI_LUT_SEQ(
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD) + 1U] = FLEXSPI_LUT_SEQ(
         kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_4PAD, 0x0A, kFLEXSPI_Command_READ_SDR, kFLEXSPI_4PAD, 0x04),
 
     /* Write Enable */
-    [4 * NOR_CMD_LUT_SEQ_IDX_WRITEENABLE] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_WRITEENABLE)] =
+        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x06, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
+
+    /* Write Enable - preceding page program */
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_WRITEENABLE_PP)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x06, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 
     /* Erase Sector  */
-    [4 * NOR_CMD_LUT_SEQ_IDX_ERASESECTOR] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_ERASESECTOR)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x21, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x20),
 
-    /* Page Program - single mode */
-    [4 * NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_SINGLE] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x12, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x20),
-    [4 * NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_SINGLE + 1] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_WRITE_SDR, kFLEXSPI_1PAD, 0x04, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
-
     /* Page Program - quad mode */
-    [4 * NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x3E, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_4PAD, 0x20),
-    [4 * NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD + 1] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD) + 1U] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_WRITE_SDR, kFLEXSPI_4PAD, 0x04, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 
     /* Read ID */
-    [4 * NOR_CMD_LUT_SEQ_IDX_READID] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_READID)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x9F, kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04),
 
     /* Write Status */
-    [4 * NOR_CMD_LUT_SEQ_IDX_WRITESTATUSREG] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_WRITESTATUSREG)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x01, kFLEXSPI_Command_WRITE_SDR, kFLEXSPI_1PAD, 0x04),
 
     /*  Dummy write, do nothing when AHB write command is triggered. */
-    [4 * NOR_CMD_LUT_SEQ_IDX_WRITE] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_WRITE)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0x0, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0x0),
 
-    /* Enter QPI mode */
-    [4 * NOR_CMD_LUT_SEQ_IDX_ENTERQPI] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x35, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
-
-    /* Exit QPI mode */
-    [4 * NOR_CMD_LUT_SEQ_IDX_EXITQPI] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_4PAD, 0xF5, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
-
     /* Read status register */
-    [4 * NOR_CMD_LUT_SEQ_IDX_READSTATUSREG] =
+    [NOR_CMD_LUT_ENTRY(NOR_CMD_LUT_SEQ_IDX_READSTATUSREG)] =
         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x05, kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04),
-
-    /* Erase whole chip */
-    [4 * NOR_CMD_LUT_SEQ_IDX_ERASECHIP] =
-        FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0xC7, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 };
 
-static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base)
+/* Internal - drop AHB RX buffer content of FLASH modified by IP command. Unlike software reset this leaves the AHB TX
+ * buffer, holding writes to the PSRAM, and the state of the other port alone. */
+MFLASH_RAMFUNC(static void flexspi_nor_clear_ahb_rx(FLEXSPI_Type *base))
+{
+    mflash_flexspi_wait_idle(base);
+    base->AHBCR |= FLEXSPI_AHBCR_CLRAHBRXBUF_MASK;
+    base->AHBCR &= ~FLEXSPI_AHBCR_CLRAHBRXBUF_MASK;
+}
+
+/* Internal - switch encryption of data written by IP commands, enabled only for the data phase of page programs to
+ * encrypted areas */
+MFLASH_RAMFUNC(static void flexspi_nor_ip_encrypt(FLEXSPI_Type *base, bool enable))
+{
+    if (enable)
+    {
+        base->IPEDCTRL |= FLEXSPI_IPEDCTRL_IPWR_EN_MASK | FLEXSPI_IPEDCTRL_IPGCMWR_MASK;
+    }
+    else
+    {
+        base->IPEDCTRL &= ~(FLEXSPI_IPEDCTRL_IPWR_EN_MASK | FLEXSPI_IPEDCTRL_IPGCMWR_MASK);
+    }
+}
+
+MFLASH_RAMFUNC(static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base))
 {
     /* Wait status ready. */
     bool isBusy;
     uint32_t readValue;
     status_t status;
-    flexspi_transfer_t flashXfer;
     bool busyStatus = (bool)FLASH_BUSY_STATUS_POL;
-
-    flashXfer.deviceAddress = 0;
-    flashXfer.port          = FLASH_PORT;
-    flashXfer.cmdType       = kFLEXSPI_Read;
-    flashXfer.SeqNumber     = 1;
-    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READSTATUSREG;
-    flashXfer.data          = &readValue;
-    flashXfer.dataSize      = 1;
+    uint32_t ipcr1  = mflash_flexspi_ipcr1(base, NOR_CMD_LUT_SEQ_IDX_READSTATUSREG, 1U);
 
     do
     {
-        status = FLEXSPI_TransferBlocking(base, &flashXfer);
+        status = FLEXSPI_ReadRegisterFast(base, 0, ipcr1, &readValue);
 
         if (status != kStatus_Success)
         {
@@ -171,7 +172,7 @@ static status_t flexspi_nor_wait_bus_busy(FLEXSPI_Type *base)
     return status;
 }
 
-static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr)
+MFLASH_RAMFUNC(static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr))
 {
     flexspi_transfer_t flashXfer;
     status_t status;
@@ -188,7 +189,7 @@ static status_t flexspi_nor_write_enable(FLEXSPI_Type *base, uint32_t baseAddr)
     return status;
 }
 
-static status_t flexspi_nor_enable_quad_mode(FLEXSPI_Type *base)
+MFLASH_RAMFUNC(static status_t flexspi_nor_enable_quad_mode(FLEXSPI_Type *base))
 {
     flexspi_transfer_t flashXfer;
     status_t status;
@@ -219,18 +220,50 @@ static status_t flexspi_nor_enable_quad_mode(FLEXSPI_Type *base)
 
     status = flexspi_nor_wait_bus_busy(base);
 
-    /* Do software reset. */
-    FLEXSPI_SoftwareReset(base);
+    flexspi_nor_clear_ahb_rx(base);
+
+    return status;
+}
+
+/* Internal - read JEDEC ID, manufacturer ID followed by memory type and capacity */
+MFLASH_RAMFUNC(static status_t flexspi_nor_read_id(FLEXSPI_Type *base, uint32_t *id))
+{
+    flexspi_transfer_t flashXfer;
+    status_t status;
+
+    *id = 0U;
+
+    flashXfer.deviceAddress = 0;
+    flashXfer.port          = FLASH_PORT;
+    flashXfer.cmdType       = kFLEXSPI_Read;
+    flashXfer.SeqNumber     = 1;
+    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READID;
+    flashXfer.data          = id;
+    flashXfer.dataSize      = 3;
+
+    status = FLEXSPI_TransferBlocking(base, &flashXfer);
+
+    /* Drop data left in the IP RX FIFO */
+    mflash_flexspi_clear_ip_rx(base);
 
     return status;
 }
 
 /* Internal - erase single sector */
-static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t address)
+MFLASH_RAMFUNC(static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t address))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
 
+#if defined(MFLASH_DRV_FUSED_SEQUENCES) && MFLASH_DRV_FUSED_SEQUENCES
+    /* Write enable and erase */
+    flashXfer.deviceAddress = address;
+    flashXfer.port          = FLASH_PORT;
+    flashXfer.cmdType       = kFLEXSPI_Command;
+    flashXfer.SeqNumber     = 2;
+    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_WREN_ERASESECTOR;
+    status                  = FLEXSPI_TransferBlocking(base, &flashXfer);
+#else
     /* Write enable */
     flashXfer.deviceAddress = address;
     flashXfer.port          = FLASH_PORT;
@@ -251,6 +284,7 @@ static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t addr
     flashXfer.SeqNumber     = 1;
     flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_ERASESECTOR;
     status                  = FLEXSPI_TransferBlocking(base, &flashXfer);
+#endif
 
     if (status != kStatus_Success)
     {
@@ -259,17 +293,33 @@ static status_t flexspi_nor_flash_sector_erase(FLEXSPI_Type *base, uint32_t addr
 
     status = flexspi_nor_wait_bus_busy(base);
 
-    /* Do software reset. */
-    FLEXSPI_SoftwareReset(base);
+    flexspi_nor_clear_ahb_rx(base);
 
     return status;
 }
 
-static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstAddr, const uint32_t *src)
+MFLASH_RAMFUNC(static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base,
+                                                              uint32_t dstAddr,
+                                                              const uint32_t *src,
+                                                              bool encrypt))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
 
+#if defined(MFLASH_DRV_FUSED_SEQUENCES) && MFLASH_DRV_FUSED_SEQUENCES
+    /* No need to wait for the device to be idle here, every operation of this driver returns only after the device
+     * became ready. Write enable and page program are then issued by single IP command. */
+    flashXfer.deviceAddress = dstAddr;
+    flashXfer.port          = FLASH_PORT;
+    flashXfer.cmdType       = kFLEXSPI_Write;
+    flashXfer.SeqNumber     = 2;
+    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_WREN_PAGEPROGRAM;
+    flashXfer.data          = (uint32_t *)(uintptr_t)src;
+    flashXfer.dataSize      = MFLASH_PAGE_SIZE;
+    flexspi_nor_ip_encrypt(base, encrypt);
+    status = FLEXSPI_TransferBlocking(base, &flashXfer);
+    flexspi_nor_ip_encrypt(base, false);
+#else
     /* To make sure external flash be in idle status, added wait for busy before program data for
         an external flash without RWW(read while write) attribute.*/
     status = flexspi_nor_wait_bus_busy(base);
@@ -295,7 +345,10 @@ static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstA
     flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD;
     flashXfer.data          = (uint32_t *)(uintptr_t)src;
     flashXfer.dataSize      = MFLASH_PAGE_SIZE;
-    status                  = FLEXSPI_TransferBlocking(base, &flashXfer);
+    flexspi_nor_ip_encrypt(base, encrypt);
+    status = FLEXSPI_TransferBlocking(base, &flashXfer);
+    flexspi_nor_ip_encrypt(base, false);
+#endif
 
     if (status != kStatus_Success)
     {
@@ -304,19 +357,15 @@ static status_t flexspi_nor_flash_page_program(FLEXSPI_Type *base, uint32_t dstA
 
     status = flexspi_nor_wait_bus_busy(base);
 
-    /* Do software reset or clear AHB buffer directly. */
-#if defined(FSL_FEATURE_SOC_OTFAD_COUNT) && defined(FLEXSPI_AHBCR_CLRAHBRXBUF_MASK) && \
-    defined(FLEXSPI_AHBCR_CLRAHBTXBUF_MASK)
-    base->AHBCR |= FLEXSPI_AHBCR_CLRAHBRXBUF_MASK | FLEXSPI_AHBCR_CLRAHBTXBUF_MASK;
-    base->AHBCR &= ~(FLEXSPI_AHBCR_CLRAHBRXBUF_MASK | FLEXSPI_AHBCR_CLRAHBTXBUF_MASK);
-#else
-    FLEXSPI_SoftwareReset(base);
-#endif
+    flexspi_nor_clear_ahb_rx(base);
 
     return status;
 }
 
-static status_t flexspi_nor_read_data(FLEXSPI_Type *base, uint32_t startAddress, uint32_t *buffer, uint32_t length)
+MFLASH_RAMFUNC(static status_t flexspi_nor_read_data(FLEXSPI_Type *base,
+                                                     uint32_t startAddress,
+                                                     uint32_t *buffer,
+                                                     uint32_t length))
 {
     status_t status;
     flexspi_transfer_t flashXfer;
@@ -341,10 +390,717 @@ static status_t flexspi_nor_read_data(FLEXSPI_Type *base, uint32_t startAddress,
     return status;
 }
 
-static int32_t mflash_drv_init_internal(void)
+/* Cache controller and its policy selector in front of FLEXSPI */
+#define MFLASH_CACHE        CACHE64_CTRL0
+#define MFLASH_CACHE_POLSEL CACHE64_POLSEL0
+
+/* Area of FLASH (AHB addresses) pending cache invalidation while batch is open, end is 0 if there is none */
+static uint32_t s_cacheBatchDepth;
+static uint32_t s_cachePendingStart;
+static uint32_t s_cachePendingEnd;
+
+/* Internal - get index of cache policy region containing given offset within FLEXSPI AHB space */
+MFLASH_RAMFUNC(static uint32_t mflash_drv_cache_region(uint32_t offset))
+{
+    /* Region top registers hold the address of the last 1KB block belonging to the region */
+    if (offset <= (MFLASH_CACHE_POLSEL->REG0_TOP | (CACHE64_REGION_ALIGNMENT - 1U)))
+    {
+        return 0U;
+    }
+    if (offset <= (MFLASH_CACHE_POLSEL->REG1_TOP | (CACHE64_REGION_ALIGNMENT - 1U)))
+    {
+        return 1U;
+    }
+    return 2U;
+}
+
+/* Internal - check whether CACHE64 may hold any line of given area of FLEXSPI AHB space */
+MFLASH_RAMFUNC(static bool mflash_drv_cache_is_cached(uint32_t offset, uint32_t len))
+{
+    uint32_t region;
+    uint32_t last;
+
+    /* Disabled cache is invalidated as whole once it gets enabled again */
+    if ((MFLASH_CACHE->CCR & CACHE64_CTRL_CCR_ENCACHE_MASK) == 0U)
+    {
+        return false;
+    }
+
+    last = mflash_drv_cache_region(offset + len - 1U);
+    for (region = mflash_drv_cache_region(offset); region <= last; region++)
+    {
+        if (((MFLASH_CACHE_POLSEL->POLSEL >> (2U * region)) & 0x3U) != (uint32_t)kCACHE64_PolicyNonCacheable)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Internal - invalidate pending area of the batch */
+MFLASH_RAMFUNC(static void mflash_drv_cache_flush_pending(void))
+{
+    if (s_cachePendingEnd != 0U)
+    {
+        CACHE64_InvalidateCacheByRange(s_cachePendingStart, s_cachePendingEnd - s_cachePendingStart);
+        s_cachePendingEnd = 0U;
+    }
+}
+
+/* Internal - drop cached content of erased/programmed area of FLASH, to be called with interrupts disabled */
+MFLASH_RAMFUNC(static void mflash_drv_cache_invalidate(uint32_t addr, uint32_t len))
+{
+    uint32_t bus_addr;
+
+    if (addr >= MFLASH_BSIZE)
+    {
+        /* Not mapped to AHB at all */
+        return;
+    }
+
+    /* Lines are tagged by AHB address, take FLEXSPI remapping into account */
+    bus_addr = (uint32_t)(uintptr_t)mflash_drv_phys2log(addr, len);
+    if (bus_addr == 0U)
+    {
+        /* Partially shadowed by remapping, stay on the safe side */
+        bus_addr = MFLASH_BASE_ADDRESS + addr;
+    }
+
+    if (!mflash_drv_cache_is_cached(bus_addr - MFLASH_BASE_ADDRESS, len))
+    {
+        return;
+    }
+
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    if (s_cacheBatchDepth != 0U)
+    {
+        /* Merge overlapping or adjacent areas, invalidate the pending one first otherwise */
+        if ((s_cachePendingEnd != 0U) && ((bus_addr > s_cachePendingEnd) || ((bus_addr + len) < s_cachePendingStart)))
+        {
+            mflash_drv_cache_flush_pending();
+        }
+
+        if (s_cachePendingEnd == 0U)
+        {
+            s_cachePendingStart = bus_addr;
+            s_cachePendingEnd   = bus_addr + len;
+        }
+        else
+        {
+            s_cachePendingStart = MIN(s_cachePendingStart, bus_addr);
+            s_cachePendingEnd   = MAX(s_cachePendingEnd, bus_addr + len);
+        }
+        return;
+    }
+#endif
+
+    CACHE64_InvalidateCacheByRange(bus_addr, len);
+}
+
+/* API - defer cache invalidation */
+void mflash_drv_cache_batch_begin(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __asm("cpsid i");
+
+    s_cacheBatchDepth++;
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+}
+
+/* API - invalidate areas modified within the batch */
+void mflash_drv_cache_batch_end(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __asm("cpsid i");
+
+    if (s_cacheBatchDepth != 0U)
+    {
+        s_cacheBatchDepth--;
+        if (s_cacheBatchDepth == 0U)
+        {
+            mflash_drv_cache_flush_pending();
+        }
+    }
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+}
+
+#if (MFLASH_ENCRYPT_FIRST_REGION + MFLASH_ENCRYPT_AREAS) > IPED_REGION_COUNT
+#error "Encrypted areas do not fit the IPED regions"
+#endif
+
+/* Area of FLASH encrypted by IPED region MFLASH_ENCRYPT_FIRST_REGION + index of the entry, len is 0 if unused */
+typedef struct _mflash_encrypt_area
+{
+    uint32_t addr;
+    uint32_t len;
+    uint8_t iv[8];
+} mflash_encrypt_area_t;
+
+static mflash_encrypt_area_t s_encryptAreas[MFLASH_ENCRYPT_AREAS];
+
+/* Internal - set area of the entry and program its IPED region, content of the FLASH covered by the area before and
+ * after the update is dropped from the AHB RX buffers and the cache */
+static status_t mflash_drv_encrypt_update(uint32_t index, uint32_t addr, uint32_t len, const uint8_t *iv)
+{
+    FLEXSPI_Type *base          = MFLASH_FLEXSPI;
+    iped_region_t region        = MFLASH_ENCRYPT_FIRST_REGION + index;
+    mflash_encrypt_area_t *area = &s_encryptAreas[index];
+    uint32_t primask            = __get_PRIMASK();
+    status_t status;
+
+    __asm("cpsid i");
+
+    status = IPED_SetRegionEnable(base, region, false);
+    if (status == kStatus_Success)
+    {
+        if (area->len != 0U)
+        {
+            mflash_drv_cache_invalidate(area->addr, area->len);
+        }
+
+        area->addr = addr;
+        area->len  = len;
+        if ((iv != NULL) && (iv != area->iv))
+        {
+            (void)memcpy(area->iv, iv, sizeof(area->iv));
+        }
+    }
+
+    if ((status == kStatus_Success) && (len != 0U))
+    {
+        IPED_SetRegionIV(base, region, area->iv);
+        /* End address is the start of the last 256 byte block of the area */
+        status = IPED_SetRegionAddressRange(base, region, MFLASH_BASE_ADDRESS + addr,
+                                            MFLASH_BASE_ADDRESS + addr + len - MFLASH_PAGE_SIZE);
+        if (status == kStatus_Success)
+        {
+            status = IPED_SetRegionEnable(base, region, true);
+        }
+        if (status == kStatus_Success)
+        {
+            /* Same as IPED_EncryptEnable, which would also override the AHB read options of the board profile */
+            base->IPEDCTRL |= FLEXSPI_IPEDCTRL_IPED_EN_MASK | FLEXSPI_IPEDCTRL_AHBWR_EN_MASK |
+                              FLEXSPI_IPEDCTRL_AHBRD_EN_MASK | FLEXSPI_IPEDCTRL_AHGCMWR_MASK |
+                              FLEXSPI_IPEDCTRL_AHBGCMRD_MASK;
+            mflash_drv_cache_invalidate(addr, len);
+        }
+        else
+        {
+            area->len = 0U;
+        }
+    }
+
+    flexspi_nor_clear_ahb_rx(base);
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+
+    return status;
+}
+
+/* API - check whether area overlaps any encrypted one */
+MFLASH_RAMFUNC(bool mflash_drv_is_encrypted(uint32_t addr, uint32_t len))
+{
+    for (uint32_t i = 0U; i < MFLASH_ENCRYPT_AREAS; i++)
+    {
+        const mflash_encrypt_area_t *area = &s_encryptAreas[i];
+
+        if ((area->len != 0U) && (addr < area->addr + area->len) && (area->addr < addr + len))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+/* States of the asynchronous operation */
+typedef enum _mflash_async_state
+{
+    kMflashAsync_Idle = 0U,   /* No operation in progress */
+    kMflashAsync_WriteEnable, /* Write enable command in progress (interrupt driven) */
+    kMflashAsync_Command,     /* Erase or program command in progress (interrupt driven) */
+    kMflashAsync_StatusRead,  /* Device busy, status read issued and picked up by the tick */
+    kMflashAsync_Read,        /* Read transfer in progress (interrupt driven) */
+} mflash_async_state_t;
+
+/* Context of the asynchronous operation */
+typedef struct _mflash_async_op
+{
+    volatile uint32_t state;
+    uint32_t seq_index; /* LUT sequence of the erase/program command, write enable sequence if these are fused */
+    uint32_t addr;
+    uint32_t *data;
+    uint32_t size; /* Data size of the transfer, size of the affected area for erase */
+    mflash_drv_callback_t callback;
+    void *user_data;
+} mflash_async_op_t;
+
+static flexspi_handle_t s_asyncHandle;
+static mflash_async_op_t s_asyncOp;
+
+/* Internal - start interrupt driven transfer */
+MFLASH_RAMFUNC(static status_t mflash_drv_async_transfer(flexspi_command_type_t cmd_type,
+                                                         uint32_t seq_index,
+                                                         uint32_t seq_number,
+                                                         uint32_t addr,
+                                                         uint32_t *data,
+                                                         uint32_t size))
+{
+    flexspi_transfer_t flashXfer;
+
+    flashXfer.deviceAddress = addr;
+    flashXfer.port          = FLASH_PORT;
+    flashXfer.cmdType       = cmd_type;
+    flashXfer.SeqNumber     = (uint8_t)seq_number;
+    flashXfer.seqIndex      = seq_index;
+    flashXfer.data          = data;
+    flashXfer.dataSize      = size;
+
+    return FLEXSPI_TransferNonBlocking(MFLASH_FLEXSPI, &s_asyncHandle, &flashXfer);
+}
+
+/* Internal - trigger status register read, no interrupt is used as the result is picked up by the next tick */
+MFLASH_RAMFUNC(static void mflash_drv_async_status_start(FLEXSPI_Type *base))
+{
+    base->FLSHCR2[FLASH_PORT] |= FLEXSPI_FLSHCR2_CLRINSTRPTR_MASK;
+    base->INTR = FLEXSPI_INTR_IPCMDERR_MASK | FLEXSPI_INTR_IPCMDGE_MASK | FLEXSPI_INTR_IPCMDDONE_MASK |
+                 FLEXSPI_INTR_SEQTIMEOUT_MASK;
+    base->IPCR0 = 0;
+    mflash_flexspi_clear_ip_rx(base);
+    base->IPCR1 = mflash_flexspi_ipcr1(base, NOR_CMD_LUT_SEQ_IDX_READSTATUSREG, 1U);
+    base->IPCMD |= FLEXSPI_IPCMD_TRG_MASK;
+}
+
+/* Internal - finish the operation and notify the caller */
+MFLASH_RAMFUNC(static void mflash_drv_async_complete(status_t status))
+{
+    FLEXSPI_Type *base             = MFLASH_FLEXSPI;
+    mflash_drv_callback_t callback = s_asyncOp.callback;
+    void *user_data                = s_asyncOp.user_data;
+
+    if (s_asyncOp.state == (uint32_t)kMflashAsync_Read)
+    {
+        /* Drop data left in the IP RX FIFO */
+        mflash_flexspi_clear_ip_rx(base);
+    }
+    else
+    {
+        /* Device is ready, FLASH content may be accessed again */
+        flexspi_nor_ip_encrypt(base, false);
+        flexspi_nor_clear_ahb_rx(base);
+        mflash_drv_cache_invalidate(s_asyncOp.addr, s_asyncOp.size);
+    }
+
+    /* Release the driver before calling back so that the next operation may be started from the callback */
+    s_asyncOp.state = (uint32_t)kMflashAsync_Idle;
+
+    if (callback != NULL)
+    {
+        callback(status, user_data);
+    }
+}
+
+/* Internal - FLEXSPI transfer completion, called from the FLEXSPI interrupt handler */
+MFLASH_RAMFUNC(static void mflash_drv_async_callback(FLEXSPI_Type *base,
+                                                     flexspi_handle_t *handle,
+                                                     status_t status,
+                                                     void *userData))
+{
+    if (status != kStatus_Success)
+    {
+        mflash_drv_async_complete(status);
+        return;
+    }
+
+    switch (s_asyncOp.state)
+    {
+        case (uint32_t)kMflashAsync_WriteEnable:
+            /* Write enabled, issue the erase/program command itself */
+            s_asyncOp.state = (uint32_t)kMflashAsync_Command;
+            status          = mflash_drv_async_transfer(
+                (s_asyncOp.data != NULL) ? kFLEXSPI_Write : kFLEXSPI_Command, s_asyncOp.seq_index, 1U,
+                s_asyncOp.addr, s_asyncOp.data, (s_asyncOp.data != NULL) ? s_asyncOp.size : 0U);
+            if (status != kStatus_Success)
+            {
+                mflash_drv_async_complete(status);
+            }
+            break;
+
+        case (uint32_t)kMflashAsync_Command:
+            /* Device became busy, from now on it is only polled */
+            s_asyncOp.state = (uint32_t)kMflashAsync_StatusRead;
+            mflash_drv_async_status_start(base);
+            break;
+
+        case (uint32_t)kMflashAsync_Read:
+            mflash_drv_async_complete(kStatus_Success);
+            break;
+
+        default:
+            /* Not expected */
+            break;
+    }
+}
+
+/* Internal - claim the driver for new operation */
+MFLASH_RAMFUNC(static int32_t mflash_drv_async_start(uint32_t state,
+                                                     uint32_t seq_index,
+                                                     uint32_t addr,
+                                                     uint32_t *data,
+                                                     uint32_t size,
+                                                     mflash_drv_callback_t callback,
+                                                     void *user_data))
+{
+    status_t status;
+    uint32_t primask = __get_PRIMASK();
+
+    __asm("cpsid i");
+
+    if (s_asyncOp.state != (uint32_t)kMflashAsync_Idle)
+    {
+        if (primask == 0U)
+        {
+            __asm("cpsie i");
+        }
+        return kStatus_Busy;
+    }
+
+    s_asyncOp.state     = state;
+    s_asyncOp.seq_index = seq_index;
+    s_asyncOp.addr      = addr;
+    s_asyncOp.data      = data;
+    s_asyncOp.size      = size;
+    s_asyncOp.callback  = callback;
+    s_asyncOp.user_data = user_data;
+
+    /* Page program data is encrypted for the rest of the operation */
+    if ((state != (uint32_t)kMflashAsync_Read) && (data != NULL))
+    {
+        flexspi_nor_ip_encrypt(MFLASH_FLEXSPI, mflash_drv_is_encrypted(addr, size));
+    }
+
+    if (state == (uint32_t)kMflashAsync_Read)
+    {
+        status = mflash_drv_async_transfer(kFLEXSPI_Read, seq_index, 1U, addr, data, size);
+    }
+    else if (state == (uint32_t)kMflashAsync_WriteEnable)
+    {
+        status = mflash_drv_async_transfer(kFLEXSPI_Command, NOR_CMD_LUT_SEQ_IDX_WRITEENABLE, 1U, addr, NULL, 0U);
+    }
+    else
+    {
+        /* Write enable sequence followed by the erase/program sequence */
+        status = mflash_drv_async_transfer((data != NULL) ? kFLEXSPI_Write : kFLEXSPI_Command, seq_index, 2U, addr,
+                                           data, (data != NULL) ? size : 0U);
+    }
+
+    if (status != kStatus_Success)
+    {
+        flexspi_nor_ip_encrypt(MFLASH_FLEXSPI, false);
+        s_asyncOp.state = (uint32_t)kMflashAsync_Idle;
+    }
+
+    if (primask == 0U)
+    {
+        __asm("cpsie i");
+    }
+
+    return status;
+}
+
+/* API - start erase of single sector */
+int32_t mflash_drv_sector_erase_async(uint32_t sector_addr, mflash_drv_callback_t callback, void *user_data)
+{
+    if (0 == mflash_drv_is_sector_aligned(sector_addr))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+#if defined(MFLASH_DRV_FUSED_SEQUENCES) && MFLASH_DRV_FUSED_SEQUENCES
+    return mflash_drv_async_start((uint32_t)kMflashAsync_Command, NOR_CMD_LUT_SEQ_IDX_WREN_ERASESECTOR, sector_addr,
+                                  NULL, MFLASH_SECTOR_SIZE, callback, user_data);
+#else
+    return mflash_drv_async_start((uint32_t)kMflashAsync_WriteEnable, NOR_CMD_LUT_SEQ_IDX_ERASESECTOR, sector_addr,
+                                  NULL, MFLASH_SECTOR_SIZE, callback, user_data);
+#endif
+}
+
+/* API - start write of single page */
+int32_t mflash_drv_page_program_async(uint32_t page_addr,
+                                      uint32_t *data,
+                                      mflash_drv_callback_t callback,
+                                      void *user_data)
+{
+    if ((0 == mflash_drv_is_page_aligned(page_addr)) || (data == NULL))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+#if defined(MFLASH_DRV_FUSED_SEQUENCES) && MFLASH_DRV_FUSED_SEQUENCES
+    return mflash_drv_async_start((uint32_t)kMflashAsync_Command, NOR_CMD_LUT_SEQ_IDX_WREN_PAGEPROGRAM, page_addr,
+                                  data, MFLASH_PAGE_SIZE, callback, user_data);
+#else
+    return mflash_drv_async_start((uint32_t)kMflashAsync_WriteEnable, NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM_QUAD, page_addr,
+                                  data, MFLASH_PAGE_SIZE, callback, user_data);
+#endif
+}
+
+/* API - start read of data */
+int32_t mflash_drv_read_async(
+    uint32_t addr, uint32_t *buffer, uint32_t len, mflash_drv_callback_t callback, void *user_data)
+{
+    /* Check alignment */
+    if ((((uint32_t)buffer % 4U) != 0U) || ((len % 4U) != 0U))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* IP reads are not decrypted */
+    if (mflash_drv_is_encrypted(addr, len))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    return mflash_drv_async_start((uint32_t)kMflashAsync_Read, NOR_CMD_LUT_SEQ_IDX_READ_FAST_QUAD, addr, buffer, len,
+                                  callback, user_data);
+}
+
+/* API - check for operation in progress */
+MFLASH_RAMFUNC(bool mflash_drv_async_busy(void))
+{
+    return (s_asyncOp.state != (uint32_t)kMflashAsync_Idle);
+}
+
+/* API - poll device status of pending program/erase operation */
+MFLASH_RAMFUNC(void mflash_drv_async_tick(void))
+{
+    FLEXSPI_Type *base = MFLASH_FLEXSPI;
+    uint32_t intr;
+    uint32_t readValue;
+
+    if (s_asyncOp.state != (uint32_t)kMflashAsync_StatusRead)
+    {
+        return;
+    }
+
+    intr = base->INTR;
+
+    if ((intr & (FLEXSPI_INTR_IPCMDERR_MASK | FLEXSPI_INTR_IPCMDGE_MASK | FLEXSPI_INTR_SEQTIMEOUT_MASK)) != 0U)
+    {
+        mflash_drv_async_complete(kStatus_Fail);
+        return;
+    }
+
+    if ((intr & FLEXSPI_INTR_IPCMDDONE_MASK) == 0U)
+    {
+        /* Status read still in progress (tick period shorter than the transfer) */
+        return;
+    }
+
+    /* Pick up the status and pop the RX FIFO */
+    readValue  = base->RFDR[0];
+    base->INTR = FLEXSPI_INTR_IPRXWA_MASK | FLEXSPI_INTR_IPCMDDONE_MASK;
+
+    if (((readValue & (1U << FLASH_BUSY_STATUS_OFFSET)) != 0U) == (bool)FLASH_BUSY_STATUS_POL)
+    {
+        /* Still busy, issue next status read to be picked up by the next tick */
+        mflash_drv_async_status_start(base);
+    }
+    else
+    {
+        mflash_drv_async_complete(kStatus_Success);
+    }
+}
+#endif
+
+/* Board profile of AHB RX buffers */
+static const mflash_ahb_master_config_t s_ahbProfileMasters[] = {
+    {
+        .master_id   = MFLASH_AHB_DMA_MASTER_ID,
+        .priority    = 0,
+        .buffer_size = MFLASH_AHB_DMA_BUFFER_SIZE,
+        .prefetch    = true,
+    },
+};
+
+static const mflash_ahb_config_t s_ahbProfile = {
+    .masters              = s_ahbProfileMasters,
+    .master_count         = ARRAY_SIZE(s_ahbProfileMasters),
+    .shared_buffer_size   = MFLASH_AHB_SHARED_BUFFER_SIZE,
+    .shared_prefetch      = true,
+    .read_address_opt     = true,
+    .clear_ahb_buffer_opt = false,
+};
+
+static const mflash_ahb_config_t *s_ahbConfig = &s_ahbProfile;
+
+/* Internal - fill AHB part of FLEXSPI configuration */
+MFLASH_RAMFUNC(static void mflash_drv_ahb_config(flexspi_config_t *config, const mflash_ahb_config_t *ahb))
+{
+    uint32_t i;
+
+    /* Unused buffers get invalid master ID and no space */
+    for (i = 0; i < (uint32_t)FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNT; i++)
+    {
+        config->ahbConfig.buffer[i].priority       = 0;
+        config->ahbConfig.buffer[i].masterIndex    = 0xFU;
+        config->ahbConfig.buffer[i].bufferSize     = 0;
+        config->ahbConfig.buffer[i].enablePrefetch = false;
+    }
+
+    for (i = 0; i < ahb->master_count; i++)
+    {
+        config->ahbConfig.buffer[i].priority       = ahb->masters[i].priority;
+        config->ahbConfig.buffer[i].masterIndex    = ahb->masters[i].master_id;
+        config->ahbConfig.buffer[i].bufferSize     = ahb->masters[i].buffer_size;
+        config->ahbConfig.buffer[i].enablePrefetch = ahb->masters[i].prefetch;
+    }
+
+    /* The last buffer serves all masters without dedicated buffer */
+    i = (uint32_t)FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNT - 1U;
+    config->ahbConfig.buffer[i].masterIndex    = 0;
+    config->ahbConfig.buffer[i].bufferSize     = ahb->shared_buffer_size;
+    config->ahbConfig.buffer[i].enablePrefetch = ahb->shared_prefetch;
+
+    config->ahbConfig.enableReadAddressOpt    = ahb->read_address_opt;
+    config->ahbConfig.enableClearAHBBufferOpt = ahb->clear_ahb_buffer_opt;
+}
+
+/* API - set AHB RX buffer partitioning */
+int32_t mflash_drv_set_ahb_config(const mflash_ahb_config_t *config)
+{
+    uint32_t total_size;
+
+    if (config == NULL)
+    {
+        s_ahbConfig = &s_ahbProfile;
+        return kStatus_Success;
+    }
+
+    if ((config->master_count >= (uint32_t)FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNT) ||
+        ((config->master_count != 0U) && (config->masters == NULL)) || ((config->shared_buffer_size % 8U) != 0U))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    total_size = config->shared_buffer_size;
+    for (uint32_t i = 0; i < config->master_count; i++)
+    {
+        /* Master ID field of AHBRXBUFCR0 is 4 bits wide */
+        if (((config->masters[i].buffer_size % 8U) != 0U) || (config->masters[i].master_id >= 16U))
+        {
+            return kStatus_InvalidArgument;
+        }
+
+        /* Each master may own a single buffer only, FLEXSPI would serve it from the first one matching */
+        for (uint32_t j = 0; j < i; j++)
+        {
+            if (config->masters[j].master_id == config->masters[i].master_id)
+            {
+                return kStatus_InvalidArgument;
+            }
+        }
+
+        total_size += config->masters[i].buffer_size;
+    }
+
+    /* Check the buffers fit the AHB RX buffer space */
+    if (total_size > (uint32_t)FSL_FEATURE_FLEXSPI_AHB_RX_BUFFER_SIZEn(MFLASH_FLEXSPI))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    s_ahbConfig = config;
+
+    return kStatus_Success;
+}
+
+/* Size of the device detected by mflash_drv_init, 0 if not recognized */
+static uint32_t s_flashSize;
+
+/* Internal - check whether FLEXSPI is running with a device configured on another port than the FLASH one */
+MFLASH_RAMFUNC(static bool mflash_drv_flexspi_shared(FLEXSPI_Type *base))
+{
+    /* Registers can not be read while the module is gated or held in reset */
+    if (((CLKCTL0->PSCCTL0 & CLKCTL0_PSCCTL0_FLEXSPI0_MASK) == 0U) ||
+        ((RSTCTL0->PRSTCTL0 & RSTCTL0_PRSTCTL0_FLEXSPI0_MASK) != 0U) || ((base->MCR0 & FLEXSPI_MCR0_MDIS_MASK) != 0U))
+    {
+        return false;
+    }
+
+    for (uint32_t port = 0U; port < (uint32_t)kFLEXSPI_PortCount; port++)
+    {
+        if ((port != (uint32_t)FLASH_PORT) && ((base->FLSHCR0[port] & FLEXSPI_FLSHCR0_FLSHSZ_MASK) != 0U))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Internal - apply FLASH port related part of the configuration to running FLEXSPI, unlike FLEXSPI_Init this keeps
+ * the other ports, the LUT and the module clock as they are */
+MFLASH_RAMFUNC(static void mflash_drv_flexspi_join(FLEXSPI_Type *base, const flexspi_config_t *config))
+{
+    uint32_t i;
+
+    mflash_flexspi_wait_idle(base);
+    base->MCR0 |= FLEXSPI_MCR0_MDIS_MASK;
+
+#if defined(FSL_FEATURE_FLEXSPI_SUPPORT_SEPERATE_RXCLKSRC_PORTB) && FSL_FEATURE_FLEXSPI_SUPPORT_SEPERATE_RXCLKSRC_PORTB
+    /* Sample clock of port A, port B has its own */
+    base->MCR0 = (base->MCR0 & ~FLEXSPI_MCR0_RXCLKSRC_MASK) | FLEXSPI_MCR0_RXCLKSRC(config->rxSampleClock);
+#endif
+
+    base->MCR2 = (base->MCR2 & ~FLEXSPI_MCR2_CLRAHBBUFOPT_MASK) |
+                 FLEXSPI_MCR2_CLRAHBBUFOPT(config->ahbConfig.enableClearAHBBufferOpt);
+
+    base->AHBCR = (base->AHBCR & ~(FLEXSPI_AHBCR_READADDROPT_MASK | FLEXSPI_AHBCR_PREFETCHEN_MASK |
+                                   FLEXSPI_AHBCR_BUFFERABLEEN_MASK | FLEXSPI_AHBCR_CACHABLEEN_MASK)) |
+                  FLEXSPI_AHBCR_READADDROPT(config->ahbConfig.enableReadAddressOpt) |
+                  FLEXSPI_AHBCR_PREFETCHEN(config->ahbConfig.enableAHBPrefetch) |
+                  FLEXSPI_AHBCR_BUFFERABLEEN(config->ahbConfig.enableAHBBufferable) |
+                  FLEXSPI_AHBCR_CACHABLEEN(config->ahbConfig.enableAHBCachable);
+
+    /* AHB RX buffers serve both ports, the partitioning is given by the bus masters */
+    for (i = 0; i < (uint32_t)FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNT; i++)
+    {
+        base->AHBRXBUFCR0[i] =
+            (base->AHBRXBUFCR0[i] & ~(FLEXSPI_AHBRXBUFCR0_PREFETCHEN_MASK | FLEXSPI_AHBRXBUFCR0_PRIORITY_MASK |
+                                      FLEXSPI_AHBRXBUFCR0_MSTRID_MASK | FLEXSPI_AHBRXBUFCR0_BUFSZ_MASK)) |
+            FLEXSPI_AHBRXBUFCR0_PREFETCHEN(config->ahbConfig.buffer[i].enablePrefetch) |
+            FLEXSPI_AHBRXBUFCR0_PRIORITY(config->ahbConfig.buffer[i].priority) |
+            FLEXSPI_AHBRXBUFCR0_MSTRID(config->ahbConfig.buffer[i].masterIndex) |
+            FLEXSPI_AHBRXBUFCR0_BUFSZ((uint32_t)config->ahbConfig.buffer[i].bufferSize / 8U);
+    }
+
+    base->MCR0 &= ~FLEXSPI_MCR0_MDIS_MASK;
+}
+
+MFLASH_RAMFUNC(static int32_t mflash_drv_init_internal(void))
 {
     uint32_t primask = __get_PRIMASK();
     flexspi_config_t config;
+    uint32_t id;
+    uint32_t capacity;
+    uint32_t flshcr4;
+    bool shared;
 
     __asm("cpsid i");
 
@@ -355,32 +1111,68 @@ static int32_t mflash_drv_init_internal(void)
     config.ahbConfig.enableAHBPrefetch = true;
     config.rxSampleClock               = kFLEXSPI_ReadSampleClkLoopbackFromDqsPad;
 #if !(defined(FSL_FEATURE_FLEXSPI_HAS_NO_MCR0_COMBINATIONEN) && FSL_FEATURE_FLEXSPI_HAS_NO_MCR0_COMBINATIONEN)
-    config.enableCombination = true;
+    /* Quad device, the data lines of port B belong to the PSRAM */
+    config.enableCombination = false;
 #endif
     config.ahbConfig.enableAHBBufferable = true;
     config.ahbConfig.enableAHBCachable   = true;
-    FLEXSPI_Init(MFLASH_FLEXSPI, &config);
+    mflash_drv_ahb_config(&config, s_ahbConfig);
 
-    /* Configure flash settings according to serial flash feature. */
-    FLEXSPI_SetFlashConfig(MFLASH_FLEXSPI, &deviceconfig, FLASH_PORT);
+    /* Reset of the module would lose the PSRAM configured by the board already, so only the FLASH part is applied */
+    shared = mflash_drv_flexspi_shared(MFLASH_FLEXSPI);
+    if (shared)
+    {
+        mflash_drv_flexspi_join(MFLASH_FLEXSPI, &config);
+    }
+    else
+    {
+        FLEXSPI_Init(MFLASH_FLEXSPI, &config);
+    }
 
-    uint32_t tmpLUT[CUSTOM_LUT_LENGTH] = {0x00U};
+    /* Configure flash settings according to serial flash feature. The write mask option is common to all ports, the
+     * one of the PSRAM is kept. */
+    flshcr4 = MFLASH_FLEXSPI->FLSHCR4;
+    FLEXSPI_SetFlashConfig(MFLASH_FLEXSPI, &deviceconfig, FLASH_PORT);
+    if (shared && (((MFLASH_FLEXSPI->FLSHCR4 ^ flshcr4) & FLEXSPI_FLSHCR4_WMOPT1_MASK) != 0U))
+    {
+        MFLASH_FLEXSPI->MCR0 |= FLEXSPI_MCR0_MDIS_MASK;
+        MFLASH_FLEXSPI->FLSHCR4 ^= FLEXSPI_FLSHCR4_WMOPT1_MASK;
+        MFLASH_FLEXSPI->MCR0 &= ~FLEXSPI_MCR0_MDIS_MASK;
+    }
 
-    memcpy(tmpLUT, customLUT, sizeof(tmpLUT));
-    /* Update LUT table. */
-    FLEXSPI_UpdateLUT(MFLASH_FLEXSPI, 0, tmpLUT, CUSTOM_LUT_LENGTH);
+    /* Update the LUT slice of the FLASH, taken directly from RAM as the FLASH can not be read meanwhile. */
+    FLEXSPI_UpdateLUT(MFLASH_FLEXSPI, 4U * MFLASH_LUT_SEQ_BASE, customLUT, CUSTOM_LUT_LENGTH);
 
     (void)flexspi_nor_enable_quad_mode(MFLASH_FLEXSPI);
 
-    /* Invalidate cache. */
-    do
+    /* Capacity byte of JEDEC ID is log2 of the size in bytes up to 256Mb devices, larger ones continue from 0x20
+     * (512Mb). Devices not fitting the FLEXSPI window are not recognized. */
+    s_flashSize = 0U;
+    if (flexspi_nor_read_id(MFLASH_FLEXSPI, &id) == kStatus_Success)
     {
-        CACHE64_CTRL0->CCR |= CACHE64_CTRL_CCR_INVW0_MASK | CACHE64_CTRL_CCR_INVW1_MASK | CACHE64_CTRL_CCR_GO_MASK;
-        while ((CACHE64_CTRL0->CCR & CACHE64_CTRL_CCR_GO_MASK) != 0U)
+        capacity = (id >> 16) & 0xFFU;
+        if ((capacity >= 0x20U) && (capacity <= 0x22U))
         {
+            capacity -= 6U;
         }
-        CACHE64_CTRL0->CCR &= ~(CACHE64_CTRL_CCR_INVW0_MASK | CACHE64_CTRL_CCR_INVW1_MASK);
-    } while (false);
+        if ((capacity >= 16U) && (capacity <= 28U) && ((1UL << capacity) <= MFLASH_BSIZE))
+        {
+            s_flashSize = 1UL << capacity;
+        }
+    }
+
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+    /* Handle for interrupt driven transfers of asynchronous operations */
+    FLEXSPI_TransferCreateHandle(MFLASH_FLEXSPI, &s_asyncHandle, mflash_drv_async_callback, NULL);
+#endif
+
+    /* Lines fetched while FLEXSPI was being reconfigured can not be trusted, this is the only place invalidating
+     * whole cache. Disabled cache is invalidated once it gets enabled. */
+    if ((MFLASH_CACHE->CCR & CACHE64_CTRL_CCR_ENCACHE_MASK) != 0U)
+    {
+        CACHE64_InvalidateCache(MFLASH_CACHE);
+    }
+    s_cachePendingEnd = 0U;
 
     if (primask == 0U)
     {
@@ -394,11 +1186,91 @@ static int32_t mflash_drv_init_internal(void)
 int32_t mflash_drv_init(void)
 {
     /* Necessary to have double wrapper call in non_xip memory */
-    return mflash_drv_init_internal();
+    int32_t status = mflash_drv_init_internal();
+
+    /* Reset of the FLEXSPI clears the IPED regions of encrypted areas */
+    for (uint32_t i = 0U; (i < MFLASH_ENCRYPT_AREAS) && (status == kStatus_Success); i++)
+    {
+        if (s_encryptAreas[i].len != 0U)
+        {
+            status = mflash_drv_encrypt_update(i, s_encryptAreas[i].addr, s_encryptAreas[i].len, s_encryptAreas[i].iv);
+        }
+    }
+
+    return status;
+}
+
+/* API - encrypt area */
+int32_t mflash_drv_encrypt_area(uint32_t addr, uint32_t len, const uint8_t iv[8])
+{
+    uint32_t index = MFLASH_ENCRYPT_AREAS;
+
+    if ((iv == NULL) || (len == 0U) || (0 == mflash_drv_is_sector_aligned(addr)) ||
+        (0 == mflash_drv_is_sector_aligned(len)) || (addr >= MFLASH_BSIZE) || (len > MFLASH_BSIZE - addr))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+    if (mflash_drv_async_busy())
+    {
+        return kStatus_Busy;
+    }
+#endif
+
+    /* Entry of the same area is replaced, a free one is taken otherwise */
+    for (uint32_t i = 0U; i < MFLASH_ENCRYPT_AREAS; i++)
+    {
+        if ((s_encryptAreas[i].len != 0U) && (s_encryptAreas[i].addr == addr))
+        {
+            index = i;
+            break;
+        }
+        if ((s_encryptAreas[i].len == 0U) && (index == MFLASH_ENCRYPT_AREAS))
+        {
+            index = i;
+        }
+    }
+
+    if (index == MFLASH_ENCRYPT_AREAS)
+    {
+        return kStatus_OutOfRange;
+    }
+
+    /* Overlapping regions would encrypt the data twice */
+    for (uint32_t i = 0U; i < MFLASH_ENCRYPT_AREAS; i++)
+    {
+        const mflash_encrypt_area_t *area = &s_encryptAreas[i];
+
+        if ((i != index) && (area->len != 0U) && (addr < area->addr + area->len) && (area->addr < addr + len))
+        {
+            return kStatus_InvalidArgument;
+        }
+    }
+
+    return mflash_drv_encrypt_update(index, addr, len, iv);
+}
+
+/* API - stop encryption of all areas */
+void mflash_drv_encrypt_clear(void)
+{
+    for (uint32_t i = 0U; i < MFLASH_ENCRYPT_AREAS; i++)
+    {
+        if (s_encryptAreas[i].len != 0U)
+        {
+            (void)mflash_drv_encrypt_update(i, 0U, 0U, NULL);
+        }
+    }
+}
+
+/* API - size of the FLASH device */
+uint32_t mflash_drv_get_size(void)
+{
+    return s_flashSize;
 }
 
 /* Internal - erase single sector */
-static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr)
+MFLASH_RAMFUNC(static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr))
 {
     status_t status;
     uint32_t primask = __get_PRIMASK();
@@ -407,7 +1279,7 @@ static int32_t mflash_drv_sector_erase_internal(uint32_t sector_addr)
 
     status = flexspi_nor_flash_sector_erase(MFLASH_FLEXSPI, sector_addr);
 
-    DCACHE_InvalidateByRange(MFLASH_BASE_ADDRESS + sector_addr, MFLASH_SECTOR_SIZE);
+    mflash_drv_cache_invalidate(sector_addr, MFLASH_SECTOR_SIZE);
 
     if (primask == 0U)
     {
@@ -431,23 +1303,28 @@ int32_t mflash_drv_sector_erase(uint32_t sector_addr)
         return kStatus_InvalidArgument;
     }
 
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+    if (mflash_drv_async_busy())
+    {
+        return kStatus_Busy;
+    }
+#endif
+
     return mflash_drv_sector_erase_internal(sector_addr);
 }
 
 /* Internal - write single page */
-static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data)
+MFLASH_RAMFUNC(static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *data))
 {
     uint32_t primask = __get_PRIMASK();
 
     __asm("cpsid i");
 
     status_t status;
-    status = flexspi_nor_flash_page_program(MFLASH_FLEXSPI, page_addr, data);
-
-    /* Do software reset. */
-    // FLEXSPI_SoftwareReset(MFLASH_FLEXSPI);
+    status = flexspi_nor_flash_page_program(MFLASH_FLEXSPI, page_addr, data,
+                                            mflash_drv_is_encrypted(page_addr, MFLASH_PAGE_SIZE));
 
-    DCACHE_InvalidateByRange(MFLASH_BASE_ADDRESS + page_addr, MFLASH_PAGE_SIZE);
+    mflash_drv_cache_invalidate(page_addr, MFLASH_PAGE_SIZE);
 
     if (primask == 0U)
     {
@@ -462,7 +1339,7 @@ static int32_t mflash_drv_page_program_internal(uint32_t page_addr, uint32_t *da
 }
 
 /* Internal - read data */
-static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len)
+MFLASH_RAMFUNC(static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_t len))
 {
     uint32_t primask = __get_PRIMASK();
 
@@ -471,8 +1348,8 @@ static int32_t mflash_drv_read_internal(uint32_t addr, uint32_t *buffer, uint32_
     status_t status;
     status = flexspi_nor_read_data(MFLASH_FLEXSPI, addr, buffer, len);
 
-    /* Do software reset. */
-    FLEXSPI_SoftwareReset(MFLASH_FLEXSPI);
+    /* Drop data left in the IP RX FIFO, unlike software reset this keeps AHB accesses to the PSRAM going */
+    mflash_flexspi_clear_ip_rx(MFLASH_FLEXSPI);
 
     if (primask == 0)
     {
@@ -497,6 +1374,13 @@ int32_t mflash_drv_page_program(uint32_t page_addr, uint32_t *data)
         return kStatus_InvalidArgument;
     }
 
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+    if (mflash_drv_async_busy())
+    {
+        return kStatus_Busy;
+    }
+#endif
+
     return mflash_drv_page_program_internal(page_addr, data);
 }
 
@@ -509,12 +1393,33 @@ int32_t mflash_drv_read(uint32_t addr, uint32_t *buffer, uint32_t len)
         return kStatus_InvalidArgument;
     }
 
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+    if (mflash_drv_async_busy())
+    {
+        return kStatus_Busy;
+    }
+#endif
+
+    /* IP reads are not decrypted, data of encrypted areas is taken from the memory mapped FLASH */
+    if (mflash_drv_is_encrypted(addr, len))
+    {
+        void *ptr = mflash_drv_phys2log(addr, len);
+
+        if (ptr == NULL)
+        {
+            return kStatus_Fail;
+        }
+
+        (void)memcpy(buffer, ptr, len);
+        return kStatus_Success;
+    }
+
     return mflash_drv_read_internal(addr, buffer, len);
 }
 
 /* Returns pointer (AHB address) to memory area where the specified region of FLASH is mapped, NULL on failure (could
  * not map continuous block) */
-void * mflash_drv_phys2log(uint32_t addr, uint32_t len)
+MFLASH_RAMFUNC(void *mflash_drv_phys2log(uint32_t addr, uint32_t len))
 {
    /* take FLEXSPI remapping into account */
     uint32_t remap_offset = MFLASH_REMAP_OFFSET();
@@ -1,5 +1,5 @@
 /*
- * Copyright 2017-2021, 2024 NXP
+ * Copyright 2017-2021, 2024, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -23,13 +23,27 @@
 #define MFLASH_FLEXSPI FLEXSPI
 #endif
 
+/*
+ * The FLEXSPI is shared with the PSRAM on port B1. The FLASH owns MFLASH_LUT_SEQ_COUNT LUT sequences starting at
+ * MFLASH_LUT_SEQ_BASE, mflash_drv_init does not touch the rest of the LUT (the board PSRAM setup takes sequences 11 to
+ * 15) nor the configuration of the other ports once these are set up.
+ */
+#ifndef MFLASH_LUT_SEQ_BASE
+#define MFLASH_LUT_SEQ_BASE (0U)
+#endif
+
+#define MFLASH_LUT_SEQ_COUNT (9U)
+
 #define MFLASH_BASE_ADDRESS (0x18000000U & 0x0fffffffU)
 #ifndef MFLASH_BASE_ADDRESS
 #define MFLASH_BASE_ADDRESS (0x18000000U)
 #endif
 
-/* Flash size in bytes: 64MB */
+/* Size of the FLEXSPI window mapped to the FLASH: 64MB, upper bound of supported devices. Size of the device actually
+ * populated is returned by mflash_drv_get_size. */
+#ifndef MFLASH_BSIZE
 #define MFLASH_BSIZE 0x04000000U
+#endif
 
 #define MFLASH_REMAP_OFFSET() (MFLASH_FLEXSPI->HADDROFFSET & FLEXSPI_HADDROFFSET_ADDROFFSET_MASK)
 #define MFLASH_REMAP_START()  (MFLASH_FLEXSPI->HADDRSTART & FLEXSPI_HADDRSTART_ADDRSTART_MASK)
@@ -37,4 +51,147 @@
 
 #define MFLASH_REMAP_ACTIVE() (MFLASH_REMAP_OFFSET() != 0UL)
 
+/*! @brief Returns size of the FLASH device in bytes detected by mflash_drv_init from JEDEC ID, 0 if not recognized */
+uint32_t mflash_drv_get_size(void);
+
+/*
+ * AHB RX buffer profile of the board, applied by mflash_drv_init unless replaced by mflash_drv_set_ahb_config.
+ * GDMA gets a buffer of its own so that data streamed from FLASH does not evict the lines fetched for the CPU (through
+ * CACHE64), all other masters share the last buffer.
+ */
+#ifndef MFLASH_AHB_DMA_MASTER_ID
+#define MFLASH_AHB_DMA_MASTER_ID (10U) /* GDMA */
+#endif
+
+#ifndef MFLASH_AHB_DMA_BUFFER_SIZE
+#define MFLASH_AHB_DMA_BUFFER_SIZE (512U)
+#endif
+
+#ifndef MFLASH_AHB_SHARED_BUFFER_SIZE
+#define MFLASH_AHB_SHARED_BUFFER_SIZE (1024U)
+#endif
+
+/* AHB RX buffer dedicated to single AHB bus master */
+typedef struct _mflash_ahb_master_config
+{
+    uint8_t master_id;    /* AHB master ID as seen by FLEXSPI */
+    uint8_t priority;     /* Read priority of the master, 0 is the lowest */
+    uint16_t buffer_size; /* Buffer size in bytes, multiple of 8 */
+    bool prefetch;        /* Prefetch sequential data for this master */
+} mflash_ahb_master_config_t;
+
+/* Partitioning of FLEXSPI AHB RX buffers among bus masters */
+typedef struct _mflash_ahb_config
+{
+    const mflash_ahb_master_config_t *masters; /* Masters with dedicated buffers, assigned from buffer 0 */
+    uint32_t master_count;                     /* Less than FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNT */
+    uint16_t shared_buffer_size;               /* Size of the last buffer serving all other masters */
+    bool shared_prefetch;                      /* Prefetch for masters using the shared buffer */
+    bool read_address_opt;     /* Remove burst start address alignment, lowers latency of unaligned fetches */
+    bool clear_ahb_buffer_opt; /* Clear AHB buffers on stop mode entry, needed if these are powered off */
+} mflash_ahb_config_t;
+
+/*! @brief Sets AHB RX buffer partitioning applied by the next mflash_drv_init, NULL restores the board profile.
+ * Returns kStatus_InvalidArgument if master IDs are out of range or duplicate, or the buffers do not fit. */
+int32_t mflash_drv_set_ahb_config(const mflash_ahb_config_t *config);
+
+/* Issue write enable together with erase/program command as single IP command executing two LUT sequences. Can be
+ * disabled to compare the per-command overhead. */
+#ifndef MFLASH_DRV_FUSED_SEQUENCES
+#define MFLASH_DRV_FUSED_SEQUENCES (1)
+#endif
+
+/*
+ * CACHE64 coherency of erased/programmed areas
+ *
+ * Each erase/program invalidates just the affected cache lines, areas that CACHE64 does not hold (cache disabled,
+ * non-cacheable region, not mapped to AHB) are skipped. Writes of multiple pages/sectors may be enclosed in
+ * mflash_drv_cache_batch_begin/end so that adjacent areas are merged and invalidated by single range operation at the
+ * end. Until then the CPU may still read stale content of the modified areas through XIP. Batching can be disabled
+ * to compare with invalidation after each operation.
+ */
+#ifndef MFLASH_DRV_CACHE_BATCH
+#define MFLASH_DRV_CACHE_BATCH (1)
+#endif
+
+/*! @brief Defers cache invalidation of erased/programmed areas, calls may be nested */
+void mflash_drv_cache_batch_begin(void);
+
+/*! @brief Invalidates areas modified since the outermost mflash_drv_cache_batch_begin */
+void mflash_drv_cache_batch_end(void);
+
+/*
+ * Inline encryption
+ *
+ * Areas registered by mflash_drv_encrypt_area are covered by IPED regions of the FLEXSPI: page programs of these are
+ * encrypted by the FLEXSPI on the way to the device and memory mapped (AHB) reads are decrypted on the fly, XIP and
+ * DMA from an encrypted area cost the same as from plain one. mflash_drv_read of encrypted area copies the data from
+ * its memory mapped address, IP reads would return the ciphertext. The key is not handled by the driver, it is loaded
+ * to the IPED from ELS as part of the platform security setup done by the boot ROM.
+ *
+ * Erased sector of encrypted area does not read as 0xFF and its page can only be programmed once per erase, hence
+ * only users not depending on the erased state, such as littlefs, may keep their data in encrypted areas.
+ * Registered areas persist over mflash_drv_init, IPED regions below MFLASH_ENCRYPT_FIRST_REGION are left to the
+ * boot ROM.
+ */
+#ifndef MFLASH_ENCRYPT_FIRST_REGION
+#define MFLASH_ENCRYPT_FIRST_REGION (4U)
+#endif
+
+#ifndef MFLASH_ENCRYPT_AREAS
+#define MFLASH_ENCRYPT_AREAS (4U)
+#endif
+
+/*! @brief Encrypts sector aligned area using given initialization vector, returns kStatus_OutOfRange if all areas are
+ * in use. Area starting at the address of registered one replaces it. Content programmed before is not readable. */
+int32_t mflash_drv_encrypt_area(uint32_t addr, uint32_t len, const uint8_t iv[8]);
+
+/*! @brief Stops encryption of all registered areas */
+void mflash_drv_encrypt_clear(void);
+
+/*! @brief Returns true if given area overlaps any encrypted area */
+bool mflash_drv_is_encrypted(uint32_t addr, uint32_t len);
+
+#if defined(MFLASH_DRV_ASYNC) && MFLASH_DRV_ASYNC
+/*
+ * Asynchronous (non-blocking) operations
+ *
+ * Data phases are driven by the FLEXSPI interrupt handler, the device busy state of program/erase operations is then
+ * polled by mflash_drv_async_tick() which is expected to be called periodically by the application, typically from a
+ * timer interrupt (period in range of 100us to 1ms is reasonable as page program takes ~0.6ms and sector erase ~45ms).
+ * The completion callback is called from the interrupt or tick context.
+ *
+ * The FLASH can not be read while program or erase is in progress, hence everything that executes until the
+ * completion callback (vector table, interrupt handlers including FLEXSPI_TransferHandleIRQ, the timer handler and
+ * the code the application runs meanwhile) has to reside in RAM. Data in FLASH must not be accessed by the CPU either.
+ * The driver's own code for the asynchronous path is placed to RAM.
+ * Only one operation may be in progress at a time, the blocking API returns kStatus_Busy meanwhile.
+ */
+
+/*! @brief Completion callback of asynchronous operation */
+typedef void (*mflash_drv_callback_t)(int32_t status, void *user_data);
+
+/*! @brief Starts erase of single sector, returns kStatus_Busy if other operation is in progress */
+int32_t mflash_drv_sector_erase_async(uint32_t sector_addr, mflash_drv_callback_t callback, void *user_data);
+
+/*! @brief Starts write of single page, data buffer must stay valid until the completion */
+int32_t mflash_drv_page_program_async(uint32_t page_addr,
+                                      uint32_t *data,
+                                      mflash_drv_callback_t callback,
+                                      void *user_data);
+
+/*! @brief Starts read of data, buffer must stay valid until the completion */
+int32_t mflash_drv_read_async(uint32_t addr,
+                              uint32_t *buffer,
+                              uint32_t len,
+                              mflash_drv_callback_t callback,
+                              void *user_data);
+
+/*! @brief Returns true while asynchronous operation is in progress */
+bool mflash_drv_async_busy(void);
+
+/*! @brief Polls the device busy state of pending program/erase operation, to be called periodically */
+void mflash_drv_async_tick(void);
+#endif
+
 #endif
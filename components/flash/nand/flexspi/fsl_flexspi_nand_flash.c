@@ -1,5 +1,5 @@
 /*
- * Copyright 2018 NXP
+ * Copyright 2018, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -43,12 +43,16 @@ static status_t flexspi_nand_write_enable(FLEXSPI_Type *base, flexspi_port_t por
     return status;
 }
 
-/* NAND Flash wait status busy */
-static status_t flexspi_nand_wait_bus_busy(FLEXSPI_Type *base, flexspi_mem_nand_handle_t *handle, uint32_t baseAddr)
+/* NAND Flash wait until status bit reports ready, the last status read is returned in statusValue if not NULL */
+static status_t flexspi_nand_wait_status_bit(FLEXSPI_Type *base,
+                                             flexspi_mem_nand_handle_t *handle,
+                                             uint32_t baseAddr,
+                                             uint16_t bitOffset,
+                                             uint32_t *statusValue)
 {
     /* Wait status ready. */
-    bool isBusy = true;
-    uint32_t readValue;
+    bool isBusy        = true;
+    uint32_t readValue = 0;
     status_t status;
     flexspi_transfer_t flashXfer;
 
@@ -71,37 +75,64 @@ static status_t flexspi_nand_wait_bus_busy(FLEXSPI_Type *base, flexspi_mem_nand_
 
         if (handle->busyBitPolarity)
         {
-            isBusy = (~readValue) & (1 << handle->busyOffset);
+            isBusy = (~readValue) & (1 << bitOffset);
         }
         else
         {
-            isBusy = readValue & (1 << handle->busyOffset);
+            isBusy = readValue & (1 << bitOffset);
         }
 
     } while (isBusy);
 
+    if (statusValue != NULL)
+    {
+        *statusValue = readValue;
+    }
+
     return status;
 }
 
-static status_t flexspi_nand_check_ecc_status(FLEXSPI_Type *base,
-                                              flexspi_mem_nand_handle_t *handle,
-                                              uint32_t baseAddr,
-                                              bool *isCheckPassed)
+/* NAND Flash wait status busy */
+static status_t flexspi_nand_wait_bus_busy(FLEXSPI_Type *base, flexspi_mem_nand_handle_t *handle, uint32_t baseAddr)
+{
+    return flexspi_nand_wait_status_bit(base, handle, baseAddr, handle->busyOffset, NULL);
+}
+
+/* NAND Flash device address of page, column space is twice the page data area */
+static uint32_t flexspi_nand_page_address(nand_handle_t *handle, uint32_t pageIndex)
 {
+    return pageIndex * (2 * handle->bytesInPageDataArea);
+}
+
+/* NAND Flash sequence accessing cache from column 0, plane of odd blocks is selected on two plane devices */
+static uint8_t flexspi_nand_plane_seq(nand_handle_t *handle, uint32_t pageIndex, uint8_t evenSeq, uint8_t oddSeq)
+{
+    if ((handle->planesInDevice > 1U) && (((pageIndex / handle->pagesInBlock) & 1U) != 0U))
+    {
+        return oddSeq;
+    }
+
+    return evenSeq;
+}
+
+/* NAND Flash check ECC status of the page in cache, pages with corrected bit errors are counted in the handle */
+static status_t flexspi_nand_check_ecc_status(nand_handle_t *handle, uint32_t baseAddr, bool *isCheckPassed)
+{
+    flexspi_mem_nand_handle_t *memHandle = (flexspi_mem_nand_handle_t *)handle->deviceSpecific;
     flexspi_transfer_t flashXfer;
     status_t status;
     uint32_t eccStatus;
 
     /* Write neable */
     flashXfer.deviceAddress = baseAddr;
-    flashXfer.port          = handle->port;
+    flashXfer.port          = memHandle->port;
     flashXfer.cmdType       = kFLEXSPI_Read;
     flashXfer.SeqNumber     = 1;
     flashXfer.seqIndex      = NAND_CMD_LUT_SEQ_IDX_READECCSTAT;
     flashXfer.data          = &eccStatus;
     flashXfer.dataSize      = 1;
 
-    status = FLEXSPI_TransferBlocking(base, &flashXfer);
+    status = FLEXSPI_TransferBlocking((FLEXSPI_Type *)handle->driverBaseAddr, &flashXfer);
     if (status != kStatus_Success)
     {
         return status;
@@ -109,9 +140,15 @@ static status_t flexspi_nand_check_ecc_status(FLEXSPI_Type *base,
 
     *isCheckPassed = false;
 
-    if ((eccStatus & handle->eccStatusMask) != handle->eccFailureMask)
+    if ((eccStatus & memHandle->eccStatusMask) != memHandle->eccFailureMask)
     {
         *isCheckPassed = true;
+
+        /* Any other non-zero ECC status means the bit errors were corrected. */
+        if ((eccStatus & memHandle->eccStatusMask) != 0U)
+        {
+            handle->eccCorrectedPages++;
+        }
     }
 
     return status;
@@ -147,7 +184,7 @@ status_t Nand_Flash_Init(nand_config_t *config, nand_handle_t *handle)
     flexspi_mem_config_t *memConfig = (flexspi_mem_config_t *)config->memControlConfig;
 
     /* Cleanup nand operation info */
-    memset(handle, 0, sizeof(handle));
+    memset(handle, 0, sizeof(*handle));
 
     handle->deviceSpecific           = &flexspiMemHandle;
     handle->driverBaseAddr           = config->driverBaseAddr;
@@ -156,6 +193,9 @@ status_t Nand_Flash_Init(nand_config_t *config, nand_handle_t *handle)
     flexspiMemHandle.busyBitPolarity = memConfig->busyBitPolarity;
     flexspiMemHandle.eccStatusMask   = memConfig->eccStatusMask;
     flexspiMemHandle.eccFailureMask  = memConfig->eccFailureMask;
+    flexspiMemHandle.cacheRead       = memConfig->cacheRead;
+    flexspiMemHandle.cacheProgram    = memConfig->cacheProgram;
+    flexspiMemHandle.arrayBusyOffset = memConfig->arrayBusyOffset;
 
     /* Configure flash settings according to serial flash feature. */
     FLEXSPI_SetFlashConfig((FLEXSPI_Type *)handle->driverBaseAddr, &(memConfig->deviceConfig), memConfig->devicePort);
@@ -169,6 +209,16 @@ status_t Nand_Flash_Init(nand_config_t *config, nand_handle_t *handle)
                                    FLEXSPI_LUT_SEQ(kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_1PAD, 0x08,
                                                    kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x80),
 
+                               /* Read Cache 1X from column 0 of plane 1 (column address bit 12) */
+        memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_READCACHE_ODD] =
+            FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x03, kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x10),
+                               memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_READCACHE_ODD + 1] =
+                                   FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x00,
+                                                   kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_1PAD, 0x08),
+                               memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_READCACHE_ODD + 2] =
+                                   FLEXSPI_LUT_SEQ(kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x80,
+                                                   kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
+
                                /* Read Status */
         memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_READSTATUS] =
             FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x0F, kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0xC0),
@@ -191,6 +241,13 @@ status_t Nand_Flash_Init(nand_config_t *config, nand_handle_t *handle)
                                    FLEXSPI_LUT_SEQ(kFLEXSPI_Command_WRITE_SDR, kFLEXSPI_1PAD, 0x40,
                                                    kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 
+                               /* Page Program Load to column 0 of plane 1 (column address bit 12) */
+        memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD_ODD] =
+            FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x02, kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x10),
+                               memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD_ODD + 1] =
+                                   FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x00,
+                                                   kFLEXSPI_Command_WRITE_SDR, kFLEXSPI_1PAD, 0x40),
+
                                /* Page Program Execute */
         memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_PROGRAMEXECUTE] =
             FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x10, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 0x18),
@@ -220,6 +277,14 @@ status_t Nand_Flash_Init(nand_config_t *config, nand_handle_t *handle)
                                    FLEXSPI_LUT_SEQ(kFLEXSPI_Command_WRITE_SDR, kFLEXSPI_1PAD, 0x00,
                                                    kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 
+                               /* Read cache sequential */
+        memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_READCACHESEQ] =
+            FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x31, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
+
+                               /* Read cache end */
+        memConfig->lookupTable[4 * NAND_CMD_LUT_SEQ_IDX_READCACHEEND] =
+            FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x3F, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
+
                                /* Update LUT table. */
         FLEXSPI_UpdateLUT((FLEXSPI_Type *)config->driverBaseAddr, 0, memConfig->lookupTable,
                           ARRAY_SIZE(memConfig->lookupTable));
@@ -230,6 +295,8 @@ status_t Nand_Flash_Init(nand_config_t *config, nand_handle_t *handle)
     handle->bytesInPageDataArea  = memConfig->dataBytesPerPage;
     handle->bytesInPageSpareArea = memConfig->bytesInPageSpareArea;
     handle->pagesInBlock         = memConfig->pagesPerBlock;
+    handle->planesInDevice       = (memConfig->planesPerDevice > 1U) ? memConfig->planesPerDevice : 1U;
+    handle->eccCorrectedPages    = 0U;
 
     return kStatus_Success;
 }
@@ -239,7 +306,7 @@ status_t Nand_Flash_Read_Page(nand_handle_t *handle, uint32_t pageIndex, uint8_t
     status_t status = kStatus_Success;
 
     flexspi_transfer_t flashXfer;
-    uint32_t readAddress                 = pageIndex * (2 * handle->bytesInPageDataArea);
+    uint32_t readAddress                 = flexspi_nand_page_address(handle, pageIndex);
     flexspi_mem_nand_handle_t *memHandle = (flexspi_mem_nand_handle_t *)handle->deviceSpecific;
     flexspi_port_t port                  = memHandle->port;
 
@@ -267,7 +334,8 @@ status_t Nand_Flash_Read_Page(nand_handle_t *handle, uint32_t pageIndex, uint8_t
     flashXfer.port          = port;
     flashXfer.cmdType       = kFLEXSPI_Read;
     flashXfer.SeqNumber     = 1;
-    flashXfer.seqIndex      = NAND_CMD_LUT_SEQ_IDX_READCACHE;
+    flashXfer.seqIndex      = flexspi_nand_plane_seq(handle, pageIndex, NAND_CMD_LUT_SEQ_IDX_READCACHE,
+                                                     NAND_CMD_LUT_SEQ_IDX_READCACHE_ODD);
     flashXfer.data          = (uint32_t *)buffer;
     flashXfer.dataSize      = length;
 
@@ -279,8 +347,7 @@ status_t Nand_Flash_Read_Page(nand_handle_t *handle, uint32_t pageIndex, uint8_t
     }
 
     bool isCheckPassed;
-    status =
-        flexspi_nand_check_ecc_status((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, readAddress, &isCheckPassed);
+    status = flexspi_nand_check_ecc_status(handle, readAddress, &isCheckPassed);
 
     if (status != kStatus_Success)
     {
@@ -301,7 +368,7 @@ status_t Nand_Flash_Read_Page_Partial(
     status_t status = kStatus_Success;
 
     flexspi_transfer_t flashXfer;
-    uint32_t readAddress                 = pageIndex * (2 * handle->bytesInPageDataArea);
+    uint32_t readAddress                 = flexspi_nand_page_address(handle, pageIndex);
     flexspi_mem_nand_handle_t *memHandle = (flexspi_mem_nand_handle_t *)handle->deviceSpecific;
     flexspi_port_t port                  = memHandle->port;
 
@@ -341,8 +408,7 @@ status_t Nand_Flash_Read_Page_Partial(
     }
 
     bool isCheckPassed;
-    status =
-        flexspi_nand_check_ecc_status((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, readAddress, &isCheckPassed);
+    status = flexspi_nand_check_ecc_status(handle, readAddress, &isCheckPassed);
 
     if (status != kStatus_Success)
     {
@@ -356,11 +422,159 @@ status_t Nand_Flash_Read_Page_Partial(
 
     return status;
 }
+/* NAND Flash issue command without data */
+static status_t flexspi_nand_command(FLEXSPI_Type *base, flexspi_port_t port, uint32_t address, uint8_t seqIndex)
+{
+    flexspi_transfer_t flashXfer;
+
+    flashXfer.deviceAddress = address;
+    flashXfer.port          = port;
+    flashXfer.cmdType       = kFLEXSPI_Command;
+    flashXfer.SeqNumber     = 1;
+    flashXfer.seqIndex      = seqIndex;
+
+    return FLEXSPI_TransferBlocking(base, &flashXfer);
+}
+
+status_t Nand_Flash_Read_Pages(
+    nand_handle_t *handle, uint32_t pageIndex, uint32_t pageCount, uint8_t *buffer, uint32_t *eccFailedPage)
+{
+    status_t status = kStatus_Success;
+    bool eccFailed  = false;
+
+    flexspi_transfer_t flashXfer;
+    FLEXSPI_Type *base                   = (FLEXSPI_Type *)handle->driverBaseAddr;
+    flexspi_mem_nand_handle_t *memHandle = (flexspi_mem_nand_handle_t *)handle->deviceSpecific;
+    flexspi_port_t port                  = memHandle->port;
+    uint32_t page                        = pageIndex;
+    uint32_t endPage                     = pageIndex + pageCount;
+
+    while (page < endPage)
+    {
+        /* Sequential read does not cross block boundary, start it again for each block. Without cache read support
+         * each page is loaded by its own page read. */
+        uint32_t blockEnd = (page / handle->pagesInBlock + 1) * handle->pagesInBlock;
+        uint32_t lastPage = ((endPage < blockEnd) ? endPage : blockEnd) - 1;
+        bool inSequence   = false;
+
+        if (memHandle->cacheRead == false)
+        {
+            lastPage = page;
+        }
+
+        /* Load the first page to cache. */
+        status = flexspi_nand_command(base, port, flexspi_nand_page_address(handle, page), NAND_CMD_LUT_SEQ_IDX_READPAGE);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        status = flexspi_nand_wait_bus_busy(base, memHandle, flexspi_nand_page_address(handle, page));
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        for (uint32_t firstPage = page; page <= lastPage; page++)
+        {
+            uint32_t readAddress = flexspi_nand_page_address(handle, page);
+
+            if (page != lastPage)
+            {
+                /* Hand the current page over to cache and start loading the next one from the array, the load runs
+                 * while the current page is transferred to the host. */
+                inSequence = true;
+                status     = flexspi_nand_command(base, port, readAddress, NAND_CMD_LUT_SEQ_IDX_READCACHESEQ);
+            }
+            else if (page != firstPage)
+            {
+                /* Hand the last page over to cache, no further load. */
+                status = flexspi_nand_command(base, port, readAddress, NAND_CMD_LUT_SEQ_IDX_READCACHEEND);
+                if (status == kStatus_Success)
+                {
+                    inSequence = false;
+                }
+            }
+            else
+            {
+                /* Single page, already in cache. */
+            }
+
+            if (status != kStatus_Success)
+            {
+                break;
+            }
+
+            /* Wait until the page is in cache, this includes the rest of the array load started before. */
+            status = flexspi_nand_wait_bus_busy(base, memHandle, readAddress);
+            if (status != kStatus_Success)
+            {
+                break;
+            }
+
+            flashXfer.deviceAddress = readAddress;
+            flashXfer.port          = port;
+            flashXfer.cmdType       = kFLEXSPI_Read;
+            flashXfer.SeqNumber     = 1;
+            flashXfer.seqIndex      = flexspi_nand_plane_seq(handle, page, NAND_CMD_LUT_SEQ_IDX_READCACHE,
+                                                             NAND_CMD_LUT_SEQ_IDX_READCACHE_ODD);
+            flashXfer.data          = (uint32_t *)buffer;
+            flashXfer.dataSize      = handle->bytesInPageDataArea;
+
+            status = FLEXSPI_TransferBlocking(base, &flashXfer);
+            if (status != kStatus_Success)
+            {
+                break;
+            }
+
+            /* ECC status reflects the page currently in cache. */
+            bool isCheckPassed;
+            status = flexspi_nand_check_ecc_status(handle, readAddress, &isCheckPassed);
+            if (status != kStatus_Success)
+            {
+                break;
+            }
+
+            if ((isCheckPassed == false) && (eccFailed == false))
+            {
+                eccFailed = true;
+                if (eccFailedPage != NULL)
+                {
+                    *eccFailedPage = page;
+                }
+            }
+
+            buffer += handle->bytesInPageDataArea;
+        }
+
+        if (status != kStatus_Success)
+        {
+            if (inSequence)
+            {
+                /* Terminate the sequential read so that the device accepts other commands, the original error is
+                 * reported regardless of the outcome. */
+                uint32_t endAddress = flexspi_nand_page_address(handle, page);
+                (void)flexspi_nand_command(base, port, endAddress, NAND_CMD_LUT_SEQ_IDX_READCACHEEND);
+                (void)flexspi_nand_wait_bus_busy(base, memHandle, endAddress);
+            }
+
+            return status;
+        }
+    }
+
+    if (eccFailed)
+    {
+        status = kStatus_Fail;
+    }
+
+    return status;
+}
+
 status_t Nand_Flash_Page_Program(nand_handle_t *handle, uint32_t pageIndex, const uint8_t *src, uint32_t length)
 {
     status_t status;
     flexspi_transfer_t flashXfer;
-    uint32_t address                     = pageIndex * (handle->bytesInPageDataArea + handle->bytesInPageSpareArea);
+    uint32_t address                     = flexspi_nand_page_address(handle, pageIndex);
     flexspi_mem_nand_handle_t *memHandle = (flexspi_mem_nand_handle_t *)handle->deviceSpecific;
     flexspi_port_t port                  = memHandle->port;
 
@@ -376,7 +590,8 @@ status_t Nand_Flash_Page_Program(nand_handle_t *handle, uint32_t pageIndex, cons
     flashXfer.port          = port;
     flashXfer.cmdType       = kFLEXSPI_Write;
     flashXfer.SeqNumber     = 1;
-    flashXfer.seqIndex      = NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD;
+    flashXfer.seqIndex      = flexspi_nand_plane_seq(handle, pageIndex, NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD,
+                                                     NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD_ODD);
     flashXfer.data          = (uint32_t *)src;
     flashXfer.dataSize      = length;
 
@@ -398,21 +613,116 @@ status_t Nand_Flash_Page_Program(nand_handle_t *handle, uint32_t pageIndex, cons
         return status;
     }
 
-    status = flexspi_nand_wait_bus_busy((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address);
+    /* Program status is taken from the last busy poll, ECC status is not updated by program. */
+    uint32_t statusValue;
+    status = flexspi_nand_wait_status_bit((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address,
+                                          memHandle->busyOffset, &statusValue);
     if (status != kStatus_Success)
     {
         return status;
     }
 
-    bool isCheckPassed;
-    status = flexspi_nand_check_ecc_status((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address, &isCheckPassed);
+    if ((statusValue & NAND_STATUS_PROGRAM_FAIL_MASK) != 0U)
+    {
+        status = kStatus_Fail;
+    }
 
-    if (status != kStatus_Success)
+    return status;
+}
+
+status_t Nand_Flash_Program_Pages(
+    nand_handle_t *handle, uint32_t pageIndex, uint32_t pageCount, const uint8_t *src, uint32_t *failedPage)
+{
+    status_t status    = kStatus_Success;
+    bool programFailed = false;
+    uint32_t statusValue;
+
+    flexspi_transfer_t flashXfer;
+    FLEXSPI_Type *base                   = (FLEXSPI_Type *)handle->driverBaseAddr;
+    flexspi_mem_nand_handle_t *memHandle = (flexspi_mem_nand_handle_t *)handle->deviceSpecific;
+    flexspi_port_t port                  = memHandle->port;
+    /* Page whose program result is reported by the next status read, lags one page behind with cache program */
+    uint32_t pendingPage = pageIndex;
+
+    for (uint32_t page = pageIndex; page < (pageIndex + pageCount); page++)
     {
-        return status;
+        uint32_t address = flexspi_nand_page_address(handle, page);
+
+        /* Write enable. */
+        status = flexspi_nand_write_enable(base, port, address);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        /* Load page to cache, with cache program this overlaps the array program of the previous page. */
+        flashXfer.deviceAddress = address;
+        flashXfer.port          = port;
+        flashXfer.cmdType       = kFLEXSPI_Write;
+        flashXfer.SeqNumber     = 1;
+        flashXfer.seqIndex      = flexspi_nand_plane_seq(handle, page, NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD,
+                                                         NAND_CMD_LUT_SEQ_IDX_PROGRAMLOAD_ODD);
+        flashXfer.data          = (uint32_t *)src;
+        flashXfer.dataSize      = handle->bytesInPageDataArea;
+
+        status = FLEXSPI_TransferBlocking(base, &flashXfer);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        /* Send program execute command, the device takes it once the previous array program completes. */
+        status = flexspi_nand_command(base, port, address, NAND_CMD_LUT_SEQ_IDX_PROGRAMEXECUTE);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        /* Without cache program this waits for whole tPROG, with cache program just until cache is free again. */
+        status = flexspi_nand_wait_status_bit(base, memHandle, address, memHandle->busyOffset, &statusValue);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        /* Program status taken from the last busy poll, there is no separate status read per page. */
+        if ((memHandle->cacheProgram == false) || (page != pageIndex))
+        {
+            if (((statusValue & NAND_STATUS_PROGRAM_FAIL_MASK) != 0U) && (programFailed == false))
+            {
+                programFailed = true;
+                if (failedPage != NULL)
+                {
+                    *failedPage = pendingPage;
+                }
+            }
+            pendingPage = (memHandle->cacheProgram == false) ? (page + 1U) : page;
+        }
+
+        src += handle->bytesInPageDataArea;
     }
 
-    if (isCheckPassed == false)
+    /* Wait for the array program of the last page. */
+    if (memHandle->cacheProgram && (pageCount > 0U))
+    {
+        status = flexspi_nand_wait_status_bit(base, memHandle, flexspi_nand_page_address(handle, pendingPage),
+                                              memHandle->arrayBusyOffset, &statusValue);
+        if (status != kStatus_Success)
+        {
+            return status;
+        }
+
+        if (((statusValue & NAND_STATUS_PROGRAM_FAIL_MASK) != 0U) && (programFailed == false))
+        {
+            programFailed = true;
+            if (failedPage != NULL)
+            {
+                *failedPage = pendingPage;
+            }
+        }
+    }
+
+    if (programFailed)
     {
         status = kStatus_Fail;
     }
@@ -452,11 +762,19 @@ status_t Nand_Flash_Erase_Block(nand_handle_t *handle, uint32_t blockIndex)
         return status;
     }
 
-    status = flexspi_nand_wait_bus_busy((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address);
+    uint32_t statusValue;
+    status = flexspi_nand_wait_status_bit((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address,
+                                          memHandle->busyOffset, &statusValue);
     if (status != kStatus_Success)
     {
         return status;
     }
 
+    /* Erase failure, the block has gone bad. */
+    if ((statusValue & NAND_STATUS_ERASE_FAIL_MASK) != 0U)
+    {
+        status = kStatus_Fail;
+    }
+
     return status;
 }
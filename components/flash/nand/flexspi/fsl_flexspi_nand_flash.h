@@ -1,5 +1,5 @@
 /*
- * Copyright 2018 NXP
+ * Copyright 2018, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -41,6 +41,15 @@
 #define NAND_CMD_LUT_SEQ_IDX_SETFEATURE 11
 /*! @brief Unlock all blocks */
 #define NAND_CMD_LUT_SEQ_IDX_UNLOCKALL 12
+/*! @brief LUT sequence index for read cache sequential, moves next page to cache while the current one is read out */
+#define NAND_CMD_LUT_SEQ_IDX_READCACHESEQ 13
+/*! @brief LUT sequence index for read cache end, moves the last page of sequential read to cache */
+#define NAND_CMD_LUT_SEQ_IDX_READCACHEEND 14
+
+/*! @brief Program fail bit of status register (C0h), common to SPI-NAND devices */
+#define NAND_STATUS_PROGRAM_FAIL_MASK (0x08U)
+/*! @brief Erase fail bit of status register (C0h), common to SPI-NAND devices */
+#define NAND_STATUS_ERASE_FAIL_MASK (0x04U)
 
 /* !@brief FlexSPI Memory Configuration Block */
 typedef struct _flexspi_memory_config
@@ -56,6 +65,10 @@ typedef struct _flexspi_memory_config
     uint32_t eccStatusMask;   /*!< ECC status mask */
     uint32_t eccFailureMask;  /*!< ECC failure mask */
     uint32_t lookupTable[64]; /*!< Lookup table holds Flash command sequences */
+    uint32_t planesPerDevice; /*!< Planes in device, plane of odd blocks is selected by column address bit 12 if 2 */
+    bool cacheRead;           /*!< Device supports sequential cache read (31h/3Fh), pages are read one by one if not */
+    bool cacheProgram;        /*!< Device accepts program load while array program of previous page is in progress */
+    uint16_t arrayBusyOffset; /*!< Status bit set while array program is in progress, only need for cacheProgram */
 } flexspi_mem_config_t;
 
 /*!@brief NAND Flash handle info*/
@@ -67,5 +80,8 @@ typedef struct _flexspi_mem_nand_handle
                                    when flash device is busy, only need for check option kNandReadyCheckOption_RB */
     uint32_t eccStatusMask;   /*!< ECC status mask */
     uint32_t eccFailureMask;  /*!< ECC failure mask */
+    bool cacheRead;           /*!< Device supports sequential cache read (31h/3Fh), pages are read one by one if not */
+    bool cacheProgram;        /*!< Device accepts program load while array program of previous page is in progress */
+    uint16_t arrayBusyOffset; /*!< Status bit set while array program is in progress, only need for cacheProgram */
 } flexspi_mem_nand_handle_t;
 /*! @} */
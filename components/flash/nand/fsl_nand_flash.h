@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2020 NXP
+ * Copyright 2018-2020, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -37,6 +37,7 @@ typedef struct _nand_handle
     uint32_t pagesInBlock;         /*!< Pages in each block. */
     uint32_t blocksInPlane;        /*!< blocks in each plane. */
     uint32_t planesInDevice;       /*!< planes in each device .*/
+    uint32_t eccCorrectedPages;    /*!< Pages read with bit errors corrected by ECC, only counted by the driver. */
     /*------------Specific parameters used for specific nand flash controller ----------*/
     void *deviceSpecific; /*!< Device specific control parameter */
 } nand_handle_t;
@@ -103,6 +104,23 @@ status_t Nand_Flash_Read_Page(nand_handle_t *handle, uint32_t pageIndex, uint8_t
 status_t Nand_Flash_Read_Page_Partial(
     nand_handle_t *handle, uint32_t pageIndex, uint32_t offset_bytes, uint8_t *buffer, uint32_t length);
 
+/*!
+ * @brief Read consecutive pages from NAND Flash.
+ *
+ * Uses sequential cache read where the device supports it, so loading of the next page from the array overlaps with
+ * the transfer of the current one, each page is read by its own page read otherwise. ECC status is still checked for
+ * every page, reading continues on ECC failure. The sequence is terminated before other errors are returned.
+ *
+ * @param handle    The NAND Flash handler.
+ * @param pageIndex  Nand flash index of the first page, range from 0 ~ xxx.
+ * @param pageCount  Number of pages to read.
+ * @param buffer  Nand flash buffer to read data to, data area of the pages one after another.
+ * @param eccFailedPage  Index of the first page failing ECC check, may be NULL.
+ * @retval kStatus_Fail if any page failed ECC check, other execution status otherwise
+ */
+status_t Nand_Flash_Read_Pages(
+    nand_handle_t *handle, uint32_t pageIndex, uint32_t pageCount, uint8_t *buffer, uint32_t *eccFailedPage);
+
 /*!
  * @brief Program page data to NAND Flash.
  *
@@ -110,16 +128,32 @@ status_t Nand_Flash_Read_Page_Partial(
  * @param pageIndex  Nand flash page index, range from 0 ~ xxx.
  * @param src  The data to be programed to the page.
  * @param length  Nand flash read length.
- * @retval execution status
+ * @retval kStatus_Fail if the device reports program failure, other execution status otherwise
  */
 status_t Nand_Flash_Page_Program(nand_handle_t *handle, uint32_t pageIndex, const uint8_t *src, uint32_t length);
 
+/*!
+ * @brief Program consecutive pages to NAND Flash.
+ *
+ * Data of the next page is loaded while the array program of the current one is in progress if the device supports
+ * cache program. Program status is taken from the busy polling, programming continues on program failure.
+ *
+ * @param handle    The NAND Flash handler.
+ * @param pageIndex  Nand flash index of the first page, range from 0 ~ xxx.
+ * @param pageCount  Number of pages to program.
+ * @param src  The data to be programed to the pages, data area of the pages one after another.
+ * @param failedPage  Index of the first page failing to program, may be NULL.
+ * @retval kStatus_Fail if program of any page failed, other execution status otherwise
+ */
+status_t Nand_Flash_Program_Pages(
+    nand_handle_t *handle, uint32_t pageIndex, uint32_t pageCount, const uint8_t *src, uint32_t *failedPage);
+
 /*!
  * @brief Erase block NAND Flash.
  *
  * @param handle    The NAND Flash handler.
  * @param blockIndex  Nand flash block index to be erased, range from 0 ~ xxx.
- * @retval execution status
+ * @retval kStatus_Fail if the device reports erase failure, other execution status otherwise
  */
 status_t Nand_Flash_Erase_Block(nand_handle_t *handle, uint32_t blockIndex);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2019-2023, 2024 NXP
+ * Copyright 2019-2023, 2024, 2026 NXP
  *
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -7,6 +7,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include "fsl_nor_flash.h"
 #include "fsl_flexspi_nor_flash.h"
@@ -1010,6 +1011,8 @@ typedef struct _jdec_query_table
  ******************************************************************************/
 static void FLEXSPI_NOR_Memset(void *src, uint8_t value, size_t length);
 
+static void FLEXSPI_NOR_Memcpy(void *dst, const void *src, size_t length);
+
 static status_t FLEXSPI_NOR_PrepareQuadModeEnableSequence(nor_handle_t *handle,
                                                           flexspi_mem_config_t *config,
                                                           jedec_info_table_t *tbl);
@@ -1045,12 +1048,31 @@ static status_t FLEXSPI_NOR_WaitBusBusy(FLEXSPI_Type *base, flexspi_mem_nor_hand
 
 static status_t FLEXSPI_NOR_WriteEnable(FLEXSPI_Type *base, flexspi_port_t port, uint32_t baseAddr);
 
+static status_t FLEXSPI_NOR_ProgramPage(nor_handle_t *handle, uint32_t address, uint8_t *buffer, uint32_t length);
+
+#if defined(FLEXSPI_NOR_CONFIG_CACHE) && FLEXSPI_NOR_CONFIG_CACHE
+static uint32_t FLEXSPI_NOR_Crc32(uint32_t crc, const void *data, uint32_t length);
+
+static uint32_t FLEXSPI_NOR_ConfigCrc(const flexspi_mem_config_t *config);
+
+static uint32_t FLEXSPI_NOR_ConfigCacheDigest(const flexspi_nor_config_cache_t *cache);
+
+static status_t FLEXSPI_NOR_LoadConfigCache(nor_handle_t *handle,
+                                            flexspi_mem_config_t *config,
+                                            flexspi_nor_config_cache_t *cache);
+
+static status_t FLEXSPI_NOR_SaveConfigCache(nor_handle_t *handle,
+                                            flexspi_mem_config_t *config,
+                                            flexspi_nor_config_cache_t *cache);
+#endif /* FLEXSPI_NOR_CONFIG_CACHE */
+
 static status_t FLEXSPI_NOR_ParseSFDP(nor_handle_t *handle, flexspi_mem_config_t *config, jedec_info_table_t *tbl);
 
 static status_t FLEXSPI_NOR_GetPageSectorBlockSizeFromSFDP(nor_handle_t *handle,
                                                            jedec_info_table_t *tbl,
                                                            uint32_t *sector_erase_cmd,
-                                                           uint32_t *block_erase_cmd);
+                                                           uint32_t *block_erase_cmd,
+                                                           uint32_t *block_size);
 
 status_t FLEXSPI_NOR_ExitNoCMDMode(nor_handle_t *handle, flexspi_mem_config_t *config, uint32_t baseAddr);
 /*******************************************************************************
@@ -1074,25 +1096,34 @@ static void FLEXSPI_NOR_Memset(void *src, uint8_t value, size_t length)
     }
 }
 
+static void FLEXSPI_NOR_Memcpy(void *dst, const void *src, size_t length)
+{
+    assert(dst != NULL);
+    assert(src != NULL);
+
+    uint32_t i;
+    volatile uint8_t *d = dst;
+    const uint8_t *p    = src;
+
+    for (i = 0U; i < length; i++)
+    {
+        *d = *p;
+        d++;
+        p++;
+    }
+}
+
 static status_t FLEXSPI_NOR_WaitBusBusy(FLEXSPI_Type *base, flexspi_mem_nor_handle_t *handle, uint32_t baseAddr)
 {
     /* Wait status ready. */
     bool isBusy = true;
     uint32_t readValue;
     status_t status = kStatus_InvalidArgument;
-    flexspi_transfer_t flashXfer;
-
-    flashXfer.deviceAddress = baseAddr;
-    flashXfer.port          = handle->port;
-    flashXfer.cmdType       = kFLEXSPI_Read;
-    flashXfer.SeqNumber     = 1;
-    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READSTATUS;
-    flashXfer.data          = &readValue;
-    flashXfer.dataSize      = 1;
+    uint32_t ipcr1  = FLEXSPI_GetIpCommandConfig(base, NOR_CMD_LUT_SEQ_IDX_READSTATUS, 1, 1);
 
     do
     {
-        status = FLEXSPI_TransferBlocking(base, &flashXfer);
+        status = FLEXSPI_ReadRegisterFast(base, baseAddr, ipcr1, &readValue);
 
         if (status != kStatus_Success)
         {
@@ -1345,7 +1376,8 @@ static status_t FLEXSPI_NOR_ReadSFDPInfo(FLEXSPI_Type *base, jedec_info_table_t
 static status_t FLEXSPI_NOR_GetPageSectorBlockSizeFromSFDP(nor_handle_t *handle,
                                                            jedec_info_table_t *tbl,
                                                            uint32_t *sector_erase_cmd,
-                                                           uint32_t *block_erase_cmd)
+                                                           uint32_t *block_erase_cmd,
+                                                           uint32_t *block_size)
 {
     assert(handle != NULL);
     assert(tbl != NULL);
@@ -1426,12 +1458,14 @@ static status_t FLEXSPI_NOR_GetPageSectorBlockSizeFromSFDP(nor_handle_t *handle,
                 /* Calculate max non-zero block size */
                 if ((current_erase_size > blockSize) && (current_erase_size < (1024U * 1024U)))
                 {
+                    blockSize      = current_erase_size;
                     blockEraseType = i;
                 }
             }
         }
 
         handle->bytesInSectorSize = sectorSize;
+        *block_size               = blockSize;
 
         /* Calculate erase instruction operand for LUT */
         if ((flashSize > MAX_24BIT_ADDRESSING_SIZE) && (tbl->has_4b_addressing_inst_table))
@@ -1479,7 +1513,8 @@ static status_t FLEXSPI_NOR_ParseSFDP(nor_handle_t *handle, flexspi_mem_config_t
         bool supportOctalCmdMode = false;
 
         /* Get page and sector information from SFDP. */
-        status = FLEXSPI_NOR_GetPageSectorBlockSizeFromSFDP(handle, tbl, &sectorEraseCmd, &blockEraseCmd);
+        status = FLEXSPI_NOR_GetPageSectorBlockSizeFromSFDP(handle, tbl, &sectorEraseCmd, &blockEraseCmd,
+                                                            &config->bytesInBlockSize);
 
         if (status != kStatus_Success)
         {
@@ -1831,6 +1866,7 @@ static status_t FLEXSPI_NOR_ParseSFDP(nor_handle_t *handle, flexspi_mem_config_t
 
                 /* Erase Block */
                 /* Macronix Block(64KB) erase is 0xDC and 0x23 */
+                config->bytesInBlockSize = 64U * 1024U;
                 config->lookupTable[4U * NOR_CMD_LUT_SEQ_IDX_ERASEBLOCK] =
                     FLEXSPI_LUT_SEQ(cmdInst, kFLEXSPI_8PAD, kOctalSerialNorCmd_BlockErase_4B_1st, cmdInst,
                                     kFLEXSPI_8PAD, kOctalSerialNorCmd_BlockErase_4B_2nd);
@@ -3662,25 +3698,13 @@ status_t Nor_Flash_Erase(nor_handle_t *handle, uint32_t address, uint32_t size_B
     return status;
 }
 
-status_t Nor_Flash_Page_Program(nor_handle_t *handle, uint32_t address, uint8_t *buffer)
+/* Program data within single page, the device accepts shorter length than page size and programs just the given bytes */
+static status_t FLEXSPI_NOR_ProgramPage(nor_handle_t *handle, uint32_t address, uint8_t *buffer, uint32_t length)
 {
-    assert(handle != NULL);
-    assert(buffer != NULL);
-
     status_t status = kStatus_InvalidArgument;
     flexspi_transfer_t flashXfer;
     flexspi_mem_nor_handle_t *memHandle = (flexspi_mem_nor_handle_t *)handle->deviceSpecific;
     flexspi_port_t port                 = memHandle->port;
-    uint32_t pageSize                   = handle->bytesInPageSize;
-
-    /* To make sure external flash be in idle status, added wait for busy before program data for
-       an external flash without RWW(read while write) attribute.*/
-    status = FLEXSPI_NOR_WaitBusBusy((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address);
-
-    if (kStatus_Success != status)
-    {
-        return status;
-    }
 
     /* Write enable. */
     status = FLEXSPI_NOR_WriteEnable((FLEXSPI_Type *)handle->driverBaseAddr, port, address);
@@ -3694,7 +3718,7 @@ status_t Nor_Flash_Page_Program(nor_handle_t *handle, uint32_t address, uint8_t
         flashXfer.SeqNumber     = 1;
         flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_PAGEPROGRAM;
         flashXfer.data          = (uint32_t *)(void *)buffer;
-        flashXfer.dataSize      = pageSize;
+        flashXfer.dataSize      = length;
 
         status = FLEXSPI_TransferBlocking((FLEXSPI_Type *)handle->driverBaseAddr, &flashXfer);
 
@@ -3707,22 +3731,53 @@ status_t Nor_Flash_Page_Program(nor_handle_t *handle, uint32_t address, uint8_t
     return status;
 }
 
+status_t Nor_Flash_Page_Program(nor_handle_t *handle, uint32_t address, uint8_t *buffer)
+{
+    assert(handle != NULL);
+    assert(buffer != NULL);
+
+    status_t status                     = kStatus_InvalidArgument;
+    flexspi_mem_nor_handle_t *memHandle = (flexspi_mem_nor_handle_t *)handle->deviceSpecific;
+
+    /* To make sure external flash be in idle status, added wait for busy before program data for
+       an external flash without RWW(read while write) attribute.*/
+    status = FLEXSPI_NOR_WaitBusBusy((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address);
+
+    if (kStatus_Success != status)
+    {
+        return status;
+    }
+
+    return FLEXSPI_NOR_ProgramPage(handle, address, buffer, handle->bytesInPageSize);
+}
+
 status_t Nor_Flash_Program(nor_handle_t *handle, uint32_t address, uint8_t *buffer, uint32_t length)
 {
     assert(handle != NULL);
     assert(buffer != NULL);
-    uint32_t startAddress = address;
-    status_t status       = kStatus_Success;
 
-    for (uint32_t i = 0x00U; i <= (length / handle->bytesInPageSize); i++)
+    status_t status                     = kStatus_InvalidArgument;
+    flexspi_mem_nor_handle_t *memHandle = (flexspi_mem_nor_handle_t *)handle->deviceSpecific;
+    uint32_t pageSize                   = handle->bytesInPageSize;
+    uint32_t chunkSize;
+
+    /* Make sure the device is idle, then every page waits just for its own completion. */
+    status = FLEXSPI_NOR_WaitBusBusy((FLEXSPI_Type *)handle->driverBaseAddr, memHandle, address);
+
+    while ((kStatus_Success == status) && (length > 0x00U))
     {
-        status = Nor_Flash_Page_Program(handle, startAddress, buffer);
-        /* Avoid buffer overflow. */
-        if (length >= handle->bytesInPageSize)
+        /* Split at page boundaries, partial head and tail pages are programmed by exact byte count. */
+        chunkSize = pageSize - (address % pageSize);
+        if (chunkSize > length)
         {
-            buffer += handle->bytesInPageSize;
-            startAddress += handle->bytesInPageSize;
+            chunkSize = length;
         }
+
+        status = FLEXSPI_NOR_ProgramPage(handle, address, buffer, chunkSize);
+
+        address += chunkSize;
+        buffer += chunkSize;
+        length -= chunkSize;
     }
 
     return status;
@@ -3757,6 +3812,222 @@ status_t Nor_Flash_Read(nor_handle_t *handle, uint32_t address, uint8_t *buffer,
     return status;
 }
 
+#if defined(FLEXSPI_NOR_CONFIG_CACHE) && FLEXSPI_NOR_CONFIG_CACHE
+/* Continues CRC-32 of previous data, start with 0xFFFFFFFF and invert the final value. */
+static uint32_t FLEXSPI_NOR_Crc32(uint32_t crc, const void *data, uint32_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while (length-- > 0U)
+    {
+        crc ^= *bytes++;
+        for (uint32_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = ((crc & 1U) != 0U) ? ((crc >> 1U) ^ 0xEDB88320U) : (crc >> 1U);
+        }
+    }
+
+    return crc;
+}
+
+#define FLEXSPI_NOR_CRC_FIELD(crc, field) (crc) = FLEXSPI_NOR_Crc32((crc), &(field), sizeof(field))
+
+/* CRC of the configuration passed to Nor_Flash_Init. Fields are hashed one by one so that padding bytes, left
+ * uninitialized in configurations built on the stack, do not take part. forceProbe is not part of the CRC. */
+static uint32_t FLEXSPI_NOR_ConfigCrc(const flexspi_mem_config_t *config)
+{
+    const flexspi_device_config_t *device = &config->deviceConfig;
+    uint32_t crc                          = 0xFFFFFFFFU;
+
+    FLEXSPI_NOR_CRC_FIELD(crc, device->flexspiRootClk);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->isSck2Enabled);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->flashSize);
+#if defined(FSL_FEATURE_FLEXSPI_SUPPORT_ADDRESS_SHIFT) && (FSL_FEATURE_FLEXSPI_SUPPORT_ADDRESS_SHIFT)
+    FLEXSPI_NOR_CRC_FIELD(crc, device->addressShift);
+#endif /* FSL_FEATURE_FLEXSPI_SUPPORT_ADDRESS_SHIFT */
+    FLEXSPI_NOR_CRC_FIELD(crc, device->CSIntervalUnit);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->CSInterval);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->CSHoldTime);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->CSSetupTime);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->dataValidTime);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->columnspace);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->enableWordAddress);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->AWRSeqIndex);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->AWRSeqNumber);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->ARDSeqIndex);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->ARDSeqNumber);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->AHBWriteWaitUnit);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->AHBWriteWaitInterval);
+    FLEXSPI_NOR_CRC_FIELD(crc, device->enableWriteMask);
+#if defined(FSL_FEATURE_FLEXSPI_HAS_ERRATA_051426) && (FSL_FEATURE_FLEXSPI_HAS_ERRATA_051426)
+    FLEXSPI_NOR_CRC_FIELD(crc, device->isFroClockSource);
+#endif
+
+    FLEXSPI_NOR_CRC_FIELD(crc, config->devicePort);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->deviceType);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->CurrentCommandMode);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->transferMode);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->quadMode);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->enhanceMode);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->commandPads);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->queryPads);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->statusOverride);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->controllerMiscOption);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->bytesInPageSize);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->bytesInSectorSize);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->bytesInMemorySize);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->bytesInBlockSize);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->busyOffset);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->busyBitPolarity);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->ipcmdSerialClkFreq);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->lookupTable);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->serialNorType);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->needExitNoCmdMode);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->halfClkForNonReadCmd);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->needRestoreNoCmdMode);
+    FLEXSPI_NOR_CRC_FIELD(crc, config->deviceModeCfgEnable);
+
+    return ~crc;
+}
+
+/* Digest of the meaningful content of the cache record, equal for records of repeated probes of the same device. */
+static uint32_t FLEXSPI_NOR_ConfigCacheDigest(const flexspi_nor_config_cache_t *cache)
+{
+    uint32_t configCrc = FLEXSPI_NOR_ConfigCrc(&cache->config);
+    uint32_t crc       = FLEXSPI_NOR_Crc32(0xFFFFFFFFU, cache, offsetof(flexspi_nor_config_cache_t, config));
+
+    FLEXSPI_NOR_CRC_FIELD(crc, configCrc);
+
+    return ~crc;
+}
+
+/* Reads the cached configuration and applies it if it belongs to the connected device and the given configuration.
+ * On a miss the cache header is left filled in for FLEXSPI_NOR_SaveConfigCache, crc then holds the digest of the
+ * valid record found in FLASH (0 if none) so that an unchanged record is not written again. */
+static status_t FLEXSPI_NOR_LoadConfigCache(nor_handle_t *handle,
+                                            flexspi_mem_config_t *config,
+                                            flexspi_nor_config_cache_t *cache)
+{
+    status_t status                     = kStatus_InvalidArgument;
+    flexspi_mem_nor_handle_t *memHandle = (flexspi_mem_nor_handle_t *)handle->deviceSpecific;
+    FLEXSPI_Type *base                  = (FLEXSPI_Type *)handle->driverBaseAddr;
+    bool forceProbe                     = config->forceProbe;
+    uint32_t jedecId                    = 0U;
+    uint32_t inputCrc                   = FLEXSPI_NOR_ConfigCrc(config);
+    bool stored;
+    flexspi_transfer_t flashXfer;
+
+    /* Read JEDEC ID and fast read in 1-1-1 mode, the state of the device after reset. */
+    const lut_seq_t readIdLut = {{FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, kSerialFlash_ReadJEDECId,
+                                                  kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04),
+                                  0, 0, 0}};
+#if (FLEXSPI_NOR_CONFIG_CACHE_OFFSET < MAX_24BIT_ADDRESSING_SIZE)
+    const lut_seq_t readLut = {
+        {FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x0B, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 24),
+         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_1PAD, 8, kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04),
+         0, 0}};
+#else
+    const lut_seq_t readLut = {
+        {FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x0C, kFLEXSPI_Command_RADDR_SDR, kFLEXSPI_1PAD, 32),
+         FLEXSPI_LUT_SEQ(kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_1PAD, 8, kFLEXSPI_Command_READ_SDR, kFLEXSPI_1PAD, 0x04),
+         0, 0}};
+#endif
+
+    FLEXSPI_UpdateLUT(base, NOR_CMD_LUT_SEQ_IDX_READID * 4UL, (const uint32_t *)(const void *)&readIdLut, 4);
+    FLEXSPI_UpdateLUT(base, NOR_CMD_LUT_SEQ_IDX_READ_SFDP * 4UL, (const uint32_t *)(const void *)&readLut, 4);
+    FLEXSPI_SoftwareReset(base);
+
+    flashXfer.deviceAddress = 0U;
+    flashXfer.port          = memHandle->port;
+    flashXfer.cmdType       = kFLEXSPI_Read;
+    flashXfer.SeqNumber     = 1U;
+    flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READID;
+    flashXfer.data          = &jedecId;
+    flashXfer.dataSize      = 3U;
+    status                  = FLEXSPI_TransferBlocking(base, &flashXfer);
+
+    if (kStatus_Success == status)
+    {
+        flashXfer.deviceAddress = FLEXSPI_NOR_CONFIG_CACHE_OFFSET;
+        flashXfer.seqIndex      = NOR_CMD_LUT_SEQ_IDX_READ_SFDP;
+        flashXfer.data          = (uint32_t *)(void *)cache;
+        flashXfer.dataSize      = sizeof(*cache);
+        status                  = FLEXSPI_TransferBlocking(base, &flashXfer);
+    }
+
+    stored = (kStatus_Success == status) && (cache->tag == FLEXSPI_NOR_CONFIG_CACHE_TAG) &&
+             (cache->crc == ~FLEXSPI_NOR_Crc32(0xFFFFFFFFU, cache, offsetof(flexspi_nor_config_cache_t, crc)));
+
+    if (stored && (false == forceProbe) && (jedecId != 0U) && (jedecId != 0xFFFFFFU) && (cache->jedecId == jedecId) &&
+        (cache->inputCrc == inputCrc))
+    {
+        FLEXSPI_NOR_Memcpy(config, &cache->config, sizeof(*config));
+        config->forceProbe        = false;
+        handle->bytesInPageSize   = cache->bytesInPageSize;
+        handle->bytesInSectorSize = cache->bytesInSectorSize;
+        handle->bytesInMemorySize = cache->bytesInMemorySize;
+    }
+    else
+    {
+        cache->crc      = stored ? FLEXSPI_NOR_ConfigCacheDigest(cache) : 0U;
+        cache->tag      = FLEXSPI_NOR_CONFIG_CACHE_TAG;
+        cache->jedecId  = jedecId;
+        cache->inputCrc = inputCrc;
+        status          = kStatus_Fail;
+
+        /* Restore sequences replaced above for the probe. */
+        FLEXSPI_UpdateLUT(base, NOR_CMD_LUT_SEQ_IDX_READID * 4UL,
+                          &config->lookupTable[4U * NOR_CMD_LUT_SEQ_IDX_READID], 4);
+        FLEXSPI_UpdateLUT(base, NOR_CMD_LUT_SEQ_IDX_READ_SFDP * 4UL,
+                          &config->lookupTable[4U * NOR_CMD_LUT_SEQ_IDX_READ_SFDP], 4);
+    }
+
+    return status;
+}
+
+/* Stores configuration generated by the probe, LUT of the configuration has to be applied already. */
+static status_t FLEXSPI_NOR_SaveConfigCache(nor_handle_t *handle,
+                                            flexspi_mem_config_t *config,
+                                            flexspi_nor_config_cache_t *cache)
+{
+    status_t status = kStatus_FlexSPINOR_NotSupported;
+
+    /* Device mode entered by the probe would not survive reset, ID read in 1-1-1 mode would not succeed either. */
+    if ((config->CurrentCommandMode == kSerialNorCommandMode_1_1_1) && (cache->jedecId != 0U) &&
+        (cache->jedecId != 0xFFFFFFU))
+    {
+        uint32_t storedDigest = cache->crc;
+
+        FLEXSPI_NOR_Memcpy(&cache->config, config, sizeof(*config));
+        cache->config.forceProbe = false;
+        cache->bytesInPageSize   = handle->bytesInPageSize;
+        cache->bytesInSectorSize = handle->bytesInSectorSize;
+        cache->bytesInMemorySize = handle->bytesInMemorySize;
+        cache->crc               = ~FLEXSPI_NOR_Crc32(0xFFFFFFFFU, cache, offsetof(flexspi_nor_config_cache_t, crc));
+
+        /* Forced probes of the same device end up with the same record, rewrite the sector only if it differs. */
+        if (storedDigest == FLEXSPI_NOR_ConfigCacheDigest(cache))
+        {
+            status = kStatus_Success;
+        }
+        else
+        {
+            status = Nor_Flash_Erase_Sector(handle, FLEXSPI_NOR_CONFIG_CACHE_OFFSET);
+            if (kStatus_Success == status)
+            {
+                status = Nor_Flash_Program(handle, FLEXSPI_NOR_CONFIG_CACHE_OFFSET, (uint8_t *)(void *)cache,
+                                           sizeof(*cache));
+            }
+        }
+
+        /* Do software reset. */
+        FLEXSPI_SoftwareReset((FLEXSPI_Type *)handle->driverBaseAddr);
+    }
+
+    return status;
+}
+#endif /* FLEXSPI_NOR_CONFIG_CACHE */
+
 status_t Nor_Flash_Init(nor_config_t *config, nor_handle_t *handle)
 {
     assert(config != NULL);
@@ -3769,6 +4040,10 @@ status_t Nor_Flash_Init(nor_config_t *config, nor_handle_t *handle)
     flexspiMemHandle.configuredFlashSize = memConfig->deviceConfig.flashSize;
     flexspiMemHandle.port                = memConfig->devicePort;
     flexspi_config_t flexspiConfig;
+#if defined(FLEXSPI_NOR_CONFIG_CACHE) && FLEXSPI_NOR_CONFIG_CACHE
+    flexspi_nor_config_cache_t configCache;
+    bool cacheHit = false;
+#endif /* FLEXSPI_NOR_CONFIG_CACHE */
 
 #if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1U)
     bool ICacheEnableFlag = false;
@@ -3812,7 +4087,17 @@ status_t Nor_Flash_Init(nor_config_t *config, nor_handle_t *handle)
     FLEXSPI_UpdateLUT((FLEXSPI_Type *)handle->driverBaseAddr, 0, memConfig->lookupTable,
                       sizeof(memConfig->lookupTable) / sizeof(memConfig->lookupTable[0]));
 
-    status = FLEXSPI_NOR_GenerateConfigBlockUsingSFDP(handle, memConfig);
+#if defined(FLEXSPI_NOR_CONFIG_CACHE) && FLEXSPI_NOR_CONFIG_CACHE
+    status = FLEXSPI_NOR_LoadConfigCache(handle, memConfig, &configCache);
+    if (kStatus_Success == status)
+    {
+        cacheHit = true;
+    }
+    else
+#endif /* FLEXSPI_NOR_CONFIG_CACHE */
+    {
+        status = FLEXSPI_NOR_GenerateConfigBlockUsingSFDP(handle, memConfig);
+    }
 
     if (kStatus_Success == status)
     {
@@ -3822,6 +4107,14 @@ status_t Nor_Flash_Init(nor_config_t *config, nor_handle_t *handle)
 
         /* Do software reset. */
         FLEXSPI_SoftwareReset((FLEXSPI_Type *)handle->driverBaseAddr);
+
+#if defined(FLEXSPI_NOR_CONFIG_CACHE) && FLEXSPI_NOR_CONFIG_CACHE
+        if (false == cacheHit)
+        {
+            /* The cache only saves time of next initialization, its update failure is not an error. */
+            (void)FLEXSPI_NOR_SaveConfigCache(handle, memConfig, &configCache);
+        }
+#endif /* FLEXSPI_NOR_CONFIG_CACHE */
     }
 
 #if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1U)
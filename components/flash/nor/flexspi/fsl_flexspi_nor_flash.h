@@ -1,5 +1,5 @@
 /*
- * Copyright 2019-2022 NXP
+ * Copyright 2019-2022, 2026 NXP
  *
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -152,6 +152,7 @@ typedef struct _flexspi_memory_config
     uint32_t bytesInPageSize;      /*!< Page size in byte of Serial NOR */
     uint32_t bytesInSectorSize;    /*!< Minimun Sector size in byte supported by Serial NOR */
     uint32_t bytesInMemorySize;    /*!< Memory size in byte of Serial NOR */
+    uint32_t bytesInBlockSize;     /*!< Erase unit in byte of Nor_Flash_Erase_Block, set by the SFDP probe */
     uint16_t busyOffset; /*!< Busy offset, valid value: 0-31, only need for check option kNandReadyCheckOption_RB */
     uint16_t busyBitPolarity;   /*!< Busy flag polarity, 0 - busy flag is 1 when flash device is busy, 1 -busy flag is 0
                                      when flash device is busy, only need for check option kNandReadyCheckOption_RB */
@@ -162,8 +163,46 @@ typedef struct _flexspi_memory_config
     bool halfClkForNonReadCmd;  /*!< Half the Serial Clock for non-read command: true/false*/
     uint8_t needRestoreNoCmdMode; /*!< Need to Restore NoCmd mode after IP commmand execution*/
     bool deviceModeCfgEnable;     /*!< Device Mode Configure enable flag, true - Enable, false - Disable*/
+    bool forceProbe; /*!< Ignore configuration cached in FLASH, probe the device and refresh the cache */
 } flexspi_mem_config_t;
 
+/*
+ * Configuration cache
+ *
+ * Probing the device through SFDP takes thousands of IP commands. When enabled, the configuration generated by the
+ * first successful probe is stored to a reserved sector together with the JEDEC ID of the device and the CRC of the
+ * configuration passed to Nor_Flash_Init. Next Nor_Flash_Init reads the JEDEC ID and the cached configuration (two IP
+ * commands) and uses it if both match, otherwise it probes again. Set forceProbe in the configuration to ignore the
+ * cache. Only configurations leaving the device in 1-1-1 command mode are cached, as octal mode entry is volatile.
+ * The CRC covers the configuration fields only, padding of configurations built on the stack does not need clearing.
+ * The sector is not rewritten when a probe produces the record it already holds.
+ */
+#ifndef FLEXSPI_NOR_CONFIG_CACHE
+#define FLEXSPI_NOR_CONFIG_CACHE (0)
+#endif
+
+#if defined(FLEXSPI_NOR_CONFIG_CACHE) && FLEXSPI_NOR_CONFIG_CACHE
+/* Device address of the sector reserved for the cache, aligned to the device sector size */
+#ifndef FLEXSPI_NOR_CONFIG_CACHE_OFFSET
+#error "FLEXSPI_NOR_CONFIG_CACHE_OFFSET has to be defined to the sector reserved for the configuration cache"
+#endif
+
+#define FLEXSPI_NOR_CONFIG_CACHE_TAG (0x43524F4EU) /* "NORC" */
+
+/*! @brief Configuration cache record as stored in FLASH */
+typedef struct _flexspi_nor_config_cache
+{
+    uint32_t tag;                /*!< FLEXSPI_NOR_CONFIG_CACHE_TAG */
+    uint32_t jedecId;            /*!< Manufacturer ID, memory type and capacity read by 9Fh command */
+    uint32_t inputCrc;           /*!< CRC of the configuration passed to Nor_Flash_Init */
+    uint32_t bytesInPageSize;    /*!< Page size in byte of Serial NOR */
+    uint32_t bytesInSectorSize;  /*!< Minimun Sector size in byte supported by Serial NOR */
+    uint32_t bytesInMemorySize;  /*!< Memory size in byte of Serial NOR */
+    flexspi_mem_config_t config; /*!< Configuration generated by the probe */
+    uint32_t crc;                /*!< CRC of all the fields above */
+} flexspi_nor_config_cache_t;
+#endif
+
 /*! @brief NOR Flash handle info */
 typedef struct _flexspi_mem_nor_handle
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright 2019-2022 NXP
+ * Copyright 2019-2022, 2026 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -99,10 +99,13 @@ status_t Nor_Flash_Page_Program(nor_handle_t *handle, uint32_t address, uint8_t
 /*!
  * @brief Program data to NOR Flash.
  *
+ * The range does not need to be page aligned. It is split at page boundaries, partial pages at its head and tail
+ * are programmed by exact byte count, so no data outside of the range is touched.
+ *
  * @param handle    The NOR Flash handler.
  * @param address  The address to be programed.
- * @param buffer  The buffer to be programed to the page.
- * @param length  The data length to be programed to the page.
+ * @param buffer  The buffer to be programed.
+ * @param length  The data length to be programed, in bytes.
  * @retval execution status
  */
 status_t Nor_Flash_Program(nor_handle_t *handle, uint32_t address, uint8_t *buffer, uint32_t length);
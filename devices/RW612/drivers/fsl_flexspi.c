@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2016, Freescale Semiconductor, Inc.
- * Copyright 2016-2022, 2023-2025 NXP
+ * Copyright 2016-2022, 2023-2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -969,6 +969,51 @@ status_t FLEXSPI_TransferBlocking(FLEXSPI_Type *base, flexspi_transfer_t *xfer)
     return result;
 }
 
+/*!
+ * brief Reads a device register of up to 4 bytes using a lean blocking IP command.
+ *
+ * Intended for tight polling loops, for example waiting for the busy bit of a flash status register.
+ * param base FLEXSPI peripheral base address
+ * param deviceAddress Device address the command is issued to.
+ * param ipcr1 IPCR1 value prepared by FLEXSPI_GetIpCommandConfig.
+ * param value Pointer to store the data read.
+ * retval kStatus_Success register read without error
+ * retval kStatus_FLEXSPI_SequenceExecutionTimeout sequence execution timeout
+ * retval kStatus_FLEXSPI_IpCommandSequenceError IP command sequence error detected
+ * retval kStatus_FLEXSPI_IpCommandGrantTimeout IP command grant timeout detected
+ */
+status_t FLEXSPI_ReadRegisterFast(FLEXSPI_Type *base, uint32_t deviceAddress, uint32_t ipcr1, uint32_t *value)
+{
+    uint32_t status;
+
+    assert(NULL != value);
+
+    /* Clear done flag of the previous command and start the transfer. */
+    base->INTR  = FLEXSPI_INTR_IPCMDDONE_MASK;
+    base->IPCR0 = deviceAddress;
+    base->IPCR1 = ipcr1;
+    base->IPCMD = FLEXSPI_IPCMD_TRG_MASK;
+
+    /* Wait until the IP command execution finishes or fails. */
+    do
+    {
+        status = base->INTR;
+    } while (0U == (status & ((uint32_t)kFLEXSPI_IpCommandExecutionDoneFlag | (uint32_t)kErrorFlags)));
+
+    if (0U != (status & (uint32_t)kErrorFlags))
+    {
+        /* Drop any partial data so that the next command starts with empty FIFO. */
+        base->IPRXFCR |= FLEXSPI_IPRXFCR_CLRIPRXF_MASK;
+        return FLEXSPI_CheckAndClearError(base, status);
+    }
+
+    /* Read the data and pop it out from IP RX FIFO. */
+    *value     = base->RFDR[0];
+    base->INTR = (uint32_t)kFLEXSPI_IpRxFifoWatermarkAvailableFlag;
+
+    return kStatus_Success;
+}
+
 /*!
  * brief Initializes the FLEXSPI handle which is used in transactional functions.
  *
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2016, Freescale Semiconductor, Inc.
- * Copyright 2016-2025 NXP
+ * Copyright 2016-2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -25,7 +25,7 @@
 /*! @name Driver version */
 /*! @{ */
 /*! @brief FLEXSPI driver version. */
-#define FSL_FLEXSPI_DRIVER_VERSION (MAKE_VERSION(2, 6, 3))
+#define FSL_FLEXSPI_DRIVER_VERSION (MAKE_VERSION(2, 7, 0))
 /*! @} */
 
 #define FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNT FSL_FEATURE_FLEXSPI_AHB_BUFFER_COUNTn(0)
@@ -820,6 +820,47 @@ status_t FLEXSPI_ReadBlocking(FLEXSPI_Type *base, uint8_t *buffer, size_t size);
  * @retval kStatus_FLEXSPI_IpCommandGrantTimeout IP command grant timeout detected
  */
 status_t FLEXSPI_TransferBlocking(FLEXSPI_Type *base, flexspi_transfer_t *xfer);
+
+/*!
+ * @brief Prepares IPCR1 register value for FLEXSPI_ReadRegisterFast.
+ *
+ * The value is meant to be computed once before a polling loop.
+ * @param base FLEXSPI peripheral base address
+ * @param seqIndex Sequence ID of the command.
+ * @param seqNumber Number of sequences to execute.
+ * @param dataSize Number of bytes to read, 4 at most.
+ * @return IPCR1 register value.
+ */
+static inline uint32_t FLEXSPI_GetIpCommandConfig(FLEXSPI_Type *base,
+                                                  uint8_t seqIndex,
+                                                  uint8_t seqNumber,
+                                                  size_t dataSize)
+{
+    assert(dataSize <= 4U);
+
+    return (base->IPCR1 & ~(FLEXSPI_IPCR1_IDATSZ_MASK | FLEXSPI_IPCR1_ISEQID_MASK | FLEXSPI_IPCR1_ISEQNUM_MASK)) |
+           FLEXSPI_IPCR1_IDATSZ(dataSize) | FLEXSPI_IPCR1_ISEQID((uint32_t)seqIndex) |
+           FLEXSPI_IPCR1_ISEQNUM((uint32_t)seqNumber - 1U);
+}
+
+/*!
+ * @brief Reads a device register of up to 4 bytes using a lean blocking IP command.
+ *
+ * Intended for tight polling loops, for example waiting for the busy bit of a flash status register. Unlike
+ * FLEXSPI_TransferBlocking, the IPCR1 value is pre-computed, the IP FIFOs are not reset and the bus idle state is not
+ * waited for, which shortens each poll iteration.
+ * @note The IP RX FIFO has to be empty, which is the case after any transfer completed by this driver. The sequence
+ * must not use JMP_ON_CS as the instruction pointer is not cleared.
+ * @param base FLEXSPI peripheral base address
+ * @param deviceAddress Device address the command is issued to.
+ * @param ipcr1 IPCR1 value prepared by FLEXSPI_GetIpCommandConfig.
+ * @param value Pointer to store the data read.
+ * @retval kStatus_Success register read without error
+ * @retval kStatus_FLEXSPI_SequenceExecutionTimeout sequence execution timeout
+ * @retval kStatus_FLEXSPI_IpCommandSequenceError IP command sequence error detected
+ * @retval kStatus_FLEXSPI_IpCommandGrantTimeout IP command grant timeout detected
+ */
+status_t FLEXSPI_ReadRegisterFast(FLEXSPI_Type *base, uint32_t deviceAddress, uint32_t ipcr1, uint32_t *value);
 /*! @} */
 
 /*!
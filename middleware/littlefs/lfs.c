@@ -688,7 +688,7 @@ static int lfs_alloc(lfs_t *lfs, lfs_block_t *block) {
         if (lfs->lookahead.ckpoint <= 0) {
             LFS_ERROR("No more free space 0x%"PRIx32,
                     (lfs->lookahead.start + lfs->lookahead.next)
-                        % lfs->cfg->block_count);
+                        % lfs->block_count);
             return LFS_ERR_NOSPC;
         }
 
@@ -1461,6 +1461,80 @@ static int lfs_dir_find_match(void *data,
     return LFS_CMP_EQ;
 }
 
+#ifdef LFS_DENTRY_CACHE
+// path resolution cache, directory paths -> metadata pairs of directories
+static void lfs_dcache_drop(lfs_t *lfs) {
+    for (lfs_size_t i = 0; i < LFS_DENTRY_CACHE_SIZE; i++) {
+        lfs->dcache.entries[i].len = 0;
+    }
+    lfs->dcache.next = 0;
+}
+
+static bool lfs_dcache_iscacheable(const char *path) {
+    // '.' and '..' are resolved by the walk itself, keep such paths out
+    while (true) {
+        path += strspn(path, "/");
+        lfs_size_t namelen = strcspn(path, "/");
+        if (namelen == 0) {
+            return true;
+        }
+
+        if ((namelen == 1 && memcmp(path, ".", 1) == 0) ||
+            (namelen == 2 && memcmp(path, "..", 2) == 0)) {
+            return false;
+        }
+
+        path += namelen;
+    }
+}
+
+// find the deepest cached directory on the path, returns length of its path
+static lfs_size_t lfs_dcache_find(lfs_t *lfs, const char *path,
+        lfs_block_t pair[2]) {
+    lfs_size_t len = 0;
+    for (lfs_size_t i = 0; i < LFS_DENTRY_CACHE_SIZE; i++) {
+        const struct lfs_dcache_entry *entry = &lfs->dcache.entries[i];
+        // at least one name has to follow, it is what the caller looks for
+        if (entry->len > len
+                && strncmp(path, entry->path, entry->len) == 0
+                && path[entry->len] == '/'
+                && path[entry->len + strspn(&path[entry->len], "/")]
+                    != '\0') {
+            len = entry->len;
+            pair[0] = entry->pair[0];
+            pair[1] = entry->pair[1];
+        }
+    }
+
+    return len;
+}
+
+static void lfs_dcache_insert(lfs_t *lfs, const char *path, lfs_size_t len,
+        const lfs_block_t pair[2]) {
+    if (len == 0 || len > LFS_DENTRY_CACHE_PATH_MAX) {
+        return;
+    }
+
+    // update the entry if the path is cached, otherwise replace the oldest
+    lfs_size_t i = 0;
+    while (i < LFS_DENTRY_CACHE_SIZE
+            && !(lfs->dcache.entries[i].len == len
+                && memcmp(lfs->dcache.entries[i].path, path, len) == 0)) {
+        i += 1;
+    }
+
+    if (i == LFS_DENTRY_CACHE_SIZE) {
+        i = lfs->dcache.next;
+        lfs->dcache.next = (lfs->dcache.next + 1) % LFS_DENTRY_CACHE_SIZE;
+        memcpy(lfs->dcache.entries[i].path, path, len);
+        lfs->dcache.entries[i].len = len;
+    }
+
+    lfs->dcache.entries[i].pair[0] = pair[0];
+    lfs->dcache.entries[i].pair[1] = pair[1];
+}
+#endif
+
 static lfs_stag_t lfs_dir_find(lfs_t *lfs, lfs_mdir_t *dir,
         const char **path, uint16_t *id) {
     // we reduce path to a single name if we can find it
@@ -1474,6 +1548,20 @@ static lfs_stag_t lfs_dir_find(lfs_t *lfs, lfs_mdir_t *dir,
     dir->tail[0] = lfs->root[0];
     dir->tail[1] = lfs->root[1];
 
+#ifdef LFS_DENTRY_CACHE
+    // or start at the deepest cached directory on the path
+    const char *start = name;
+    bool cacheable = lfs_dcache_iscacheable(name);
+    if (cacheable) {
+        lfs->dcache.lookups += 1;
+        lfs_size_t len = lfs_dcache_find(lfs, name, dir->tail);
+        if (len) {
+            lfs->dcache.hits += 1;
+            name += len;
+        }
+    }
+#endif
+
     while (true) {
 nextname:
         // skip slashes
@@ -1532,6 +1620,17 @@ nextname:
                 return res;
             }
             lfs_pair_fromle32(dir->tail);
+
+#ifdef LFS_DENTRY_CACHE
+            // remember the directory, its path ends before the current name
+            if (cacheable) {
+                lfs_size_t len = name - start;
+                while (len > 0 && start[len-1] == '/') {
+                    len -= 1;
+                }
+                lfs_dcache_insert(lfs, start, len, dir->tail);
+            }
+#endif
         }
 
         // find entry matching name
@@ -2443,6 +2542,11 @@ static int lfs_dir_orphaningcommit(lfs_t *lfs, lfs_mdir_t *dir,
                 lpair[0], lpair[1], ldir.pair[0], ldir.pair[1]);
         state = 0;
 
+#ifdef LFS_DENTRY_CACHE
+        // the pair may be cached under its old blocks
+        lfs_dcache_drop(lfs);
+#endif
+
         // update internal root
         if (lfs_pair_cmp(lpair, lfs->root) == 0) {
             lfs->root[0] = ldir.pair[0];
@@ -3850,6 +3954,11 @@ static int lfs_remove_(lfs_t *lfs, const char *path) {
         return err;
     }
 
+#ifdef LFS_DENTRY_CACHE
+    // the removed directory and its subdirectories may be cached
+    lfs_dcache_drop(lfs);
+#endif
+
     lfs_mdir_t cwd;
     lfs_stag_t tag = lfs_dir_find(lfs, &cwd, &path, NULL);
     if (tag < 0 || lfs_tag_id(tag) == 0x3ff) {
@@ -3929,6 +4038,12 @@ static int lfs_rename_(lfs_t *lfs, const char *oldpath, const char *newpath) {
         return err;
     }
 
+#ifdef LFS_DENTRY_CACHE
+    // the moved directory and its subdirectories may be cached under
+    // their old paths, the replaced one under the new path
+    lfs_dcache_drop(lfs);
+#endif
+
     // find old entry
     lfs_mdir_t oldcwd;
     lfs_stag_t oldtag = lfs_dir_find(lfs, &oldcwd, &oldpath, NULL);
@@ -4298,6 +4413,11 @@ static int lfs_init(lfs_t *lfs, const struct lfs_config *cfg) {
 #ifdef LFS_MIGRATE
     lfs->lfs1 = NULL;
 #endif
+#ifdef LFS_DENTRY_CACHE
+    lfs_dcache_drop(lfs);
+    lfs->dcache.lookups = 0;
+    lfs->dcache.hits = 0;
+#endif
 
     return 0;
 
@@ -4606,6 +4726,12 @@ static int lfs_fs_stat_(lfs_t *lfs, struct lfs_fsinfo *fsinfo) {
     fsinfo->file_max = lfs->file_max;
     fsinfo->attr_max = lfs->attr_max;
 
+#ifdef LFS_DENTRY_CACHE
+    // path resolution cache efficiency
+    fsinfo->dcache_lookups = lfs->dcache.lookups;
+    fsinfo->dcache_hits = lfs->dcache.hits;
+#endif
+
     return 0;
 }
 
@@ -4927,6 +5053,11 @@ static int lfs_fs_deorphan(lfs_t *lfs, bool powerloss) {
         return 0;
     }
 
+#ifdef LFS_DENTRY_CACHE
+    // orphaned directories are dropped and half-orphans repaired
+    lfs_dcache_drop(lfs);
+#endif
+
     // Check for orphans in two separate passes:
     // - 1 for half-orphans (relocations)
     // - 2 for full-orphans (removes/renames)
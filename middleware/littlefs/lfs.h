@@ -51,6 +51,19 @@ typedef uint32_t lfs_block_t;
 #define LFS_NAME_MAX 255
 #endif
 
+// Number of directories held by the path resolution cache, enabled by
+// defining LFS_DENTRY_CACHE. Each entry costs LFS_DENTRY_CACHE_PATH_MAX
+// bytes plus 12 bytes of RAM in the lfs_t struct.
+#ifndef LFS_DENTRY_CACHE_SIZE
+#define LFS_DENTRY_CACHE_SIZE 8
+#endif
+
+// Longest directory path held by the path resolution cache in bytes, deeper
+// directories are still resolved by walking from their cached ancestors.
+#ifndef LFS_DENTRY_CACHE_PATH_MAX
+#define LFS_DENTRY_CACHE_PATH_MAX 64
+#endif
+
 // Maximum size of a file in bytes, may be redefined to limit to support other
 // drivers. Limited on disk to <= 2147483647. Stored in superblock and must be
 // respected by other littlefs drivers.
@@ -324,6 +337,13 @@ struct lfs_fsinfo {
 
     // Upper limit on the size of custom attributes in bytes.
     lfs_size_t attr_max;
+
+#ifdef LFS_DENTRY_CACHE
+    // Path resolutions that could use the path resolution cache, and those
+    // that started at a cached directory instead of the root.
+    lfs_size_t dcache_lookups;
+    lfs_size_t dcache_hits;
+#endif
 };
 
 // Custom attribute structure, used to describe custom attributes
@@ -465,6 +485,21 @@ typedef struct lfs {
 #ifdef LFS_MIGRATE
     struct lfs1 *lfs1;
 #endif
+
+#ifdef LFS_DENTRY_CACHE
+    // directory path -> metadata pair of the directory, lets path
+    // resolution skip the walk from the root
+    struct lfs_dcache {
+        struct lfs_dcache_entry {
+            lfs_block_t pair[2];
+            lfs_size_t len;
+            char path[LFS_DENTRY_CACHE_PATH_MAX];
+        } entries[LFS_DENTRY_CACHE_SIZE];
+        lfs_size_t next;
+        lfs_size_t lookups;
+        lfs_size_t hits;
+    } dcache;
+#endif
 } lfs_t;
 
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2021 NXP
+ * Copyright 2018-2021, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -8,17 +8,198 @@
 #include "lfs_mflash.h"
 #include "fsl_debug_console.h"
 #include "peripherals.h"
+#if defined(LFS_MFLASH_DMA) && LFS_MFLASH_DMA
+#include "fsl_gdma.h"
+#endif
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+#include "mflash_partition.h"
+#endif
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+#include "mflash_stage.h"
+#include "board.h"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*
+ * Large reads by GDMA from memory mapped FLASH
+ *
+ * littlefs reads file data spanning multiple read_size units straight to the buffer of the caller, bypassing its
+ * cache, so such a read is a contiguous span of single CTZ block. Spans of at least LFS_MFLASH_DMA_THRESHOLD bytes are
+ * copied by GDMA over AHB, which prefetches and bursts instead of the CPU draining FLEXSPI IP FIFO with interrupts
+ * disabled. Unaligned spans and areas not mapped as whole fall back to the IP command read.
+ */
+#if defined(LFS_MFLASH_DMA) && LFS_MFLASH_DMA
+#ifndef LFS_MFLASH_DMA_THRESHOLD
+#define LFS_MFLASH_DMA_THRESHOLD (512U)
+#endif
+
+#ifndef LFS_MFLASH_DMA_CHANNEL
+#define LFS_MFLASH_DMA_CHANNEL (1U)
+#endif
+
+/* Bytes per GDMA transfer, limited by the transfer length field */
+#define LFS_MFLASH_DMA_CHUNK (4096U)
+#endif
+
+/*
+ * Write-back staging in PSRAM
+ *
+ * Pages programmed and blocks erased by littlefs are queued by mflash_stage, with the page data in PSRAM, and written
+ * to FLASH by the sync that commits them (lfs_file_sync, lfs_file_close), by lfs_mflash_drain_idle or once the queue
+ * is full. File data is programmed by lfs_file_write already, so the queue still absorbs the burst until the sync.
+ * Reads see the queued data. The queue is drained in order, so power loss loses the latest writes only and the
+ * filesystem stays consistent as if power failed earlier.
+ * LFS_MFLASH_STAGING_INIT is called by lfs_storage_init before the driver, which then joins the FLEXSPI set up for the
+ * PSRAM, staging stays disabled if it fails.
+ */
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+#ifndef LFS_MFLASH_STAGING_ADDR
+#define LFS_MFLASH_STAGING_ADDR (0x28000000U) /* PSRAM on the FLEXSPI port B1 through CACHE64 1 */
+#endif
+
+/* Queued pages and sectors, bounds the data lost on power loss and the duration of lfs_mflash_flush */
+#ifndef LFS_MFLASH_STAGING_SLOTS
+#define LFS_MFLASH_STAGING_SLOTS (256U)
+#endif
+
+#ifndef LFS_MFLASH_STAGING_INIT
+#define LFS_MFLASH_STAGING_INIT() BOARD_InitPsRam()
+#endif
+#endif
+
+/*
+ * Inline encryption
+ *
+ * With LFS_MFLASH_ENCRYPTED the driver encrypts the area of the filesystem set up by lfs_storage_init, programs are
+ * encrypted by the FLEXSPI and reads, whether by the driver or by GDMA, are decrypted on the fly. Partitions of the
+ * table are encrypted by their MFLASH_PART_FLAG_ENCRYPTED flag instead. Filesystem written with the other setting is
+ * not readable, it has to be formatted again.
+ */
+#if defined(LFS_MFLASH_ENCRYPTED) && LFS_MFLASH_ENCRYPTED && !(defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS)
+#if !defined(MFLASH_ENCRYPT_AREAS)
+#error "LFS_MFLASH_ENCRYPTED requires mflash driver supporting inline encryption"
+#endif
+
+static const uint8_t s_encrypt_iv[8] = {'l', 'i', 't', 't', 'l', 'e', 'f', 's'};
+#endif
+
+/*
+ * Static buffers
+ *
+ * Buffers of the filesystem and the pool of file caches are sized by the board definitions, the configuration is
+ * checked against these by lfs_get_default_config. Each cache is a multiple of read and program size and divides the
+ * block, the lookahead buffer is a multiple of 8 bytes as littlefs requires.
+ */
+#if defined(LFS_MFLASH_STATIC_BUFFERS) && LFS_MFLASH_STATIC_BUFFERS
+#ifndef LFS_MFLASH_FILE_CACHES
+#define LFS_MFLASH_FILE_CACHES (4U)
+#endif
+
+#if (LFS_MFLASH_FILE_CACHES == 0U) || (LFS_MFLASH_FILE_CACHES > 32U)
+#error "LFS_MFLASH_FILE_CACHES has to be in range of 1 to 32"
+#endif
+
+#if ((LITTLEFS_CACHE_SIZE % LITTLEFS_READ_SIZE) != 0) || ((LITTLEFS_CACHE_SIZE % LITTLEFS_PROG_SIZE) != 0) || \
+    ((LITTLEFS_BLOCK_SIZE % LITTLEFS_CACHE_SIZE) != 0) || ((LITTLEFS_CACHE_SIZE % 4) != 0)
+#error "LITTLEFS_CACHE_SIZE has to be a multiple of LITTLEFS_READ_SIZE and LITTLEFS_PROG_SIZE and divide the block"
+#endif
+
+#if (LITTLEFS_LOOKAHEAD_SIZE == 0) || ((LITTLEFS_LOOKAHEAD_SIZE % 8) != 0)
+#error "LITTLEFS_LOOKAHEAD_SIZE has to be a non-zero multiple of 8"
+#endif
+
+/* File cache of the pool together with the configuration referring to it, both stay in use while the file is open */
+struct lfs_mflash_file_cache
+{
+    struct lfs_file_config cfg;
+    uint32_t buffer[LITTLEFS_CACHE_SIZE / sizeof(uint32_t)];
+};
+#endif
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
-struct lfs_mflash_ctx LittleFS_ctx = {LITTLEFS_START_ADDR};
+#ifndef LITTLEFS_PARTITION_SIZE
+#define LITTLEFS_PARTITION_SIZE 0
+#endif
+
+static const struct lfs_mflash_partition s_partition = {LITTLEFS_START_ADDR, LITTLEFS_PARTITION_SIZE};
+
+struct lfs_mflash_ctx LittleFS_ctx = {LITTLEFS_START_ADDR, &s_partition};
+
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+/* Partition resolved through the partition table, takes precedence over the board definitions */
+static struct lfs_mflash_partition s_table_partition;
+#endif
+
+#if defined(LFS_MFLASH_STATIC_BUFFERS) && LFS_MFLASH_STATIC_BUFFERS
+static uint32_t s_read_buffer[LITTLEFS_CACHE_SIZE / sizeof(uint32_t)];
+static uint32_t s_prog_buffer[LITTLEFS_CACHE_SIZE / sizeof(uint32_t)];
+static uint32_t s_lookahead_buffer[LITTLEFS_LOOKAHEAD_SIZE / sizeof(uint32_t)];
+
+static struct lfs_mflash_file_cache s_file_caches[LFS_MFLASH_FILE_CACHES];
+static uint32_t s_file_caches_used; /* Bitmap of caches held by open files */
+#endif
 
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
+#if defined(LFS_MFLASH_DMA) && LFS_MFLASH_DMA
+static status_t lfs_mflash_dma_read(uint32_t flash_addr, void *buffer, lfs_size_t size)
+{
+    gdma_channel_xfer_config_t xferConfig = {
+        .ahbProt       = kGDMA_ProtPrevilegedMode,
+        .srcBurstSize  = kGDMA_BurstSize16,
+        .destBurstSize = kGDMA_BurstSize16,
+        .srcWidth      = kGDMA_TransferWidth4Byte,
+        .destWidth     = kGDMA_TransferWidth4Byte,
+        .srcAddrInc    = true,
+        .destAddrInc   = true,
+    };
+    uint32_t src = (uint32_t)(uintptr_t)mflash_drv_phys2log(flash_addr, size);
+    uint32_t dst = (uint32_t)(uintptr_t)buffer;
+    uint32_t flags;
+
+    if ((src == 0U) || (((src | dst | size) % 4U) != 0U))
+        return kStatus_InvalidArgument;
+
+    /* Clock may have been gated by other GDMA user meanwhile */
+    GDMA_Init(GDMA);
+
+    while (size > 0U)
+    {
+        uint32_t chunk = (size < LFS_MFLASH_DMA_CHUNK) ? size : LFS_MFLASH_DMA_CHUNK;
+
+        xferConfig.srcAddr     = src;
+        xferConfig.destAddr    = dst;
+        xferConfig.transferLen = (uint16_t)chunk;
+
+        if (GDMA_SetChannelTransferConfig(GDMA, LFS_MFLASH_DMA_CHANNEL, &xferConfig) != kStatus_Success)
+            return kStatus_Fail;
+
+        GDMA_StartChannel(GDMA, LFS_MFLASH_DMA_CHANNEL);
+        while (GDMA_IsChannelBusy(GDMA, LFS_MFLASH_DMA_CHANNEL))
+        {
+        }
+
+        flags = GDMA_GetChannelInterruptFlags(GDMA, LFS_MFLASH_DMA_CHANNEL);
+        if ((flags & ((uint32_t)kGDMA_AddressErrorFlag | (uint32_t)kGDMA_BusErrorFlag)) != 0U)
+            return kStatus_Fail;
+
+        src += chunk;
+        dst += chunk;
+        size -= chunk;
+    }
+
+    return kStatus_Success;
+}
+#endif
+
 int lfs_mflash_read(const struct lfs_config *lfsc, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
 {
     struct lfs_mflash_ctx *ctx;
@@ -30,8 +211,19 @@ int lfs_mflash_read(const struct lfs_config *lfsc, lfs_block_t block, lfs_off_t
 
     flash_addr = ctx->start_addr + block * lfsc->block_size + off;
 
-    if (mflash_drv_read(flash_addr, buffer, size) != kStatus_Success)
-        return LFS_ERR_IO;
+#if defined(LFS_MFLASH_DMA) && LFS_MFLASH_DMA
+    if ((size < LFS_MFLASH_DMA_THRESHOLD) || (lfs_mflash_dma_read(flash_addr, buffer, size) != kStatus_Success))
+#endif
+    {
+        if (mflash_drv_read(flash_addr, buffer, size) != kStatus_Success)
+            return LFS_ERR_IO;
+    }
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    /* Writes not drained yet */
+    if (ctx->staging)
+        mflash_stage_overlay(flash_addr, buffer, size);
+#endif
 
     return LFS_ERR_OK;
 }
@@ -51,12 +243,33 @@ int lfs_mflash_prog(
 
     assert(mflash_drv_is_page_aligned(size));
 
+    /* Metadata may have grown, maintenance is due */
+    if (!ctx->in_gc)
+        ctx->dirty = true;
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    if (ctx->staging)
+    {
+        for (uint32_t page_ofs = 0; (page_ofs < size) && (status == kStatus_Success); page_ofs += MFLASH_PAGE_SIZE)
+            status = mflash_stage_page_program(flash_addr + page_ofs, (const uint32_t *)((uintptr_t)buffer + page_ofs));
+
+        return (status == kStatus_Success) ? LFS_ERR_OK : LFS_ERR_IO;
+    }
+#endif
+
+    /* Invalidate cache lines of all programmed pages at once */
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_begin();
+#endif
     for (uint32_t page_ofs = 0; page_ofs < size; page_ofs += MFLASH_PAGE_SIZE)
     {
         status = mflash_drv_page_program(flash_addr + page_ofs, (void *)((uintptr_t)buffer + page_ofs));
         if (status != kStatus_Success)
             break;
     }
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_end();
+#endif
 
     if (status != kStatus_Success)
         return LFS_ERR_IO;
@@ -76,12 +289,35 @@ int lfs_mflash_erase(const struct lfs_config *lfsc, lfs_block_t block)
 
     flash_addr = ctx->start_addr + block * lfsc->block_size;
 
+    if (ctx->in_gc)
+        ctx->gc.gc_erases++;
+    else
+        ctx->gc.other_erases++;
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    if (ctx->staging)
+    {
+        for (uint32_t sector_ofs = 0; (sector_ofs < lfsc->block_size) && (status == kStatus_Success);
+             sector_ofs += MFLASH_SECTOR_SIZE)
+            status = mflash_stage_sector_erase(flash_addr + sector_ofs);
+
+        return (status == kStatus_Success) ? LFS_ERR_OK : LFS_ERR_IO;
+    }
+#endif
+
+    /* Invalidate cache lines of the whole block at once */
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_begin();
+#endif
     for (uint32_t sector_ofs = 0; sector_ofs < lfsc->block_size; sector_ofs += MFLASH_SECTOR_SIZE)
     {
         status = mflash_drv_sector_erase(flash_addr + sector_ofs);
         if (status != kStatus_Success)
             break;
     }
+#if defined(MFLASH_DRV_CACHE_BATCH) && MFLASH_DRV_CACHE_BATCH
+    mflash_drv_cache_batch_end();
+#endif
 
     if (status != kStatus_Success)
         return LFS_ERR_IO;
@@ -91,21 +327,364 @@ int lfs_mflash_erase(const struct lfs_config *lfsc, lfs_block_t block)
 
 int lfs_mflash_sync(const struct lfs_config *lfsc)
 {
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    struct lfs_mflash_ctx *ctx;
+
+    assert(lfsc);
+    ctx = (struct lfs_mflash_ctx *)lfsc->context;
+    assert(ctx);
+
+    if (ctx->staging)
+    {
+        /* As barrier the writes before it are drained before the ones after it as the queue keeps the order, only
+         * failure of a drained write is reported then */
+        status_t status = ctx->sync_barrier ? mflash_stage_drain(0U) : mflash_stage_flush();
+        if (status != kStatus_Success)
+            return LFS_ERR_IO;
+    }
+#endif
+
+    return LFS_ERR_OK;
+}
+
+int lfs_mflash_flush(lfs_t *lfs)
+{
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    struct lfs_mflash_ctx *ctx;
+
+    assert(lfs);
+    ctx = (struct lfs_mflash_ctx *)lfs->cfg->context;
+    assert(ctx);
+
+    if (ctx->staging && (mflash_stage_flush() != kStatus_Success))
+        return LFS_ERR_IO;
+#endif
+
+    return LFS_ERR_OK;
+}
+
+/* Cycle counter measuring duration of lfs_fs_gc */
+static uint32_t lfs_mflash_cycles(void)
+{
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    return DWT->CYCCNT;
+}
+
+int lfs_mflash_gc_idle(lfs_t *lfs, uint32_t budget_us)
+{
+    struct lfs_mflash_ctx *ctx;
+    uint32_t start;
+    uint32_t us;
+    int res;
+
+    assert(lfs);
+    ctx = (struct lfs_mflash_ctx *)lfs->cfg->context;
+    assert(ctx);
+
+    /* Nothing written since the last run */
+    if (!ctx->dirty)
+        return LFS_ERR_OK;
+
+    if (budget_us < ctx->gc_estimate_us)
+    {
+        ctx->gc_estimate_us /= 2U;
+        ctx->gc.skipped++;
+        return LFS_ERR_OK;
+    }
+
+    ctx->in_gc = true;
+    start      = lfs_mflash_cycles();
+    res        = lfs_fs_gc(lfs);
+    us         = (lfs_mflash_cycles() - start) / (SystemCoreClock / 1000000U);
+    ctx->in_gc = false;
+
+    ctx->gc_estimate_us = us;
+    ctx->gc.runs++;
+    if (us > ctx->gc.max_us)
+        ctx->gc.max_us = us;
+
+    if (res == LFS_ERR_OK)
+        ctx->dirty = false;
+
+    return res;
+}
+
+int lfs_mflash_drain_idle(lfs_t *lfs, uint32_t budget_us)
+{
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    struct lfs_mflash_ctx *ctx;
+    uint32_t start;
+    status_t status = kStatus_Success;
+
+    assert(lfs);
+    ctx = (struct lfs_mflash_ctx *)lfs->cfg->context;
+    assert(ctx);
+
+    if (!ctx->staging)
+        return LFS_ERR_OK;
+
+    /* Operation started is completed, the budget may be exceeded by single sector erase */
+    start = lfs_mflash_cycles();
+    while ((status == kStatus_Success) && (mflash_stage_queued() != 0U) &&
+           ((lfs_mflash_cycles() - start) / (SystemCoreClock / 1000000U) < budget_us))
+        status = mflash_stage_drain(1U);
+
+    if (status != kStatus_Success)
+        return LFS_ERR_IO;
+#endif
+
     return LFS_ERR_OK;
 }
 
 int lfs_get_default_config(struct lfs_config *lfsc)
 {
+    struct lfs_mflash_ctx *ctx;
+    const struct lfs_mflash_partition *partition;
+    uint32_t flash_size;
+    uint32_t size;
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    const mflash_partition_t *table_part;
+#endif
+
     *lfsc = LittleFS_config; /* copy pre-initialized lfs config structure */
+
+    ctx = (struct lfs_mflash_ctx *)lfsc->context;
+    assert(ctx);
+
+    /* The device is detected by initialization of the driver */
+    flash_size = mflash_drv_get_size();
+    if (flash_size == 0U)
+    {
+        (void)mflash_drv_init();
+        flash_size = mflash_drv_get_size();
+    }
+
+#if defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS
+    /* Table loaded by mflash_part_init */
+    table_part = mflash_part_find((uint32_t)kMflashPart_Littlefs);
+    if (table_part == NULL)
+        return LFS_ERR_INVAL;
+
+    s_table_partition.start_addr = table_part->offset;
+    s_table_partition.size       = table_part->size;
+    ctx->partition               = &s_table_partition;
+#endif
+
+    partition = ctx->partition;
+    assert(partition);
+
+    if (lfsc->block_size == 0U)
+        lfsc->block_size = MFLASH_SECTOR_SIZE;
+
+    /* Partition up to the end of the device needs the device size to be known */
+    size = partition->size;
+    if (size == 0U)
+    {
+        if (flash_size <= partition->start_addr)
+            return LFS_ERR_INVAL;
+        size = flash_size - partition->start_addr;
+    }
+
+    if (((lfsc->block_size % MFLASH_SECTOR_SIZE) != 0U) || ((partition->start_addr % lfsc->block_size) != 0U) ||
+        (size < 2U * lfsc->block_size) || (partition->start_addr + size > MFLASH_BSIZE) ||
+        ((flash_size != 0U) && (partition->start_addr + size > flash_size)))
+        return LFS_ERR_INVAL;
+
+    ctx->start_addr   = partition->start_addr;
+    lfsc->block_count = size / lfsc->block_size;
+
+#if defined(LFS_MFLASH_STATIC_BUFFERS) && LFS_MFLASH_STATIC_BUFFERS
+    if ((lfsc->cache_size != LITTLEFS_CACHE_SIZE) || (lfsc->lookahead_size != LITTLEFS_LOOKAHEAD_SIZE))
+        return LFS_ERR_INVAL;
+
+    lfsc->read_buffer      = s_read_buffer;
+    lfsc->prog_buffer      = s_prog_buffer;
+    lfsc->lookahead_buffer = s_lookahead_buffer;
+#endif
+
     return 0;
 }
 
 int lfs_storage_init(const struct lfs_config *lfsc)
 {
+    struct lfs_mflash_ctx *ctx = (struct lfs_mflash_ctx *)lfsc->context;
     status_t status;
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    bool staging_ready;
+#endif
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    /* Writes of previous mount are not dropped */
+    if (ctx->staging)
+        (void)mflash_stage_flush();
+    ctx->staging = false;
+#endif
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    /* Board setup of the PSRAM may initialize the whole FLEXSPI, the driver keeps the PSRAM port configured */
+    staging_ready = (LFS_MFLASH_STAGING_INIT() == kStatus_Success);
+#endif
 
     /* initialize mflash */
     status = mflash_drv_init();
 
+#if defined(LFS_MFLASH_ENCRYPTED) && LFS_MFLASH_ENCRYPTED && !(defined(MFLASH_PARTITIONS) && MFLASH_PARTITIONS)
+    if (status == kStatus_Success)
+        status = mflash_drv_encrypt_area(ctx->start_addr, lfsc->block_count * lfsc->block_size, s_encrypt_iv);
+#endif
+
+#if defined(LFS_MFLASH_STAGING) && LFS_MFLASH_STAGING
+    if ((status == kStatus_Success) && staging_ready)
+        ctx->staging =
+            (mflash_stage_init((void *)LFS_MFLASH_STAGING_ADDR, LFS_MFLASH_STAGING_SLOTS) == kStatus_Success);
+#endif
+
+    /* State of metadata left by previous session is unknown, let the first maintenance run */
+    ctx->dirty = true;
+
     return status;
 }
+
+int lfs_mflash_mount(lfs_t *lfs, struct lfs_config *lfsc)
+{
+    struct lfs_fsinfo fsinfo;
+    lfs_size_t block_count;
+    int res;
+
+    assert(lfsc);
+
+    /* Zero block count makes littlefs take the one stored in the superblock */
+    block_count       = lfsc->block_count;
+    lfsc->block_count = 0;
+    res               = lfs_mount(lfs, lfsc);
+    lfsc->block_count = block_count;
+    if (res)
+        return res;
+
+    res = lfs_fs_stat(lfs, &fsinfo);
+
+    /* Partition shrunk below the filesystem, blocks beyond its end belong to someone else now */
+    if ((res == LFS_ERR_OK) && (fsinfo.block_count > block_count))
+        res = LFS_ERR_INVAL;
+
+#ifndef LFS_READONLY
+    /* Partition grew since the format */
+    if ((res == LFS_ERR_OK) && (fsinfo.block_count < block_count))
+        res = lfs_fs_grow(lfs, block_count);
+#endif
+
+    if (res)
+        (void)lfs_unmount(lfs);
+
+    return res;
+}
+
+#if defined(LFS_MFLASH_STATIC_BUFFERS) && LFS_MFLASH_STATIC_BUFFERS
+/* Takes a free cache of the pool, NULL if all are in use */
+static struct lfs_mflash_file_cache *lfs_mflash_cache_get(lfs_t *lfs)
+{
+    struct lfs_mflash_file_cache *cache = NULL;
+
+#ifdef LFS_THREADSAFE
+    if (lfs->cfg->lock(lfs->cfg))
+        return NULL;
+#endif
+
+    for (uint32_t i = 0U; i < LFS_MFLASH_FILE_CACHES; i++)
+    {
+        if ((s_file_caches_used & (1UL << i)) == 0U)
+        {
+            s_file_caches_used |= 1UL << i;
+            cache = &s_file_caches[i];
+            break;
+        }
+    }
+
+#ifdef LFS_THREADSAFE
+    (void)lfs->cfg->unlock(lfs->cfg);
+#endif
+
+    return cache;
+}
+
+/* Releases the cache holding cfg, files opened with plain lfs_file_open do not hold one and are skipped */
+static void lfs_mflash_cache_put(lfs_t *lfs, const struct lfs_file_config *cfg)
+{
+    uintptr_t offset = (uintptr_t)cfg - (uintptr_t)&s_file_caches[0].cfg;
+    uint32_t i;
+
+    /* Unsigned offset also wraps for pointers below the pool */
+    if ((offset >= sizeof(s_file_caches)) || ((offset % sizeof(s_file_caches[0])) != 0U))
+        return;
+
+    i = (uint32_t)(offset / sizeof(s_file_caches[0]));
+
+#ifdef LFS_THREADSAFE
+    (void)lfs->cfg->lock(lfs->cfg);
+#endif
+
+    s_file_caches_used &= ~(1UL << i);
+
+#ifdef LFS_THREADSAFE
+    (void)lfs->cfg->unlock(lfs->cfg);
+#endif
+}
+#endif
+
+int lfs_mflash_file_opencfg(
+    lfs_t *lfs, lfs_file_t *file, const char *path, int flags, const struct lfs_file_config *cfg)
+{
+#if defined(LFS_MFLASH_STATIC_BUFFERS) && LFS_MFLASH_STATIC_BUFFERS
+    struct lfs_mflash_file_cache *cache;
+    int res;
+
+    assert(cfg);
+
+    cache = lfs_mflash_cache_get(lfs);
+    if (cache == NULL)
+        return LFS_ERR_NOMEM;
+
+    cache->cfg        = *cfg;
+    cache->cfg.buffer = cache->buffer;
+
+    /* The configuration is the first member, close finds the cache by it */
+    res = lfs_file_opencfg(lfs, file, path, flags, &cache->cfg);
+    if (res)
+        lfs_mflash_cache_put(lfs, &cache->cfg);
+
+    return res;
+#else
+    return lfs_file_opencfg(lfs, file, path, flags, cfg);
+#endif
+}
+
+int lfs_mflash_file_open(lfs_t *lfs, lfs_file_t *file, const char *path, int flags)
+{
+    static const struct lfs_file_config defaults = {0};
+
+    return lfs_mflash_file_opencfg(lfs, file, path, flags, &defaults);
+}
+
+int lfs_mflash_file_close(lfs_t *lfs, lfs_file_t *file)
+{
+#if defined(LFS_MFLASH_STATIC_BUFFERS) && LFS_MFLASH_STATIC_BUFFERS
+    const struct lfs_file_config *cfg;
+    int res;
+
+    assert(file);
+    cfg = file->cfg;
+
+    /* The cache is released even if the close fails, littlefs drops the file from its list either way */
+    res = lfs_file_close(lfs, file);
+    lfs_mflash_cache_put(lfs, cfg);
+
+    return res;
+#else
+    return lfs_file_close(lfs, file);
+#endif
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2021 NXP
+ * Copyright 2018-2021, 2026 NXP
  * All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -11,12 +11,95 @@
 #include "lfs.h"
 #include "mflash_drv.h"
 
+/* Statistics of the idle-time maintenance service */
+struct lfs_mflash_gc_stats
+{
+    uint32_t runs;          /* lfs_fs_gc calls made by the service */
+    uint32_t skipped;       /* Calls postponed as the budget did not cover the estimated duration */
+    uint32_t gc_erases;     /* Blocks erased within lfs_fs_gc */
+    uint32_t other_erases;  /* Blocks erased outside lfs_fs_gc, metadata and file data alike */
+    uint32_t max_us;        /* Longest lfs_fs_gc call */
+};
+
+/* Area of FLASH given to the filesystem */
+struct lfs_mflash_partition
+{
+    uint32_t start_addr; /* Offset of the partition in FLASH, multiple of block_size */
+    uint32_t size;       /* Size in bytes, 0 extends the partition up to the end of the detected device */
+};
+
 struct lfs_mflash_ctx
 {
-    uint32_t start_addr;
+    uint32_t start_addr;                          /* Offset of the filesystem, set by lfs_get_default_config */
+    const struct lfs_mflash_partition *partition; /* Partition holding the filesystem */
+    bool dirty;                                   /* Programmed since the last lfs_fs_gc */
+    bool in_gc;                                   /* lfs_fs_gc in progress */
+    bool staging;                                 /* Writes are queued by mflash_stage, set by lfs_storage_init */
+    bool sync_barrier;                            /* Opt-in, littlefs syncs order the queued writes only */
+    uint32_t gc_estimate_us;                      /* Expected duration of the next lfs_fs_gc */
+    struct lfs_mflash_gc_stats gc;                /* Maintenance statistics */
 };
 
+/*
+ * Geometry of the filesystem
+ *
+ * lfs_get_default_config derives block_count and the start address from the partition and the size of the FLASH
+ * device detected by the mflash driver, block_size is the one of the board configuration or MFLASH_SECTOR_SIZE if that
+ * is 0. LFS_ERR_INVAL is returned if the partition does not fit the device.
+ */
 extern int lfs_get_default_config(struct lfs_config *lfsc);
 extern int lfs_storage_init(const struct lfs_config *lfsc);
 
+/*
+ * Mounts the filesystem regardless of the block count it was formatted with, a filesystem smaller than the partition
+ * is grown to the whole partition by lfs_fs_grow. A filesystem larger than the partition is not mounted, LFS_ERR_INVAL
+ * is returned.
+ */
+extern int lfs_mflash_mount(lfs_t *lfs, struct lfs_config *lfsc);
+
+/*
+ * Static buffers
+ *
+ * With LFS_MFLASH_STATIC_BUFFERS defined to 1 by the board, lfs_get_default_config provides the read, program and
+ * lookahead buffers from static memory, so that mount does not allocate them. Files opened by lfs_mflash_file_open
+ * or lfs_mflash_file_opencfg take their cache from a pool of LFS_MFLASH_FILE_CACHES entries and return it in
+ * lfs_mflash_file_close, open and close do not touch the heap. LFS_ERR_NOMEM is returned if all caches are in use.
+ * Building littlefs with LFS_NO_MALLOC makes any remaining allocation, such as of file opened by lfs_file_open, fail.
+ *
+ * Without the option the helpers are plain lfs_file_opencfg and lfs_file_close and littlefs allocates the caches.
+ */
+extern int lfs_mflash_file_open(lfs_t *lfs, lfs_file_t *file, const char *path, int flags);
+
+/* Attributes referred by cfg have to stay valid while the file is open, with static buffers the buffer member of cfg
+ * is replaced by cache of the pool */
+extern int lfs_mflash_file_opencfg(
+    lfs_t *lfs, lfs_file_t *file, const char *path, int flags, const struct lfs_file_config *cfg);
+
+extern int lfs_mflash_file_close(lfs_t *lfs, lfs_file_t *file);
+
+/*
+ * Idle-time maintenance, to be called by the application when it has nothing else to do
+ *
+ * Runs lfs_fs_gc if anything was written since the last run, so that metadata pairs filled above compact_thresh are
+ * compacted and the lookahead buffer is populated in advance instead of inline in the next write. lfs_fs_gc can not
+ * be interrupted, it is started only if budget_us covers the duration of the previous run, the estimate halves with
+ * each postponed call so that a single long run does not block the service.
+ */
+extern int lfs_mflash_gc_idle(lfs_t *lfs, uint32_t budget_us);
+
+/*
+ * Write-back staging
+ *
+ * With LFS_MFLASH_STAGING defined to 1 and the staging memory initialized by lfs_storage_init, programs and erases
+ * return once queued in PSRAM. littlefs syncs (lfs_file_sync, lfs_file_close) write the queue to FLASH, these remain
+ * the durability points. With sync_barrier of the context set, syncs are barriers that only keep the order of the
+ * writes and do not wait for the FLASH, committed data may then be lost on power loss until it is drained.
+ * lfs_mflash_drain_idle writes queued pages to FLASH until budget_us elapses, to be called from idle time.
+ * lfs_mflash_flush writes all of them, to be called at points where the data has to survive power loss. Without
+ * staging both return immediately.
+ */
+extern int lfs_mflash_drain_idle(lfs_t *lfs, uint32_t budget_us);
+
+extern int lfs_mflash_flush(lfs_t *lfs);
+
 #endif
@@ -0,0 +1,322 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "lfs_nand.h"
+#include "fsl_debug_console.h"
+#include "peripherals.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/* States of NAND block in block_link during lfs_storage_init, other values link grown bad block to its replacement */
+#define LFS_NAND_LINK_GOOD (0xFFFFU) /* Good block not in use by littlefs yet */
+#define LFS_NAND_LINK_USED (0xFFFEU) /* Good block holding littlefs block */
+#define LFS_NAND_LINK_BAD  (0xFFFDU) /* Grown bad block without replacement */
+#define LFS_NAND_LINK_NONE (0xFFFCU) /* Factory bad block, not mapped */
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static uint16_t s_block_map[LITTLEFS_NAND_BLOCKS];
+static uint16_t s_block_link[LITTLEFS_NAND_BLOCKS];
+static uint32_t s_retire[(LITTLEFS_NAND_BLOCKS + 31U) / 32U];
+static uint32_t s_page_buf[LFS_NAND_PAGE_BUF_SIZE / sizeof(uint32_t)];
+
+struct lfs_nand_ctx LittleFS_ctx = {&LittleFS_nand_config, LITTLEFS_START_BLOCK, LITTLEFS_NAND_BLOCKS,
+                                    s_block_map,           s_block_link,         s_retire,
+                                    s_page_buf};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static bool lfs_nand_is_retired(struct lfs_nand_ctx *ctx, lfs_block_t block)
+{
+    return (ctx->retire[block / 32U] & (1UL << (block % 32U))) != 0U;
+}
+
+static uint32_t lfs_nand_first_page(struct lfs_nand_ctx *ctx, lfs_block_t block)
+{
+    return ctx->block_map[block] * ctx->handle.pagesInBlock;
+}
+
+/* Marks NAND block gone bad, to be called right after its erase so that the first page is programmed just once. The
+ * marker is written on best effort basis, replacement LFS_NAND_LINK_BAD marks block without replacement. */
+static void lfs_nand_mark_bad(struct lfs_nand_ctx *ctx, uint16_t nand_block, uint16_t replacement)
+{
+    uint32_t page_size = ctx->handle.bytesInPageDataArea;
+    uint8_t *page_buf  = (uint8_t *)ctx->page_buf;
+    uint8_t *spare     = page_buf + page_size;
+
+    ctx->grown_bad_count++;
+
+    memset(page_buf, 0xFF, page_size + ctx->handle.bytesInPageSpareArea);
+    spare[LFS_NAND_GROWN_BAD_OFFSET] = 0x00U;
+    if (replacement != LFS_NAND_LINK_BAD)
+    {
+        spare[LFS_NAND_REMAP_OFFSET]      = (uint8_t)replacement;
+        spare[LFS_NAND_REMAP_OFFSET + 1U] = (uint8_t)(replacement >> 8U);
+        spare[LFS_NAND_REMAP_OFFSET + 2U] = (uint8_t)~replacement;
+        spare[LFS_NAND_REMAP_OFFSET + 3U] = (uint8_t)(~replacement >> 8U);
+    }
+
+    (void)Nand_Flash_Page_Program(&ctx->handle, nand_block * ctx->handle.pagesInBlock, page_buf,
+                                  page_size + ctx->handle.bytesInPageSpareArea);
+}
+
+/* Replaces NAND block of littlefs block which has just been erased, or failed to, by erased spare of the pool. Spares
+ * failing erase are marked as bad and skipped. Returns false if the pool is exhausted. */
+static bool lfs_nand_replace(struct lfs_nand_ctx *ctx, lfs_block_t block)
+{
+    while (ctx->spare_blocks > 0U)
+    {
+        uint16_t spare = ctx->block_map[ctx->block_count + --ctx->spare_blocks];
+
+        if (Nand_Flash_Erase_Block(&ctx->handle, spare) == kStatus_Success)
+        {
+            lfs_nand_mark_bad(ctx, ctx->block_map[block], spare);
+            ctx->block_map[block] = spare;
+            return true;
+        }
+
+        lfs_nand_mark_bad(ctx, spare, LFS_NAND_LINK_BAD);
+    }
+
+    return false;
+}
+
+/* Maps status of NAND operation to littlefs error, failure reported by the device means corrupted block */
+static int lfs_nand_error(status_t status)
+{
+    if (status == kStatus_Success)
+        return LFS_ERR_OK;
+
+    if (status == kStatus_Fail)
+        return LFS_ERR_CORRUPT;
+
+    return LFS_ERR_IO;
+}
+
+int lfs_nand_read(const struct lfs_config *lfsc, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
+{
+    status_t status = kStatus_Success;
+    struct lfs_nand_ctx *ctx;
+    uint32_t page_size;
+    uint32_t page;
+    uint32_t corrected;
+    uint8_t *dst = buffer;
+
+    assert(lfsc);
+    ctx = (struct lfs_nand_ctx *)lfsc->context;
+    assert(ctx);
+
+    page_size = ctx->handle.bytesInPageDataArea;
+    page      = lfs_nand_first_page(ctx, block) + off / page_size;
+    off       = off % page_size;
+    corrected = ctx->handle.eccCorrectedPages;
+
+    while ((size > 0U) && (status == kStatus_Success))
+    {
+        if ((off != 0U) || (size < page_size))
+        {
+            /* Part of page, read to page buffer from the start of the page so that the plane is selected properly */
+            uint32_t chunk = ((page_size - off) < size) ? (page_size - off) : size;
+
+            status = Nand_Flash_Read_Page(&ctx->handle, page, (uint8_t *)ctx->page_buf, off + chunk);
+            memcpy(dst, (uint8_t *)ctx->page_buf + off, chunk);
+            off = 0U;
+            page++;
+            dst += chunk;
+            size -= chunk;
+        }
+        else
+        {
+            /* Whole pages, sequential cache read */
+            uint32_t count = size / page_size;
+
+            status = Nand_Flash_Read_Pages(&ctx->handle, page, count, dst, NULL);
+            page += count;
+            dst += count * page_size;
+            size -= count * page_size;
+        }
+    }
+
+    if (ctx->handle.eccCorrectedPages != corrected)
+    {
+        ctx->ecc_corrected += ctx->handle.eccCorrectedPages - corrected;
+        ctx->ecc_corrected_block = block;
+    }
+
+    return lfs_nand_error(status);
+}
+
+int lfs_nand_prog(const struct lfs_config *lfsc, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size)
+{
+    status_t status;
+    struct lfs_nand_ctx *ctx;
+    uint32_t page_size;
+
+    assert(lfsc);
+    ctx = (struct lfs_nand_ctx *)lfsc->context;
+    assert(ctx);
+
+    page_size = ctx->handle.bytesInPageDataArea;
+
+    assert(((off % page_size) == 0U) && ((size % page_size) == 0U));
+
+    /* Not programmed until the next erase replaces it */
+    if (lfs_nand_is_retired(ctx, block))
+        return LFS_ERR_CORRUPT;
+
+    status = Nand_Flash_Program_Pages(&ctx->handle, lfs_nand_first_page(ctx, block) + off / page_size,
+                                      size / page_size, buffer, NULL);
+
+    /* littlefs relocates the data reading the pages programmed before, the block is replaced once it is erased */
+    if (status == kStatus_Fail)
+        ctx->retire[block / 32U] |= 1UL << (block % 32U);
+
+    return lfs_nand_error(status);
+}
+
+int lfs_nand_erase(const struct lfs_config *lfsc, lfs_block_t block)
+{
+    status_t status;
+    struct lfs_nand_ctx *ctx;
+
+    assert(lfsc);
+    ctx = (struct lfs_nand_ctx *)lfsc->context;
+    assert(ctx);
+
+    status = Nand_Flash_Erase_Block(&ctx->handle, ctx->block_map[block]);
+
+    /* Without spares the block stays in use, failed erase is reported to littlefs */
+    if ((status == kStatus_Fail) || lfs_nand_is_retired(ctx, block))
+    {
+        ctx->retire[block / 32U] &= ~(1UL << (block % 32U));
+        if (lfs_nand_replace(ctx, block))
+            status = kStatus_Success;
+    }
+
+    return lfs_nand_error(status);
+}
+
+int lfs_nand_sync(const struct lfs_config *lfsc)
+{
+    return LFS_ERR_OK;
+}
+
+int lfs_get_default_config(struct lfs_config *lfsc)
+{
+    *lfsc = LittleFS_config; /* copy pre-initialized lfs config structure */
+    return 0;
+}
+
+int lfs_storage_init(const struct lfs_config *lfsc)
+{
+    status_t status;
+    struct lfs_nand_ctx *ctx;
+    nand_handle_t *handle;
+    uint8_t *spare;
+
+    assert(lfsc);
+    ctx = (struct lfs_nand_ctx *)lfsc->context;
+    assert(ctx);
+    handle = &ctx->handle;
+
+    /* initialize NAND FLASH */
+    status = Nand_Flash_Init(ctx->config, handle);
+    if (status != kStatus_Success)
+        return status;
+
+    if ((lfsc->block_size != handle->pagesInBlock * handle->bytesInPageDataArea) ||
+        ((lfsc->prog_size % handle->bytesInPageDataArea) != 0U) ||
+        ((handle->bytesInPageDataArea + handle->bytesInPageSpareArea) > LFS_NAND_PAGE_BUF_SIZE) ||
+        ((ctx->start_block + ctx->nand_blocks) > 65536U))
+        return kStatus_InvalidArgument;
+
+    if ((lfsc->block_count > ctx->nand_blocks) || (ctx->nand_blocks > LFS_NAND_LINK_NONE))
+        return kStatus_InvalidArgument;
+
+    /* Read state of each block of the area, data and spare area of the first page as whole, partial read from the
+     * spare area does not select plane of odd blocks. */
+    spare                = (uint8_t *)ctx->page_buf + handle->bytesInPageDataArea;
+    ctx->block_count     = lfsc->block_count;
+    ctx->good_blocks     = 0U;
+    ctx->spare_blocks    = 0U;
+    ctx->grown_bad_count = 0U;
+    memset(ctx->retire, 0, (ctx->nand_blocks + 31U) / 32U * sizeof(uint32_t));
+
+    for (uint32_t i = 0U; i < ctx->nand_blocks; i++)
+    {
+        uint32_t nand_block = ctx->start_block + i;
+        uint16_t replacement;
+
+        /* ECC failure is expected for bad blocks, the marker decides */
+        status = Nand_Flash_Read_Page(handle, nand_block * handle->pagesInBlock, (uint8_t *)ctx->page_buf,
+                                      handle->bytesInPageDataArea + handle->bytesInPageSpareArea);
+        if ((status != kStatus_Success) && (status != kStatus_Fail))
+            return status;
+
+        ctx->block_link[i] = LFS_NAND_LINK_GOOD;
+
+        if (spare[LFS_NAND_BBM_OFFSET] != 0xFFU)
+        {
+            ctx->block_link[i] = LFS_NAND_LINK_NONE;
+            continue;
+        }
+
+        ctx->good_blocks++;
+
+        if (spare[LFS_NAND_GROWN_BAD_OFFSET] != 0xFFU)
+        {
+            ctx->grown_bad_count++;
+            ctx->block_link[i] = LFS_NAND_LINK_BAD;
+
+            /* Link to the replacement, unless it is damaged or out of the area */
+            replacement = (uint16_t)(spare[LFS_NAND_REMAP_OFFSET] | (spare[LFS_NAND_REMAP_OFFSET + 1U] << 8U));
+            if (((replacement ^ (spare[LFS_NAND_REMAP_OFFSET + 2U] | (spare[LFS_NAND_REMAP_OFFSET + 3U] << 8U))) ==
+                 0xFFFFU) &&
+                (replacement >= ctx->start_block) && (replacement < ctx->start_block + ctx->nand_blocks))
+                ctx->block_link[i] = (uint16_t)(replacement - ctx->start_block);
+        }
+    }
+
+    ctx->ecc_corrected = 0U;
+
+    /* Not enough good blocks in the area */
+    if (ctx->good_blocks < lfsc->block_count)
+        return kStatus_Fail;
+
+    /* The first block_count good blocks hold the littlefs blocks, those gone bad are followed to their replacements.
+     * Chain ending by block without replacement leaves the littlefs block on the bad one. */
+    for (uint32_t i = 0U, block = 0U; block < lfsc->block_count; i++)
+    {
+        uint32_t link = i;
+
+        if (ctx->block_link[i] == LFS_NAND_LINK_NONE)
+            continue;
+
+        for (uint32_t hops = 0U; (ctx->block_link[link] < LFS_NAND_LINK_NONE) && (hops < ctx->nand_blocks); hops++)
+            link = ctx->block_link[link];
+
+        if (ctx->block_link[link] == LFS_NAND_LINK_GOOD)
+            ctx->block_link[link] = LFS_NAND_LINK_USED;
+
+        ctx->block_map[block++] = (uint16_t)(ctx->start_block + link);
+    }
+
+    /* Good blocks not in use are the spares */
+    for (uint32_t i = 0U; i < ctx->nand_blocks; i++)
+    {
+        if (ctx->block_link[i] == LFS_NAND_LINK_GOOD)
+            ctx->block_map[ctx->block_count + ctx->spare_blocks++] = (uint16_t)(ctx->start_block + i);
+    }
+
+    return kStatus_Success;
+}
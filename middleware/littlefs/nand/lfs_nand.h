@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _LFS_NAND_H_
+#define _LFS_NAND_H_
+
+#include "lfs.h"
+#include "fsl_nand_flash.h"
+
+/*
+ * littlefs port to SPI-NAND
+ *
+ * Each littlefs block is one NAND erase block, block_size has to be pagesInBlock * bytesInPageDataArea and prog_size
+ * a multiple of the page size. littlefs collects programmed data in its cache so that every page is programmed just
+ * once, as whole, directly from the cache, there is no read-modify-write. Programs of multiple pages are streamed
+ * using cache program of the device.
+ *
+ * Factory bad blocks are skipped when mapping littlefs blocks to NAND blocks, the first block_count good blocks of the
+ * area hold the littlefs blocks in order, the remaining good blocks form the pool of spares. Blocks failing erase are
+ * replaced by a spare right away, blocks failing program are reported to littlefs as corrupted and replaced at their
+ * next erase, so that littlefs can still read the pages it relocates. The replaced block is erased and its first page
+ * programmed once with the grown bad marker and the NAND block of the replacement, lfs_storage_init follows these
+ * links to rebuild the map. If the pool is exhausted, the failing block stays in use and keeps reporting errors.
+ *
+ * Page reads with bit errors corrected by ECC are counted in the context, uncorrectable errors are reported to littlefs
+ * as corruption.
+ *
+ * The board peripherals provide LITTLEFS_START_BLOCK and LITTLEFS_NAND_BLOCKS defining the area and
+ * LittleFS_nand_config holding the NAND FLASH controller configuration. The area has to hold block_count blocks, the
+ * factory bad blocks and the spares.
+ */
+#define LFS_NAND_PORT (1)
+
+/* Size of page buffer, has to hold data and spare area of one page */
+#ifndef LFS_NAND_PAGE_BUF_SIZE
+#define LFS_NAND_PAGE_BUF_SIZE (4096U + 256U)
+#endif
+
+/* Factory bad block marker, byte of spare area of the first page of the block, anything but 0xFF is bad */
+#ifndef LFS_NAND_BBM_OFFSET
+#define LFS_NAND_BBM_OFFSET (0U)
+#endif
+
+/* Marker of blocks gone bad during use, kept apart from the factory one as factory bad blocks are not mapped */
+#ifndef LFS_NAND_GROWN_BAD_OFFSET
+#define LFS_NAND_GROWN_BAD_OFFSET (1U)
+#endif
+
+/* NAND block replacing the grown bad block followed by its complement, 16 bit little endian values */
+#ifndef LFS_NAND_REMAP_OFFSET
+#define LFS_NAND_REMAP_OFFSET (2U)
+#endif
+
+struct lfs_nand_ctx
+{
+    nand_config_t *config;           /* NAND FLASH controller configuration */
+    uint32_t start_block;            /* First NAND block of the filesystem area */
+    uint32_t nand_blocks;            /* NAND blocks of the area including bad ones */
+    uint16_t *block_map;             /* NAND block of each littlefs block followed by the spares, nand_blocks entries */
+    uint16_t *block_link;            /* Scratch of lfs_storage_init, nand_blocks entries */
+    uint32_t *retire;                /* Bitmap of littlefs blocks to be replaced at the next erase */
+    uint32_t *page_buf;              /* LFS_NAND_PAGE_BUF_SIZE bytes */
+    nand_handle_t handle;            /* NAND FLASH handle */
+    lfs_size_t block_count;          /* littlefs blocks, the spares follow these in block_map */
+    lfs_size_t good_blocks;          /* NAND blocks of the area without factory bad ones */
+    lfs_size_t spare_blocks;         /* Spares left in the pool */
+    uint32_t grown_bad_count;        /* Blocks gone bad during use, including earlier sessions */
+    uint32_t ecc_corrected;          /* Page reads with bit errors corrected by ECC */
+    lfs_block_t ecc_corrected_block; /* littlefs block of the last page read with corrected bit errors */
+};
+
+extern int lfs_get_default_config(struct lfs_config *lfsc);
+extern int lfs_storage_init(const struct lfs_config *lfsc);
+
+#endif